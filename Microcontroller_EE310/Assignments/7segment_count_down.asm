@@ -1,5 +1,6 @@
 #include "./AssemblyConfig.inc"  ; Include additional configuration settings
 #include <xc.inc>               ; Include XC compiler header file
+#include "./clock.inc"          ; FOSC_HZ and CLOCK_INIT
 
 PROCESSOR 18F46K42              ; Define the target microcontroller
 
@@ -7,6 +8,7 @@ PROCESSOR 18F46K42              ; Define the target microcontroller
 ; Program Constants
 ;---------------------	
     REG10   equ     10h             ; Define REG10 as a register at address 0x10 to store the digit
+    TMR0_WAITS equ  20h             ; Wait counts for tmr0_delay.inc (20h-21h)
 
 ;---------------------
 ; Main Program
@@ -18,6 +20,7 @@ PROCESSOR 18F46K42              ; Define the target microcontroller
     ORG          0020H         ; Set next program instruction location
 
 _initialization: 
+    CLOCK_INIT                 ; HFINTOSC 4 MHz
     RCALL _setupPortD          ; Call subroutine to configure PORTD
 
 _main:
@@ -64,45 +67,13 @@ _getDigitPattern:
 
     ORG 0x100                 ; Define start of lookup table in program memory
 digitTable:
-    DB  0b11011110  ; 0
-    DB  0b00000110  ; 1
-    DB  0b11101100  ; 2
-    DB  0b01101110  ; 3
-    DB  0b00110110  ; 4
-    DB  0b01111010  ; 5
-    DB  0b11111010  ; 6
-    DB  0b00001110  ; 7
-    DB  0b11111110  ; 8
-    DB  0b00111110  ; 9
-    DB  0b10111110  ; A
-    DB  0b11110010  ; B
-    DB  0b11011000  ; C
-    DB  0b11100110  ; D
-    DB  0b11111000  ; E
-    DB  0b10111000  ; F
+    ; 0-F, *, #, -, blank (shared table generated by gen_seg_glyphs.py)
+#include "./seg_glyphs.inc"
 
 ;---------------------
 ; 2-Second Delay Subroutine
 ;---------------------
-_delay2Seconds:
-    MOVLW    255           ; Outer loop count (tune as needed)
-    MOVWF    20h          ; Store in a temp register
-
-_delayOuter:
-    MOVLW    200          ; Inner loop count
-    MOVWF    21h          ; Store in another temp register
-
-_delayInner:
-    NOP                   ; No operation (adjust timing)
-    NOP
-    NOP
-    DECFSZ   21h, F       ; Decrease inner loop counter
-    BRA      _delayInner  ; Repeat inner loop
-
-    DECFSZ   20h, F       ; Decrease outer loop counter
-    BRA      _delayOuter  ; Repeat outer loop
-
-    RETURN
+#include "./tmr0_delay.inc"
 
 ;---------------------
 ; Port D Setup
@@ -84,17 +84,8 @@ _getDigitPattern:
 
     ORG 0x100                 ; Define start of lookup table in program memory
 digitTable:
-    ; Binary values representing 7-segment patterns for digits 0-9
-    DB  0b11011110  ; 0
-    DB  0b00000110  ; 1
-    DB  0b11101100  ; 2
-    DB  0b01101110  ; 3
-    DB  0b00110110  ; 4
-    DB  0b01111010  ; 5
-    DB  0b11111010  ; 6
-    DB  0b00001110  ; 7
-    DB  0b11111110  ; 8
-    DB  0b00111110  ; 9
+    ; 0-F, *, #, -, blank (shared table generated by gen_seg_glyphs.py)
+#include "./seg_glyphs.inc"
 
 ; This lookup table defines the binary bit patterns for a 7-segment display.
 ; Each entry corresponds to a specific digit (0-9). When retrieved using table
@@ -1,6 +1,6 @@
 // === CONFIG BITS ===
-#pragma config FEXTOSC = LP     
-#pragma config RSTOSC = EXTOSC  
+#pragma config FEXTOSC = OFF    
+#pragma config RSTOSC = HFINTOSC_1MHZ
 #pragma config CLKOUTEN = OFF   
 #pragma config PR1WAY = ON      
 #pragma config CSWEN = ON       
@@ -33,43 +33,26 @@
 #pragma config CP = OFF         
 
 #include <xc.h>
-#include <stdio.h>
 #include <string.h>
+#include "adc_filter.h"
+#include "lcd.h"
+#include "fmt_mv.h"
+#include "power.h"
+#include "clock.h"
 
-#define _XTAL_FREQ 4000000
-#define Vref 3.3
-
-// LCD Connections
-#define RS LATD0
-#define EN LATD1
-#define ldata LATB
-#define LCD_Port TRISB
-#define LCD_Control TRISD
+#define VREF_MV 3300 // Reference voltage in millivolts
 
 // Function Prototypes
-void LCD_Init();
-void LCD_Command(char);
-void LCD_Char(char);
-void LCD_String(const char *);
-void LCD_String_xy(char, char, const char *);
-void LCD_Clear();
-void MSdelay(unsigned int);
 void ADC_Init(void);
 
 // Global Variables
 uint16_t digital = 0;
-float voltage = 0.0;
+uint16_t millivolts = 0;
 char data[17];
 
 void main(void)
 {
-    // Set Ports First
-    LCD_Port = 0x00;
-    LCD_Control = 0x00;
-    TRISB = 0x00;
-    TRISDbits.TRISD0 = 0;
-    TRISDbits.TRISD1 = 0;
-
+    clock_init();   // HFINTOSC 4 MHz
     __delay_ms(50); // Startup stabilization after unplug/replug
 
     LCD_Init();
@@ -79,25 +62,29 @@ void main(void)
     // Show your name first
     LCD_String_xy(1, 0, "EDUARDO");
     LCD_String_xy(2, 0, "WILLIAMS");
-    __delay_ms(3000); // Show for 3 seconds
+    LCD_Wait_Idle();
+    power_sleep_ms(3000); // Show for 3 seconds, asleep
 
     LCD_Clear(); // Now clear and start voltage display
 
     while (1)
     {
-        ADCON0bits.GO = 1;              // Start ADC conversion
-        while (ADCON0bits.GO);           // Wait until done
-
-        digital = ((uint16_t)ADRESH << 8) | ADRESL; // Get 10-bit result
-        voltage = ((float)digital * Vref) / 4096.0f; // Calculate voltage
-
-        sprintf(data, "V = %.2f V", voltage);
-
-        LCD_String_xy(1, 0, "Voltage Reading:");
-        LCD_String_xy(2, 0, "                "); // Clear line first
-        LCD_String_xy(2, 0, data);
-
-        __delay_ms(500); // Update every 0.5 sec
+        digital = adc_filtered_read(0); // 16-sample hardware average of AN0
+        millivolts = adc_to_mv(digital, VREF_MV); // Calculate voltage
+
+        strcpy(data, "V = ");
+        strcpy(fmt_mv(data + 4, millivolts), " V");
+
+        // Redraw the frame; lcd_flush() only sends what changed
+        lcd_frame_clear();
+        lcd_puts_at(1, 0, "Voltage Reading:");
+        lcd_puts_at(2, 0, data);
+        lcd_flush();
+
+        // Sleep until the next update (0.5 sec); the LCD finishes first
+        // since its TMR4 stops along with the clock
+        LCD_Wait_Idle();
+        power_sleep_ms(500);
     }
 }
 
@@ -117,64 +104,6 @@ void ADC_Init(void)
 
     ADRESH = 0x00;              // Clear results
     ADRESL = 0x00;
-}
-
-// === LCD Functions ===
-void LCD_Init()
-{
-    MSdelay(20); // Wait for LCD to power up properly
-
-    LCD_Command(0x38);    // Function set: 8-bit, 2 lines, 5x8 dots
-    MSdelay(5);
-
-    LCD_Command(0x0C);    // Display ON, Cursor OFF
-    MSdelay(5);
-
-    LCD_Command(0x06);    // Entry mode: Increment cursor
-    MSdelay(5);
-
-    LCD_Command(0x01);    // Clear display
-    MSdelay(5);
-}
-
-void LCD_Command(char cmd)
-{
-    ldata = cmd;
-    RS = 0;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(2);
-}
-
-void LCD_Char(char dat)
-{
-    ldata = dat;
-    RS = 1;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(1);
-}
-
-void LCD_String(const char *msg)
-{
-    while (*msg)
-        LCD_Char(*msg++);
-}
 
-void LCD_String_xy(char row, char pos, const char *msg)
-{
-    char loc = (row == 1) ? (0x80 | (pos & 0x0F)) : (0xC0 | (pos & 0x0F));
-    LCD_Command(loc);
-    LCD_String(msg);
-}
-
-void LCD_Clear()
-{
-    LCD_Command(0x01);
-    MSdelay(2);
-}
-
-// === Blocking Delay ===
-void MSdelay(unsigned int val)
-{
-    for (unsigned int i = 0; i < val; i++)
-        for (unsigned int j = 0; j < 165; j++);
+    adc_filter_init(4);         // Average 16 samples per reading
 }
@@ -38,6 +38,7 @@
 
 #include "./AssemblyConfig.inc"
 #include <xc.inc>
+#include "./clock.inc"
 
 PROCESSOR 18F46K42
 
@@ -46,8 +47,7 @@ PROCESSOR 18F46K42
 ;---------------------
 REG10       EQU 0x10      ; Holds current count value (0–15)
 what_button EQU 0x11      ; Stores the detected keypad value
-DELAY_OUTER EQU 0x20      ; Outer loop counter for delay
-DELAY_INNER EQU 0x21      ; Inner loop counter for delay
+TMR0_WAITS  EQU 0x20      ; Wait counts for tmr0_delay.inc (0x20-0x21)
 
 ;---------------------
 ; Program Start
@@ -63,6 +63,7 @@ ORG 0x0020                ; Start of program code
 ; Setup Routine
 ;---------------------
 _setup:
+    CLOCK_INIT            ; HFINTOSC 4 MHz
     CLRF REG10            ; Clear counter to 0
     RCALL _setupPortD     ; Initialize PORTD for 7-segment output
     RCALL _setupPortB     ; Initialize PORTB for keypad I/O
@@ -203,22 +204,8 @@ _getDigitPattern:
 ;---------------------
 ORG 0x300                 ; Place table at program memory address 0x300
 digitTable:
-    DB  0b11011110 ; 0 => Segments a b c d e f (g off)
-    DB  0b00000110 ; 1 => Segments c f
-    DB  0b11101100 ; 2 => Segments a b d e g
-    DB  0b01101110 ; 3 => Segments a c d e g
-    DB  0b00110110 ; 4 => Segments b c f g
-    DB  0b01111010 ; 5 => Segments a c d f g
-    DB  0b11111010 ; 6 => Segments a c d e f g
-    DB  0b00001110 ; 7 => Segments a c f
-    DB  0b11111110 ; 8 => All segments on (except DP)
-    DB  0b00111110 ; 9 => Segments a b c d f g
-    DB  0b10111110 ; A => Segments a b c e f g
-    DB  0b11110010 ; B => Segments c d e f g
-    DB  0b11011000 ; C => Segments a d e f
-    DB  0b11100110 ; D => Segments b c d e g
-    DB  0b11111000 ; E => Segments a d e f g
-    DB  0b10111000 ; F => Segments a e f g
+    ; 0-F, *, #, -, blank (shared table generated by gen_seg_glyphs.py)
+#include "./seg_glyphs.inc"
 
 ;---------------------
 ; Setup PORTD for 7-segment output
@@ -297,22 +284,9 @@ _check_keypad:
 
 
 ;---------------------
-; Delay for ~2 seconds
+; Delay for 2 seconds (TMR0)
 ;---------------------
-_delay2Seconds:
-    MOVLW  200
-    MOVWF DELAY_OUTER
-outer_loop:
-    MOVLW 255
-    MOVWF DELAY_INNER
-inner_loop:
-    NOP
-    NOP
-    DECFSZ DELAY_INNER, F
-    GOTO inner_loop
-    DECFSZ DELAY_OUTER, F
-    GOTO outer_loop
-    RETURN
+#include "./tmr0_delay.inc"
 
 
 
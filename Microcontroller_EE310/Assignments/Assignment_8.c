@@ -20,7 +20,7 @@
 //Buzzer	RD7
 
 //; Date:  4/13/2025
-//; File Dependencies / Libraries: None 
+//; File Dependencies / Libraries: clock.c, lcd.c, keypad.c, estop.c, melody.c, tone.c, timing.c, systick.c, power.c 
 //; Compiler: xc8, 3.0
 //; Author: Eduardo Williams 
 //; Versions:
@@ -31,8 +31,8 @@
 //;       GITHUB: https://github.com/EduardoWilliams91/EE-310-Microprocessors-and-System-Design/tree/main/Microcontroller_EE310
 
 // === CONFIG BITS ===
-#pragma config FEXTOSC = LP
-#pragma config RSTOSC = EXTOSC
+#pragma config FEXTOSC = OFF
+#pragma config RSTOSC = HFINTOSC_1MHZ
 #pragma config CLKOUTEN = OFF, PR1WAY = ON, CSWEN = ON, FCMEN = ON
 #pragma config MCLRE = EXTMCLR, PWRTS = PWRT_OFF, MVECEN = ON
 #pragma config IVT1WAY = ON, LPBOREN = OFF, BOREN = SBORDIS
@@ -48,27 +48,28 @@
 #include <stdio.h>
 #include <string.h>
 #include "C:\Program Files\Microchip\xc8\v3.00\pic\include\proc\pic18f47k42.h"
+#include "lcd.h"
+#include "keypad.h"
+#include "melody.h"
+#include "estop.h"
+#include "tone.h"
+#include "timing.h"
+#include "systick.h"
+#include "power.h"
+#include "clock.h"
 
-#define _XTAL_FREQ 4000000
+#define EMERGENCY_MS 10000      // buzzer time after an emergency stop
+#define GRANTED_MS   5000       // relay time after the right password
+#define MESSAGE_MS   1000       // how long a status message stays up
 
 
-#define RS LATD0
-#define EN LATD1
-#define ldata LATB
-#define LCD_Port TRISB
-#define LCD_Control TRISD
-
 // === Function Prototypes ===
-void LCD_Init();
-void LCD_Command(char);
-void LCD_Char(char);
-void LCD_String(const char *);
-void LCD_String_xy(char, char, const char *);
-void LCD_Clear();
-void MSdelay(unsigned int);
 char getKeypadKey();
 void displayMode();
 void playBuzzerTune();
+void setRelay(unsigned char on);
+void holdRelay(unsigned int ms);
+void showMessage(const char *text, unsigned int ms);
 
 // === Global Variables ===
 unsigned int count = 0;
@@ -83,8 +84,37 @@ char entryPassword[3] = "";
 char entryLeftDigit = '0';
 char entryRightDigit = '0';
 
+// === Status Message ===
+// Row 2 message cleared by the main loop once messageUntil is due, so no
+// pass waits for it and a stop is drawn on the next pass.
+unsigned char messageUp = 0;
+uint16_t messageUntil;
+
+// Keypad layout, keyMap[row * 4 + col]
+const char keyMap[16] = {
+    '1','4','7','*',
+    '2','5','8','0',
+    '3','6','9','#',
+    'A','B','C','D'
+};
+
+// === Buzzer Tunes ===
+// Played by the CCP2 PWM; melody_tick() in the 1 ms tick steps through them
+const melody_step_t wrongTune[] = {     // four falling beeps, 1 sec
+    { NOTE_A5, 125 }, { NOTE_REST, 125 },
+    { NOTE_F5, 125 }, { NOTE_REST, 125 },
+    { NOTE_D5, 125 }, { NOTE_REST, 125 },
+    { NOTE_A4, 125 }, { NOTE_REST, 125 },
+    MELODY_END
+};
+const melody_step_t sirenTune[] = {     // looped for the emergency
+    { NOTE_A6, 250 }, { NOTE_E6, 250 },
+    MELODY_END
+};
+
 void main(void)
 {
+    clock_init();           // HFINTOSC 4 MHz
     LCD_Init();
     LCD_Clear();
 
@@ -93,50 +123,69 @@ void main(void)
     ANSELA = 0x00;
     ANSELC = 0x00;
 
-    TRISAbits.TRISA0 = 0; TRISAbits.TRISA1 = 0;
-    TRISAbits.TRISA2 = 0; TRISAbits.TRISA3 = 0;
-
-    TRISCbits.TRISC4 = 1; TRISCbits.TRISC5 = 1;
-    TRISCbits.TRISC6 = 1; TRISCbits.TRISC7 = 1;
-    WPUCbits.WPUC4 = 1; WPUCbits.WPUC5 = 1;
-    WPUCbits.WPUC6 = 1; WPUCbits.WPUC7 = 1;
+    keypad_init(keyMap);    // rows RA0-RA3, columns RC4-RC7
 
     TRISD5 = 1; ANSELD5 = 0;
     TRISD6 = 1; ANSELD6 = 0;
     TRISA4 = 0; TRISA5 = 1;
     ANSELA4 = 0; ANSELA5 = 0;
 
-    TRISDbits.TRISD7 = 0; LATDbits.LATD7 = 0; // Buzzer
+    tone_init();            // buzzer on RD7 from CCP2
+    estop_init(sirenTune, EMERGENCY_MS);    // relay off, no emergency
     TRISCbits.TRISC2 = 1; ANSELCbits.ANSELC2 = 0; WPUCbits.WPUC2 = 1; // RC2 button input
 
     // Interrupt Setup
+    systick_init();
+    timing_set_yield(power_idle);   // delays idle until the next tick
     PIE0bits.IOCIE = 1;
     IOCCNbits.IOCCN2 = 1;  // Falling edge
     IOCCFbits.IOCCF2 = 0;
     INTCON0bits.IPEN = 0;
     INTCON0bits.GIE = 1;
 
-    LATAbits.LATA0 = 1;
-    LATAbits.LATA1 = 1;
-    LATAbits.LATA2 = 1;
-    LATAbits.LATA3 = 1;
-
     char key;
     char prevRD5 = 0, prevRD6 = 0, prevRA5 = 0;
 
-    LCD_String_xy(1, 0, "Relay");
-    LCD_String_xy(2, 0, "Button: OFF");
+    lcd_puts_at(1, 0, "Relay");
+    lcd_puts_at(2, 0, "Button: OFF");
 
     while(1)
     {
         key = getKeypadKey();
 
+        // Emergency screens are drawn here rather than in the interrupt;
+        // nothing below waits, so this is checked every 10 ms
+        if (estop_take_started())
+        {
+            messageUp = 0;
+            lcd_frame_clear();
+            lcd_puts_at(1, 0, "!!! EMERGENCY !!!");
+            lcd_puts_at(2, 0, "Buzzer 10 Sec");
+        }
+        if (estop_take_ended())
+        {
+            lcd_frame_clear();
+            displayMode();                // Redisplay mode
+        }
+        if (estop_active())
+        {
+            lcd_flush();                  // keys are dropped until it ends
+            delay_ms(10);
+            continue;
+        }
+
+        if (messageUp && timing_due(messageUntil))
+        {
+            messageUp = 0;
+            lcd_puts_at(2, 0, "                ");
+        }
+
         if (key == 'A') {
             mode++;
             if (mode > 4) mode = 1;
-            LCD_Clear();
+            messageUp = 0;
+            lcd_frame_clear();
             displayMode();
-            MSdelay(300);
         }
 
         if (mode == 1)
@@ -144,15 +193,15 @@ void main(void)
             if (PORTAbits.RA5 == 0 && prevRA5 == 0)
             {
                 relayState = 1;
-                LATAbits.LATA4 = 1;
-                LCD_String_xy(2, 0, "Button: ON ");
+                setRelay(1);
+                lcd_puts_at(2, 0, "Button: ON ");
                 prevRA5 = 1;
             }
             else if (PORTAbits.RA5 == 1 && prevRA5 == 1)
             {
                 relayState = 0;
-                LATAbits.LATA4 = 0;
-                LCD_String_xy(2, 0, "Button: OFF");
+                setRelay(0);
+                lcd_puts_at(2, 0, "Button: OFF");
                 prevRA5 = 0;
             }
         }
@@ -161,9 +210,7 @@ void main(void)
             if (PORTDbits.RD5 == 1 && prevRD5 == 0)
             {
                 count++;
-                char buf[16];
-                sprintf(buf, "Count: %u   ", count);
-                LCD_String_xy(2, 0, buf);
+                lcd_printf_at(2, 0, "Count: %u   ", count);
                 prevRD5 = 1;
             }
             else if (PORTDbits.RD5 == 0) prevRD5 = 0;
@@ -171,9 +218,7 @@ void main(void)
             if (PORTDbits.RD6 == 1 && prevRD6 == 0)
             {
                 if (count > 0) count--;
-                char buf[16];
-                sprintf(buf, "Count: %u   ", count);
-                LCD_String_xy(2, 0, buf);
+                lcd_printf_at(2, 0, "Count: %u   ", count);
                 prevRD6 = 1;
             }
             else if (PORTDbits.RD6 == 0) prevRD6 = 0;
@@ -184,29 +229,24 @@ void main(void)
             {
                 password[passwordPos++] = key;
                 password[passwordPos] = '\0';
-                LCD_String_xy(1, 0, "Set Password:");
-                LCD_String_xy(1, 14, password);
-                MSdelay(200);
+                lcd_puts_at(1, 0, "Set Password:");
+                lcd_puts_at(1, 14, password);
             }
             else if (key == '#')
             {
                 if (passwordPos == 2)
                 {
                     strcpy(setPassword, password);
-                    LCD_String_xy(2, 0, "Password SAVED ");
-                    MSdelay(1000);
-                    LCD_String_xy(2, 0, "                ");
+                    showMessage("Password SAVED ", MESSAGE_MS);
                 }
             }
             else if (key == 'C')
             {
                 password[0] = '\0';
                 passwordPos = 0;
-                LCD_String_xy(1, 0, "Set Password:");
-                LCD_String_xy(1, 14, "  ");
-                LCD_String_xy(2, 0, "Input cleared   ");
-                MSdelay(1000);
-                LCD_String_xy(2, 0, "                ");
+                lcd_puts_at(1, 0, "Set Password:");
+                lcd_puts_at(1, 14, "  ");
+                showMessage("Input cleared   ", MESSAGE_MS);
             }
         }
         else if (mode == 4)
@@ -225,9 +265,7 @@ void main(void)
             }
             else if (PORTDbits.RD6 == 0) prevRD6 = 0;
 
-            char disp[16];
-            sprintf(disp, "Enter: %c%c", entryLeftDigit, entryRightDigit);
-            LCD_String_xy(1, 0, disp);
+            lcd_printf_at(1, 0, "Enter: %c%c", entryLeftDigit, entryRightDigit);
 
             if (key == '#')
             {
@@ -237,97 +275,97 @@ void main(void)
 
                 if (strcmp(entryPassword, setPassword) == 0)
                 {
-                    LCD_String_xy(2, 0, "Access Granted ");
-                    LATAbits.LATA4 = 1;
-                    MSdelay(5000);
-                    LATAbits.LATA4 = 0;
+                    holdRelay(GRANTED_MS);    // the tick drops it again
+                    showMessage("Access Granted ", GRANTED_MS + MESSAGE_MS);
                 }
                 else
                 {
-                    LCD_String_xy(2, 0, "Wrong Password ");
                     playBuzzerTune();
+                    showMessage("Wrong Password ", MESSAGE_MS);
                 }
-                MSdelay(1000);
-                LCD_String_xy(2, 0, "                ");
             }
         }
 
-        MSdelay(10);
+        lcd_flush();
+        delay_ms(10);
     }
 }
 
 // === EMERGENCY INTERRUPT HANDLER ===
+// estop_trigger() drops the relay first, then starts the siren and flags
+// the main loop; the longest it waits to run is one keypad scan (about
+// 60 us), so the relay is off well within 1 ms of the button edge.
 void __interrupt(irq(default), base(0x0008)) ISR(void)
 {
+    keypad_ioc_isr();             // keypad columns share the IOC vector
+
     if (IOCCFbits.IOCCF2)
     {
+        IOCCFbits.IOCCF2 = 0;
+
         // Only activate if RC2 is really LOW (button pressed)
         if (PORTCbits.RC2 == 0)
-        {
-            IOCCFbits.IOCCF2 = 0;
+            estop_trigger();              // relay off, buzzer on, 10 sec
+    }
+}
 
-            LATAbits.LATA4 = 0;           // Turn off relay
-            LATDbits.LATD7 = 1;           // Buzzer ON
+// === 1 ms Tick: delays, buzzer tunes, relay hold and emergency time ===
+void __interrupt(irq(TMR0), base(0x0008)) TICK_ISR(void)
+{
+    PIR3bits.TMR0IF = 0;
+    timing_tick();
+    melody_tick();
+    estop_tick();
+}
 
-            LCD_Clear();
-            LCD_String_xy(1, 0, "!!! EMERGENCY !!!");
-            LCD_String_xy(2, 0, "Buzzer 10 Sec");
+// === Relay Output ===
+// Main code switches the relay through here: with interrupts held off
+// the emergency check and the write can't be split by the stop button.
+void estop_relay_write(uint8_t on)
+{
+    LATAbits.LATA4 = on;
+}
 
-            for (int i = 0; i < 1000; i++) __delay_ms(10); // 10 sec
+void setRelay(unsigned char on)
+{
+    INTCON0bits.GIE = 0;
+    estop_relay_set(on);
+    INTCON0bits.GIE = 1;
+}
 
-            LATDbits.LATD7 = 0;           // Buzzer OFF
-            LCD_Clear();
-            displayMode();                // Redisplay mode
-        }
-        else
-        {
-            IOCCFbits.IOCCF2 = 0; // Clear only
-        }
-    }
+// Relay on for ms, switched off by the tick
+void holdRelay(unsigned int ms)
+{
+    INTCON0bits.GIE = 0;
+    estop_relay_hold(ms);
+    INTCON0bits.GIE = 1;
+}
+
+// Row 2 message that the main loop clears after ms
+void showMessage(const char *text, unsigned int ms)
+{
+    lcd_puts_at(2, 0, text);
+    messageUp = 1;
+    messageUntil = millis() + ms;
 }
 
-// === Buzzer Tune (2-sec) ===
+// === Buzzer Tune (1-sec) ===
+// Starts the wrong-password tune and returns; the tick plays it. The
+// siren keeps the buzzer during an emergency.
 void playBuzzerTune()
 {
-    for (int i = 0; i < 4; i++)
-    {
-        LATDbits.LATD7 = 1;
-        MSdelay(125);
-        LATDbits.LATD7 = 0;
-        MSdelay(125);
-    }
+    INTCON0bits.GIE = 0;
+    if (!estop_active())
+        melody_play(wrongTune, 0);
+    INTCON0bits.GIE = 1;
 }
 
 // === Keypad Scanner ===
+// Next key pressed since the last call, 0 if none. The keypad ISRs do the
+// scanning and debouncing, so this never waits.
 char getKeypadKey()
 {
-    const char keyMap[4][4] = {
-        {'1','4','7','*'},
-        {'2','5','8','0'},
-        {'3','6','9','#'},
-        {'A','B','C','D'}
-    };
-    unsigned char rowMask[4] = {0b1110, 0b1101, 0b1011, 0b0111};
-
-    for (int row = 0; row < 4; row++)
-    {
-        LATA = (LATA & 0xF0) | rowMask[row];
-        MSdelay(1);
-        for (int col = 0; col < 4; col++)
-        {
-            if (((PORTC >> (col + 4)) & 0x01) == 0)
-            {
-                MSdelay(20);
-                if (((PORTC >> (col + 4)) & 0x01) == 0)
-                {
-                    while (((PORTC >> (col + 4)) & 0x01) == 0);
-                    return keyMap[row][col];
-                }
-            }
-        }
-    }
-
-    return 0;
+    return keypad_get_key();
 }
 
 // === Display Mode Info ===
@@ -335,81 +373,27 @@ void displayMode()
 {
     if (mode == 1)
     {
-        LCD_String_xy(1, 0, "Relay");
-        LCD_String_xy(2, 0, "Button: OFF");
+        lcd_puts_at(1, 0, "Relay");
+        lcd_puts_at(2, 0, "Button: OFF");
     }
     else if (mode == 2)
     {
-        LCD_String_xy(1, 0, "Photo Button U/D");
-        char buf[16];
-        sprintf(buf, "Count: %u", count);
-        LCD_String_xy(2, 0, buf);
+        lcd_puts_at(1, 0, "Photo Button U/D");
+        lcd_printf_at(2, 0, "Count: %u", count);
     }
     else if (mode == 3)
     {
-        LCD_String_xy(1, 0, "Set Password:");
-        LCD_String_xy(1, 14, setPassword);
-        LCD_String_xy(2, 0, "#:Save C:Clr     ");
+        lcd_puts_at(1, 0, "Set Password:");
+        lcd_puts_at(1, 14, setPassword);
+        lcd_puts_at(2, 0, "#:Save C:Clr     ");
         password[0] = '\0';
         passwordPos = 0;
     }
     else if (mode == 4)
     {
-        LCD_String_xy(1, 0, "Enter ");
-        LCD_String_xy(2, 0, "#: Enter");
+        lcd_puts_at(1, 0, "Enter ");
+        lcd_puts_at(2, 0, "#: Enter");
         entryLeftDigit = '0';
         entryRightDigit = '0';
     }
 }
-
-// === LCD Drivers ===
-void LCD_Init()
-{
-    MSdelay(15);
-    LCD_Port = 0x00;
-    LCD_Control = 0x00;
-    LCD_Command(0x01);
-    LCD_Command(0x38);
-    LCD_Command(0x0C);
-    LCD_Command(0x06);
-}
-
-void LCD_Command(char cmd)
-{
-    ldata = cmd;
-    RS = 0;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(3);
-}
-
-void LCD_Char(char dat)
-{
-    ldata = dat;
-    RS = 1;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(1);
-}
-
-void LCD_String(const char *msg)
-{
-    while (*msg) LCD_Char(*msg++);
-}
-
-void LCD_String_xy(char row, char pos, const char *msg)
-{
-    char loc = (row == 1) ? (0x80 | (pos & 0x0F)) : (0xC0 | (pos & 0x0F));
-    LCD_Command(loc);
-    LCD_String(msg);
-}
-
-void LCD_Clear()
-{
-    LCD_Command(0x01);
-}
-
-// === Delay (Blocking) ===
-void MSdelay(unsigned int val)
-{
-    for (unsigned int i = 0; i < val; i++)
-        for (unsigned int j = 0; j < 165; j++);
-}
@@ -2,8 +2,8 @@
 #define CONFIG_H
 
 // === CONFIG BITS ===
-#pragma config FEXTOSC = LP
-#pragma config RSTOSC = EXTOSC
+#pragma config FEXTOSC = OFF
+#pragma config RSTOSC = HFINTOSC_1MHZ
 #pragma config CLKOUTEN = OFF, PR1WAY = ON, CSWEN = ON, FCMEN = ON
 #pragma config MCLRE = EXTMCLR, PWRTS = PWRT_OFF, MVECEN = ON
 #pragma config IVT1WAY = ON, LPBOREN = OFF, BOREN = SBORDIS
@@ -15,6 +15,6 @@
 #pragma config WRTB = OFF, WRTC = OFF, WRTD = OFF, WRTSAF = OFF, LVP = ON
 #pragma config CP = OFF
 
-#define _XTAL_FREQ 4000000
+#include "../clock.h"
 
 #endif
@@ -1,15 +1,14 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
 
-void LCD_Init();
-void LCD_Command(char);
-void LCD_Char(char);
-void LCD_String(const char *);
-void LCD_String_xy(char, char, const char *);
-void LCD_Clear();
-void MSdelay(unsigned int);
-char getKeypadKey();
+#include <stdint.h>
+#include "../lcd.h"
+
 void displayMode();
-void playBuzzerTune();
+void setRelay(unsigned char on);
+void holdRelay(uint16_t ms);
+void showMessage(const char *text, uint16_t ms);
+void drawStatusLine(void);
+void showTaskStats(void);
 
 #endif
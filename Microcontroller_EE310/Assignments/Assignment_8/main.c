@@ -1,176 +1,342 @@
 #include "config.h"
 #include "init.h"
 #include "functions.h"
+#include "../keypad.h"
+#include "../sched.h"
+#include "../timing.h"
+#include "../systick.h"
+#include "../power.h"
+#include "../melody.h"
+#include "../estop.h"
+#include "../tone.h"
 #include <xc.h>
 #include <stdio.h>
 #include <string.h>
 
+#define EMERGENCY_MS 10000      // buzzer time after an emergency stop
+#define GRANTED_MS   5000       // relay time after the right password
+#define MESSAGE_MS   1000       // how long a status message stays up
+#define TUNE_MS      1000       // length of wrongTune
+
+// Keypad layout, keyMap[row * 4 + col]
+const char keyMap[16] = {
+    '1','4','7','*',
+    '2','5','8','0',
+    '3','6','9','#',
+    'A','B','C','D'
+};
+
+// === Buzzer Tunes ===
+// Played by the CCP2 PWM; melody_tick() in the 1 ms tick steps through them
+const melody_step_t wrongTune[] = {     // four falling beeps, 1 sec
+    { NOTE_A5, 125 }, { NOTE_REST, 125 },
+    { NOTE_F5, 125 }, { NOTE_REST, 125 },
+    { NOTE_D5, 125 }, { NOTE_REST, 125 },
+    { NOTE_A4, 125 }, { NOTE_REST, 125 },
+    MELODY_END
+};
+const melody_step_t sirenTune[] = {     // looped for the emergency
+    { NOTE_A6, 250 }, { NOTE_E6, 250 },
+    MELODY_END
+};
+
+// === Tasks ===
+// Each one runs to completion from the scheduler; waits are kept as
+// deadlines against sched_now() instead of delays.
+void keypadTask(void);
+void counterTask(void);
+void relayTask(void);
+void buzzerTask(void);
+void lcdTask(void);
+
+enum { TASK_COUNTER, TASK_RELAY, TASK_KEYPAD, TASK_BUZZER, TASK_LCD, TASK_COUNT };
+
+// Priority order: the photo-button edges are the easiest thing to miss
+sched_task_t tasks[TASK_COUNT] = {
+    SCHED_TASK(counterTask, 5, 0),                  // RD5/RD6 edges
+    SCHED_TASK(relayTask, 10, 0),                   // RA5 button
+    SCHED_TASK(keypadTask, 10, 0),                  // keys, modes, passwords
+    SCHED_TASK(buzzerTask, 0, 0),                   // starts tunes on request
+    SCHED_TASK(lcdTask, 20, 0),                     // messages, LCD flush
+};
+
+// === Task State ===
+char prevRD5 = 0, prevRD6 = 0, prevRA5 = 0;
+unsigned char messageUp = 0;        // status message on row 2
+uint16_t messageUntil;
+const melody_step_t *tuneRequest = 0;   // for the buzzer task
+unsigned char statsTask = 0;        // next task shown by the 'D' key
+
 void main(void)
 {
+    clock_init();           // HFINTOSC 4 MHz
     LCD_Init();
     LCD_Clear();
     initSystem();
+    keypad_init(keyMap);    // rows RA0-RA3, columns RC4-RC7
+    tone_init();            // buzzer on RD7 from CCP2
+    estop_init(sirenTune, EMERGENCY_MS);    // relay off, no emergency
+    systick_init();
 
-    char key;
-    char prevRD5 = 0, prevRD6 = 0, prevRA5 = 0;
-
-    LCD_String_xy(1, 0, "Relay");
-    LCD_String_xy(2, 0, "Button: OFF");
+    lcd_puts_at(1, 0, "Relay");
+    lcd_puts_at(2, 0, "Button: OFF");
 
+    sched_init(tasks, TASK_COUNT, systick_us);
     while (1)
     {
-        key = getKeypadKey();
-
-        if (key == 'A') {
-            mode++;
-            if (mode > 4) mode = 1;
-            LCD_Clear();
-            displayMode();
-            MSdelay(300);
-        }
+        if (!sched_run())
+            power_idle();   // the 1 ms tick wakes it for the next release
+    }
+}
 
-        if (mode == 1)
+// === Counter Task: photo buttons ===
+void counterTask(void)
+{
+    if (estop_active())
+        return;
+
+    if (PORTDbits.RD5 == 1 && prevRD5 == 0)
+    {
+        if (mode == 2)
         {
-            if (PORTAbits.RA5 == 0 && prevRA5 == 0)
-            {
-                relayState = 1;
-                LATAbits.LATA4 = 1;
-                LCD_String_xy(2, 0, "Button: ON ");
-                prevRA5 = 1;
-            }
-            else if (PORTAbits.RA5 == 1 && prevRA5 == 1)
-            {
-                relayState = 0;
-                LATAbits.LATA4 = 0;
-                LCD_String_xy(2, 0, "Button: OFF");
-                prevRA5 = 0;
-            }
+            count++;
+            lcd_printf_at(2, 0, "Count: %u   ", count);
         }
-        else if (mode == 2)
+        else if (mode == 4)
         {
-            if (PORTDbits.RD5 == 1 && prevRD5 == 0)
-            {
-                count++;
-                char buf[16];
-                sprintf(buf, "Count: %u   ", count);
-                LCD_String_xy(2, 0, buf);
-                prevRD5 = 1;
-            }
-            else if (PORTDbits.RD5 == 0) prevRD5 = 0;
-
-            if (PORTDbits.RD6 == 1 && prevRD6 == 0)
-            {
-                if (count > 0) count--;
-                char buf[16];
-                sprintf(buf, "Count: %u   ", count);
-                LCD_String_xy(2, 0, buf);
-                prevRD6 = 1;
-            }
-            else if (PORTDbits.RD6 == 0) prevRD6 = 0;
+            if (++entryLeftDigit > '9') entryLeftDigit = '0';
         }
-        else if (mode == 3)
+        prevRD5 = 1;
+    }
+    else if (PORTDbits.RD5 == 0) prevRD5 = 0;
+
+    if (PORTDbits.RD6 == 1 && prevRD6 == 0)
+    {
+        if (mode == 2)
         {
-            if (key >= '0' && key <= '9' && passwordPos < 2)
-            {
-                password[passwordPos++] = key;
-                password[passwordPos] = '\0';
-                LCD_String_xy(1, 0, "Set Password:");
-                LCD_String_xy(1, 14, password);
-                MSdelay(200);
-            }
-            else if (key == '#')
-            {
-                if (passwordPos == 2)
-                {
-                    strcpy(setPassword, password);
-                    LCD_String_xy(2, 0, "Password SAVED ");
-                    MSdelay(1000);
-                    LCD_String_xy(2, 0, "                ");
-                }
-            }
-            else if (key == 'C')
-            {
-                password[0] = '\0';
-                passwordPos = 0;
-                LCD_String_xy(1, 0, "Set Password:");
-                LCD_String_xy(1, 14, "  ");
-                LCD_String_xy(2, 0, "Input cleared   ");
-                MSdelay(1000);
-                LCD_String_xy(2, 0, "                ");
-            }
+            if (count > 0) count--;
+            lcd_printf_at(2, 0, "Count: %u   ", count);
         }
         else if (mode == 4)
         {
-            if (PORTDbits.RD5 == 1 && prevRD5 == 0)
-            {
-                if (++entryLeftDigit > '9') entryLeftDigit = '0';
-                prevRD5 = 1;
-            }
-            else if (PORTDbits.RD5 == 0) prevRD5 = 0;
+            if (++entryRightDigit > '9') entryRightDigit = '0';
+        }
+        prevRD6 = 1;
+    }
+    else if (PORTDbits.RD6 == 0) prevRD6 = 0;
 
-            if (PORTDbits.RD6 == 1 && prevRD6 == 0)
-            {
-                if (++entryRightDigit > '9') entryRightDigit = '0';
-                prevRD6 = 1;
-            }
-            else if (PORTDbits.RD6 == 0) prevRD6 = 0;
+    if (mode == 4)
+        lcd_printf_at(1, 0, "Enter: %c%c", entryLeftDigit, entryRightDigit);
+}
+
+// === Relay Task: mode 1 button ===
+// The access time runs from the tick (estop_relay_hold), not from here.
+void relayTask(void)
+{
+    if (mode != 1 || estop_active())
+        return;
 
-            char disp[16];
-            sprintf(disp, "Enter: %c%c", entryLeftDigit, entryRightDigit);
-            LCD_String_xy(1, 0, disp);
+    if (PORTAbits.RA5 == 0 && prevRA5 == 0)
+    {
+        relayState = 1;
+        setRelay(1);
+        lcd_puts_at(2, 0, "Button: ON ");
+        prevRA5 = 1;
+    }
+    else if (PORTAbits.RA5 == 1 && prevRA5 == 1)
+    {
+        relayState = 0;
+        setRelay(0);
+        lcd_puts_at(2, 0, "Button: OFF");
+        prevRA5 = 0;
+    }
+}
+
+// === Keypad Task: mode switching and passwords ===
+void keypadTask(void)
+{
+    char key = keypad_get_key();   // 0 when no key went down
+
+    if (!key || estop_active())
+        return;                    // keys are dropped during an emergency
+
+    if (key == 'A')
+    {
+        mode++;
+        if (mode > 4) mode = 1;
+        messageUp = 0;
+        lcd_frame_clear();
+        displayMode();
+        return;
+    }
+    if (key == 'D')
+    {
+        showTaskStats();
+        return;
+    }
 
-            if (key == '#')
+    if (mode == 3)
+    {
+        if (key >= '0' && key <= '9' && passwordPos < 2)
+        {
+            password[passwordPos++] = key;
+            password[passwordPos] = '\0';
+            lcd_puts_at(1, 0, "Set Password:");
+            lcd_puts_at(1, 14, password);
+        }
+        else if (key == '#')
+        {
+            if (passwordPos == 2)
             {
-                entryPassword[0] = entryLeftDigit;
-                entryPassword[1] = entryRightDigit;
-                entryPassword[2] = '\0';
-
-                if (strcmp(entryPassword, setPassword) == 0)
-                {
-                    LCD_String_xy(2, 0, "Access Granted ");
-                    LATAbits.LATA4 = 1;
-                    MSdelay(5000);
-                    LATAbits.LATA4 = 0;
-                }
-                else
-                {
-                    LCD_String_xy(2, 0, "Wrong Password ");
-                    playBuzzerTune();
-                }
-                MSdelay(1000);
-                LCD_String_xy(2, 0, "                ");
+                strcpy(setPassword, password);
+                showMessage("Password SAVED ", MESSAGE_MS);
             }
         }
+        else if (key == 'C')
+        {
+            password[0] = '\0';
+            passwordPos = 0;
+            lcd_puts_at(1, 0, "Set Password:");
+            lcd_puts_at(1, 14, "  ");
+            showMessage("Input cleared   ", MESSAGE_MS);
+        }
+    }
+    else if (mode == 4 && key == '#')
+    {
+        entryPassword[0] = entryLeftDigit;
+        entryPassword[1] = entryRightDigit;
+        entryPassword[2] = '\0';
 
-        MSdelay(10);
+        if (strcmp(entryPassword, setPassword) == 0)
+        {
+            holdRelay(GRANTED_MS);    // the tick drops it again
+            showMessage("Access Granted ", GRANTED_MS + MESSAGE_MS);
+        }
+        else
+        {
+            tuneRequest = wrongTune;
+            sched_ready(&tasks[TASK_BUZZER]);
+            showMessage("Wrong Password ", TUNE_MS + MESSAGE_MS);
+        }
     }
 }
 
+// === Buzzer Task: starts a requested tune ===
+// The tune itself plays from the tick; the siren keeps the buzzer during
+// an emergency.
+void buzzerTask(void)
+{
+    INTCON0bits.GIE = 0;
+    if (!estop_active())
+        melody_play(tuneRequest, 0);
+    INTCON0bits.GIE = 1;
+}
+
+// === LCD Task: emergency screens, message timeouts, flush ===
+void lcdTask(void)
+{
+    // Emergency screens are drawn here rather than in the interrupt
+    if (estop_take_started())
+    {
+        messageUp = 0;
+        lcd_frame_clear();
+        lcd_puts_at(1, 0, "!!! EMERGENCY !!!");
+        lcd_puts_at(2, 0, "Buzzer 10 Sec");
+    }
+    if (estop_take_ended())
+    {
+        lcd_frame_clear();
+        displayMode();
+    }
+
+    if (messageUp && (int16_t)(sched_now() - messageUntil) >= 0)
+    {
+        messageUp = 0;
+        drawStatusLine();
+    }
+
+    lcd_flush();
+}
+
+// Status message on row 2 that clears itself after ms
+void showMessage(const char *text, uint16_t ms)
+{
+    lcd_puts_at(2, 0, text);
+    messageUp = 1;
+    messageUntil = sched_now() + ms;
+}
+
+// Row 2 as the mode normally shows it, once a message has gone
+void drawStatusLine(void)
+{
+    if (mode == 1)
+        lcd_puts_at(2, 0, relayState ? "Button: ON " : "Button: OFF");
+    else if (mode == 2)
+        lcd_printf_at(2, 0, "Count: %u   ", count);
+    else
+        lcd_puts_at(2, 0, "                ");
+}
+
+// 'D' key: worst-case run time (us) and overruns of one task per press
+void showTaskStats(void)
+{
+    char line[17];
+    sched_task_t *t = &tasks[statsTask];
+
+    // 16 characters at the widest ("T4 65535us O9999"); past 9999 the
+    // count shows as 9999 rather than running off the line
+    snprintf(line, sizeof line, "T%u %5uus O%-4u", statsTask, t->wcet,
+             t->overruns > 9999 ? 9999 : t->overruns);
+    showMessage(line, 3 * MESSAGE_MS);
+    if (++statsTask >= TASK_COUNT) statsTask = 0;
+}
+
 // === EMERGENCY INTERRUPT HANDLER ===
+// estop_trigger() drops the relay first, then starts the buzzer and flags
+// the tasks; the longest it waits to run is one keypad scan (about 60 us).
 void __interrupt(irq(default), base(0x0008)) ISR(void)
 {
+    keypad_ioc_isr();
+
     if (IOCCFbits.IOCCF2)
     {
+        IOCCFbits.IOCCF2 = 0;
+
         if (PORTCbits.RC2 == 0)
-        {
-            IOCCFbits.IOCCF2 = 0;
+            estop_trigger();
+    }
+}
 
-            LATAbits.LATA4 = 0;
-            LATDbits.LATD7 = 1;
+// === 1 ms Tick ===
+// Tunes, the relay hold and the emergency run from here rather than from
+// a task, so they keep time however long the tasks take.
+void __interrupt(irq(TMR0), base(0x0008)) TICK_ISR(void)
+{
+    PIR3bits.TMR0IF = 0;
+    timing_tick();
+    sched_tick();
+    melody_tick();
+    estop_tick();
+}
 
-            LCD_Clear();
-            LCD_String_xy(1, 0, "!!! EMERGENCY !!!");
-            LCD_String_xy(2, 0, "Buzzer 10 Sec");
+void estop_relay_write(uint8_t on)
+{
+    LATAbits.LATA4 = on;
+}
 
-            for (int i = 0; i < 1000; i++) __delay_ms(10);
+// Main code switches the relay through here so a stop can't land
+// between the emergency check and the write.
+void setRelay(unsigned char on)
+{
+    INTCON0bits.GIE = 0;
+    estop_relay_set(on);
+    INTCON0bits.GIE = 1;
+}
 
-            LATDbits.LATD7 = 0;
-            LCD_Clear();
-            displayMode();
-        }
-        else
-        {
-            IOCCFbits.IOCCF2 = 0;
-        }
-    }
+// Relay on for ms, switched off by the tick
+void holdRelay(uint16_t ms)
+{
+    INTCON0bits.GIE = 0;
+    estop_relay_hold(ms);
+    INTCON0bits.GIE = 1;
 }
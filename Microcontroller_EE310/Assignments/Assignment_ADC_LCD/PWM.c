@@ -0,0 +1,150 @@
+#include <xc.h>
+#include "PWM.h"
+
+#define PWM_WRITE_CLOCKS 16     // instruction cycles the two duty writes can take
+
+typedef struct {
+    volatile uint8_t *tmr, *pr, *con, *clkcon, *hlt, *rst;
+} timer_regs_t;
+
+typedef struct {
+    volatile uint8_t *con, *dcl, *dch;
+} channel_regs_t;
+
+// Indexed by pwm_timer_t - 1
+static const timer_regs_t timerRegs[3] = {
+    { &T2TMR, &T2PR, &T2CON, &T2CLKCON, &T2HLT, &T2RST },
+    { &T4TMR, &T4PR, &T4CON, &T4CLKCON, &T4HLT, &T4RST },
+    { &T6TMR, &T6PR, &T6CON, &T6CLKCON, &T6HLT, &T6RST },
+};
+
+static const channel_regs_t channelRegs[PWM_CHANNELS] = {
+    { &CCP1CON, &CCPR1L, &CCPR1H },
+    { &CCP2CON, &CCPR2L, &CCPR2H },
+    { &CCP3CON, &CCPR3L, &CCPR3H },
+    { &CCP4CON, &CCPR4L, &CCPR4H },
+    { &PWM5CON, &PWM5DCL, &PWM5DCH },
+    { &PWM6CON, &PWM6DCL, &PWM6DCH },
+    { &PWM7CON, &PWM7DCL, &PWM7DCH },
+    { &PWM8CON, &PWM8DCL, &PWM8DCH },
+};
+
+static uint8_t channelTimer[PWM_CHANNELS];     // pwm_timer_t - 1
+
+///////////////  TIMERS
+
+void pwm_timer_init(pwm_timer_t timer, const pwm_period_t *period)
+{
+    const timer_regs_t *t = &timerRegs[timer - 1];
+
+    *t->con = 0x00;
+    *t->clkcon = 0x01;          // FOSC/4
+    *t->hlt = 0x00;             // free running, software control
+    *t->rst = 0x00;
+    *t->pr = period->pr;
+    *t->tmr = 0x00;
+    *t->con = 0x80 | (uint8_t)(period->ckps << 4);  // ON, CKPS, postscale 1:1
+}
+
+void pwm_timer_stop(pwm_timer_t timer)
+{
+    *timerRegs[timer - 1].con &= 0x7F;
+}
+
+///////////////  CHANNELS
+
+void pwm_init(pwm_channel_t ch, pwm_timer_t timer)
+{
+    const channel_regs_t *r = &channelRegs[ch];
+
+    // Timer select: two bits per channel, CCP1-4 in CCPTMRS0, PWM5-8 in CCPTMRS1
+    if (ch < PWM_PWM5) {
+        uint8_t shift = (uint8_t)(ch * 2);
+        CCPTMRS0 = (CCPTMRS0 & (uint8_t)~(0x03 << shift)) | (uint8_t)(timer << shift);
+    } else {
+        uint8_t shift = (uint8_t)((ch - PWM_PWM5) * 2);
+        CCPTMRS1 = (CCPTMRS1 & (uint8_t)~(0x03 << shift)) | (uint8_t)(timer << shift);
+    }
+    channelTimer[ch] = timer - 1;
+
+    *r->dch = 0x00;
+    *r->dcl = 0x00;
+    if (ch < PWM_PWM5)
+        *r->con = 0x8C;         // EN, PWM mode, right aligned
+    else
+        *r->con = 0x80;         // EN, active high
+}
+
+void pwm_disable(pwm_channel_t ch)
+{
+    *channelRegs[ch].con = 0x00;
+}
+
+// The duty registers are copied into the live duty when the timer matches
+// PR, so a write there could pair the new high byte with the old low one.
+// Wait out the last few counts of the period, then write both bytes with
+// interrupts held off. Very short periods (PR below the margin) can't be
+// protected this way and are written directly.
+void pwm_set_duty(pwm_channel_t ch, uint16_t duty)
+{
+    const channel_regs_t *r = &channelRegs[ch];
+    const timer_regs_t *t = &timerRegs[channelTimer[ch]];
+    uint8_t hi, lo;
+
+    if (duty > 1023)
+        duty = 1023;
+    if (ch < PWM_PWM5) {
+        hi = (uint8_t)(duty >> 8);      // right aligned
+        lo = (uint8_t)duty;
+    } else {
+        hi = (uint8_t)(duty >> 2);      // left aligned: DCL<7:6>
+        lo = (uint8_t)(duty << 6);
+    }
+
+    uint8_t con = *t->con;
+    uint8_t margin = (uint8_t)((PWM_WRITE_CLOCKS >> ((con >> 4) & 0x07)) + 1);
+    uint8_t pr = *t->pr;
+    uint8_t gie = INTCON0bits.GIE;
+
+    INTCON0bits.GIE = 0;
+    if ((con & 0x80) && pr > margin)
+        while (*t->tmr >= pr - margin)
+            ;
+    *r->dch = hi;
+    *r->dcl = lo;
+    INTCON0bits.GIE = gie;
+}
+
+uint8_t pwm_output(pwm_channel_t ch)
+{
+    return (*channelRegs[ch].con >> 5) & 0x01;     // OUT
+}
+
+///////////////  PPS
+
+static void Set_PPS(volatile uint8_t *pps, uint8_t source)
+{
+    uint8_t gie = INTCON0bits.GIE;
+
+    INTCON0bits.GIE = 0;        // the unlock sequence must not be split
+    PPSLOCK = 0x55;
+    PPSLOCK = 0xAA;
+    PPSLOCKbits.PPSLOCKED = 0x00; // unlock PPS
+
+    *pps = source;
+
+    PPSLOCK = 0x55;
+    PPSLOCK = 0xAA;
+    PPSLOCKbits.PPSLOCKED = 0x01; // lock PPS
+    INTCON0bits.GIE = gie;
+}
+
+void pwm_route(pwm_channel_t ch, volatile uint8_t *pps)
+{
+    Set_PPS(pps, (uint8_t)(0x09 + ch));   // CCP1 0x09 .. CCP4 0x0C, PWM5 0x0D .. PWM8 0x10
+}
+
+void pwm_unroute(volatile uint8_t *pps)
+{
+    Set_PPS(pps, 0x00);
+}
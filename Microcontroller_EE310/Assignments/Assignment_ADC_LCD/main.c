@@ -1,6 +1,6 @@
 // === CONFIG BITS ===
-#pragma config FEXTOSC = LP     
-#pragma config RSTOSC = EXTOSC  
+#pragma config FEXTOSC = OFF    
+#pragma config RSTOSC = HFINTOSC_1MHZ
 #pragma config CLKOUTEN = OFF   
 #pragma config PR1WAY = ON      
 #pragma config CSWEN = ON       
@@ -13,7 +13,7 @@
 #pragma config BOREN = SBORDIS  
 #pragma config BORV = VBOR_2P45 
 #pragma config ZCD = OFF        
-#pragma config PPS1WAY = ON     
+#pragma config PPS1WAY = OFF    
 #pragma config STVREN = ON      
 #pragma config DEBUG = OFF      
 #pragma config XINST = OFF      
@@ -35,56 +35,121 @@
 #include <xc.h> 
 #include "PWM.h"
 #include "configwords.h"
+#include "../power.h"
+#include "../clock.h"
+#include "../adc_filter.h"
+#include "pi_ctrl.h"
 #include "C:\Program Files\Microchip\xc8\v3.00\pic\include\proc\pic18f47k42.h"
 
-#define _XTAL_FREQ 4000000      // Fosc frequency for _delay() functions
-#define FCY (_XTAL_FREQ / 4)     // Instruction cycle frequency (1 MHz)
 
 #define myLED PORTBbits.RB0
 
-// Define the desired duty cycle percentage here
-#define DESIRED_DUTY_CYCLE_PERCENT 10.0
+// Define the desired duty cycle percentage here. With CLOSED_LOOP the PI
+// controller instead holds the RA0 voltage (the PWM through an RC filter)
+// at that percentage of full scale, whatever the load.
+#define DESIRED_DUTY_CYCLE_PERCENT 10
+#define PWM_FREQUENCY_HZ 977    // 1 MHz / (4 * 256): TMR2 at 1:4, PR 255
+#define CLOSED_LOOP 1
+
+// PI gains, Q8 duty steps per ADC count. Tuned on the 10 k / 1 uF filter
+// sampled every period, loaded or not (tests/test_pi_ctrl.c): a step
+// settles to 2% within about 20 periods; start-up from 0 V overshoots by
+// up to 3% of full scale, later steps by under 1.5%.
+#define PI_KP 192
+#define PI_KI 32
 
 // Global Variables
 uint16_t checkdutyCycle;
 char preScale;
+pwm_period_t pwmPeriod;
+pi_ctrl_t pi;
+uint16_t setpoint;              // ADC counts
+
+void ADC_Init(void);
 _Bool pwmStatus;
 
 void main(void)
 {
     // Clock Initialization
-    OSCSTATbits.HFOR = 1;          // Enable HFINTOSC
-    OSCFRQ = 0x02;                 // Set internal oscillator to 4 MHz
+    clock_init();                  // HFINTOSC 4 MHz (clock.h)
 
     // I/O Configuration
     ANSELB = 0x00;                 // Set PORTB as digital
     TRISB = 0x00;                  // Set PORTB as output
     PORTB = 0x00;                  // Clear PORTB outputs
 
-    // Timer2 and PWM Module Initialization
-    TMR2_Initialize();
-    TMR2_StartTimer();
-    PWM_Output_D8_Enable();
-    PWM2_Initialize();
+    // Timer2 and PWM Module Initialization: frequency with full 10-bit duty
+    pwm_period_solve(PWM_FCY, PWM_FREQUENCY_HZ, 10, &pwmPeriod);
+    pwm_timer_init(PWM_TMR2, &pwmPeriod);
+    pwm_init(PWM_CCP2, PWM_TMR2);
+    pwm_route(PWM_CCP2, &RB3PPS);  // D8
+    pwm_route(PWM_CCP2, &RB2PPS);  // mirrored on RB2
 
     // --- Dynamic Duty Cycle Setup ---
-    // Calculate duty register value dynamically based on desired percentage
-    uint16_t calculatedDuty = (uint16_t)((DESIRED_DUTY_CYCLE_PERCENT / 100.0) * (4 * (T2PR + 1)));
-    PWM2_LoadDutyValue(calculatedDuty);
+    // Duty register value for the desired percentage, rounded, in integers
+    uint16_t steps = pwm_period_steps(&pwmPeriod);
+    uint16_t calculatedDuty = (uint16_t)(((uint32_t)DESIRED_DUTY_CYCLE_PERCENT * steps + 50) / 100);
+    pwm_set_duty(PWM_CCP2, calculatedDuty);
+
+#if CLOSED_LOOP
+    // Start from the open-loop duty and let the PI trim it every period
+    setpoint = (uint16_t)(((uint32_t)DESIRED_DUTY_CYCLE_PERCENT * 4095 + 50) / 100);
+    pi_init(&pi, PI_KP, PI_KI, steps - 1);
+    pi.integ = (int32_t)calculatedDuty << 8;
+    ADC_Init();
+#endif
 
     // Optional: Calculate actual duty cycle for validation
-    checkdutyCycle = (uint16_t)((100UL * calculatedDuty) / (4 * (T2PR + 1)));
-    preScale = ((T2CON >> 4) & (0x0F)); // Prescaler setting readback (for diagnostics)
+    checkdutyCycle = (uint16_t)((100UL * calculatedDuty) / steps);
+    preScale = ((T2CON >> 4) & (0x07)); // Prescaler setting readback (for diagnostics)
+
+    // LED toggles from the Timer2 interrupt, so the CPU can idle in between
+    PIR4bits.TMR2IF = 0;
+    PIE4bits.TMR2IE = 1;
+    INTCON0bits.GIE = 1;
 
     while (1)
     {
-        pwmStatus = PWM2_OutputStatusGet();
-        PORTBbits.RB2 = pwmStatus;
-
-        if (PIR4bits.TMR2IF == 1)
-        {
-            PIR4bits.TMR2IF = 0;
-            myLED ^= 1; // Toggle LED on Timer2 overflow
-        }
+        power_idle();
+        pwmStatus = pwm_output(PWM_CCP2);
     }
 }
+
+// === ADC: RA0 sampled once per PWM period ===
+// Each TMR2 period starts a 4-sample burst (ADACT); the ADT interrupt at
+// the end of it runs the PI. The new duty is written early in the period
+// and the hardware takes it at the next one.
+void ADC_Init(void)
+{
+    TRISAbits.TRISA0 = 1;       // RA0 as input
+    ANSELAbits.ANSELA0 = 1;     // RA0 analog
+
+    ADPCH = 0x00;               // Select AN0
+    ADCON0bits.CS = 1;          // Use internal clock
+    ADCON0bits.FM = 1;          // Right justified
+    ADCON0bits.ON = 1;          // Turn ADC ON
+    adc_filter_init(2);         // Average 4 samples per burst
+
+    ADACQL = 0x08;              // 8 TAD acquisition before each triggered conversion
+    ADACQH = 0x00;
+    ADACT = 0x04;               // auto-conversion trigger: TMR2
+
+    PIR1bits.ADTIF = 0;
+    PIE1bits.ADTIE = 1;
+}
+
+void __interrupt(irq(ADT), base(0x0008)) ADC_ISR(void)
+{
+    PIR1bits.ADTIF = 0;
+    ADCON2bits.ACLR = 1;        // next burst starts from an empty ADACC
+
+    int16_t error = (int16_t)setpoint - (int16_t)adc_filter_result();
+    pwm_set_duty(PWM_CCP2, pi_update(&pi, error));
+}
+
+// === Timer2 Interrupt: LED toggle ===
+void __interrupt(irq(TMR2), base(0x0008)) TMR2_ISR(void)
+{
+    PIR4bits.TMR2IF = 0;
+    myLED ^= 1; // Toggle LED on Timer2 overflow
+}
@@ -0,0 +1,36 @@
+#include "pi_ctrl.h"
+
+void pi_init(pi_ctrl_t *pi, int16_t kp, int16_t ki, uint16_t out_max)
+{
+    pi->kp = kp;
+    pi->ki = ki;
+    pi->out_max = out_max;
+    pi->integ = 0;
+}
+
+uint16_t pi_update(pi_ctrl_t *pi, int16_t error)
+{
+    int32_t limit = (int32_t)pi->out_max << 8;
+    int32_t integ = pi->integ + (int32_t)pi->ki * error;
+    int32_t out = (int32_t)pi->kp * error + integ;
+
+    // Only keep the new integral if the output isn't being pushed past a limit
+    if (out > limit) {
+        out = limit;
+        if (error < 0)
+            pi->integ = integ;
+    } else if (out < 0) {
+        out = 0;
+        if (error > 0)
+            pi->integ = integ;
+    } else {
+        pi->integ = integ;
+    }
+
+    if (pi->integ > limit)
+        pi->integ = limit;
+    else if (pi->integ < 0)
+        pi->integ = 0;
+
+    return (uint16_t)((out + 128) >> 8);
+}
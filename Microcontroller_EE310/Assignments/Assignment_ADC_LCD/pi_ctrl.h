@@ -0,0 +1,36 @@
+/* 
+ * File:   pi_ctrl.h
+ * Integer PI controller for driving a PWM duty from an ADC reading.
+ *
+ * Gains are Q8 (256 = 1.0) in duty steps per ADC count, and the
+ * integral is kept in Q8 duty steps, so an update is two 16x16
+ * multiplies and some adds with no float. The output is clamped to
+ * 0..out_max; while it sits on a limit the integral stops growing in that
+ * direction (anti-windup), so the loop comes off the limit without
+ * overshooting. Plain C with no register access, so it also builds on a
+ * host.
+ *
+ * Per update, XC8 does the two products with its 32-bit multiply routine,
+ * followed by 32-bit adds, compares and one shift, and no division. From
+ * the ADT interrupt it has one PWM period (1024 instruction cycles at
+ * 977 Hz) to finish before the next burst completes.
+ */
+
+#ifndef PI_CTRL_H
+#define	PI_CTRL_H
+
+#include <stdint.h>
+
+typedef struct {
+    int16_t kp;             // Q8
+    int16_t ki;             // Q8, per update
+    uint16_t out_max;
+    int32_t integ;          // Q8 duty steps
+} pi_ctrl_t;
+
+void pi_init(pi_ctrl_t *pi, int16_t kp, int16_t ki, uint16_t out_max);
+
+// error = setpoint - measurement, in ADC counts. Returns the new duty.
+uint16_t pi_update(pi_ctrl_t *pi, int16_t error);
+
+#endif	/* PI_CTRL_H */
@@ -0,0 +1,35 @@
+#include "pwm_period.h"
+
+uint8_t pwm_period_solve(uint32_t fcy, uint32_t hz, uint8_t min_bits, pwm_period_t *p)
+{
+    if (!hz || min_bits > 10)
+        return 0;
+
+    for (uint8_t ckps = 0; ckps < 8; ckps++) {
+        uint32_t div = hz << ckps;
+        uint32_t counts = (fcy + div / 2) / div;    // pr + 1, rounded
+
+        // Rounded up to 257 from no further than 257: the next prescale
+        // would round to the same period with half the duty steps
+        if (counts == 257 && ckps < 7 && fcy <= 257 * div)
+            counts = 256;
+        if (counts > 256)
+            continue;               // needs a bigger prescale
+        if (!counts || 4 * counts < (1u << min_bits))
+            return 0;               // too fast, or too coarse from here on
+        p->ckps = ckps;
+        p->pr = (uint8_t)(counts - 1);
+        return 1;
+    }
+    return 0;                       // too slow even at 1:128
+}
+
+uint16_t pwm_period_counts(const pwm_period_t *p)
+{
+    return (uint16_t)(((uint16_t)p->pr + 1) << p->ckps);
+}
+
+uint16_t pwm_period_steps(const pwm_period_t *p)
+{
+    return 4 * ((uint16_t)p->pr + 1);
+}
@@ -0,0 +1,38 @@
+/* 
+ * File:   pwm_period.h
+ * Timer settings for a PWM frequency: the TMR2/4/6 prescale and period
+ * register closest to a requested frequency, with at least the requested
+ * duty resolution. Plain C with no register access, so it also builds on
+ * a host.
+ *
+ * With a prescale of 1 << ckps the PWM period is (pr + 1) << ckps timer
+ * clocks. The duty registers count quarters of a timer count, so one
+ * period has 4 * (pr + 1) duty steps (the 10-bit registers reach 1023).
+ * The smallest prescale that fits the period into 8 bits gives both the
+ * closest period and the finest duty, so that is the one picked; a period
+ * just over 256 counts that rounds no closer at the next prescale stays
+ * at PR = 255. tests/test_pwm_period.c checks this against every pair.
+ */
+
+#ifndef PWM_PERIOD_H
+#define	PWM_PERIOD_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t ckps;           // TxCON.CKPS: prescale 1 << ckps, 0..7
+    uint8_t pr;             // TxPR
+} pwm_period_t;
+
+// fcy is the timer clock (FOSC/4), hz the wanted frequency, min_bits the
+// duty resolution needed (0..10). Returns 0 if the frequency is out of
+// reach or can't be had with that resolution.
+uint8_t pwm_period_solve(uint32_t fcy, uint32_t hz, uint8_t min_bits, pwm_period_t *p);
+
+// Timer clocks per PWM period.
+uint16_t pwm_period_counts(const pwm_period_t *p);
+
+// Duty steps per period: 4 * (pr + 1).
+uint16_t pwm_period_steps(const pwm_period_t *p);
+
+#endif	/* PWM_PERIOD_H */
@@ -3,8 +3,11 @@
 ;---------------------
 ; Program Details:
 ; The purpose of this program is to demonstrate how to call a delay function. 
+; Since V1.4 the blink is made in hardware: NCO1 runs from LFINTOSC and
+; drives RD0, CLC1 inverts it onto RD1, and the CPU goes to Idle. The rate
+; only depends on BLINK_INC, not on the code or the system clock.
 
-; Inputs: Inner_loop ,Outer_loop 
+; Inputs: BLINK_INC (see nco_blink.py)
 ; Outputs: PORTD
 ; Date: March 5, 2025
 ; File Dependencies / Libraries: None 
@@ -12,6 +15,7 @@
 ; Author: Eduardo Williams 
 ; Versions:
 ;       V1.3: Changes the loop size
+;       V1.4: NCO1 + CLC1 blink the LEDs, no delay loops
 ; Useful links: 
 ;       Datasheet: https://ww1.microchip.com/downloads/en/DeviceDoc/PIC18(L)F26-27-45-46-47-55-56-57K42-Data-Sheet-40001919G.pdf 
 ;       PIC18F Instruction Sets: https://onlinelibrary.wiley.com/doi/pdf/10.1002/9781119448457.app4 
@@ -27,23 +31,28 @@
 #include <xc.inc>; matching words to registers
 
 ;********************************************************************
-; Program: Blink LED with Delay using Nested Loops
-; Description: This program toggles an LED on PORTD with a delay.
-; The delay is controlled using two nested loops.
+; Program: Blink LED with the Numerically Controlled Oscillator
+; Description: This program alternates two LEDs on PORTD.
+; NCO1 in fixed duty cycle mode toggles each time its 20-bit
+; accumulator overflows, so the blink rate is
+;       f = 31000 * BLINK_INC / 2^21  Hz
+; CLC1 is set up as NOT NCO1 so RD1 is always the opposite of RD0.
+; Rounding BLINK_INC costs up to 0.62% at 1-2 Hz and grows at lower
+; rates (5.9% near 0.1 Hz); nco_blink.py lists the bound per rate band.
 ;********************************************************************
 
 ;---------------------
 ; Program Inputs
 ;---------------------
-Inner_loop  equ 5         ; Inner loop delay count (decimal)
-Outer_loop  equ 5         ; Outer loop delay count (decimal)
+BLINK_INC   equ 68        ; NCO1 increment: 68 -> 1.005 Hz, +0.52% (python3 nco_blink.py 1)
 
 ;---------------------
 ; Program Constants
 ;---------------------
-REG10   equ     10h       ; Register for inner loop counter
-REG11   equ     11h       ; Register for outer loop counter
-REG01   equ     1h        ; Register to store toggle value
+NCO_LFINTOSC equ 0x02     ; NCO1CLK: clock from LFINTOSC (31 kHz, runs in Idle)
+NCO1_PPS     equ 0x27     ; RxyPPS output code for NCO1OUT
+CLC1_PPS     equ 0x01     ; RxyPPS output code for CLC1OUT
+CLC_NCO1     equ 0x1F     ; CLCxSELy data input code for NCO1OUT
 
 ;---------------------
 ; Pin Definitions
@@ -66,35 +75,78 @@ REG01   equ     1h        ; Register to store toggle value
 ; Initialization Section
 ;---------------------------------------------------------------
 _start1:
+    BANKSEL     ANSELD
+    CLRF        ANSELD               ; PORTD digital I/O
+    BANKSEL     LATD
+    CLRF        LATD
     MOVLW       0b11111100           ; Load WREG with binary 11111100
     MOVWF       TRISD,0              ; Configure PORTD (RD0 & RD1 as outputs)
-    MOVLW	0b11111101
-    MOVWF       REG01,0              ; Initialize REG01 with the same value
 
 ;---------------------------------------------------------------
-; Main Loop: Toggles LED with delay
+; NCO1: fixed duty cycle, LFINTOSC clock
 ;---------------------------------------------------------------
-_onoff:
-    MOVFF       REG01,PORTD          ; Move REG01 value to PORTD (toggle LED state)
-    MOVLW       Inner_loop            ; Load WREG with Inner_loop constant (5)
-    MOVWF       REG10                 ; Store in REG10 (inner loop counter)
-    MOVLW       Outer_loop            ; Load WREG with Outer_loop constant (5)
-    MOVWF       REG11                 ; Store in REG11 (outer loop counter)
+    BANKSEL     NCO1CON
+    CLRF        NCO1CON              ; Off while it is set up
+    MOVLW       NCO_LFINTOSC
+    MOVWF       NCO1CLK
+    CLRF        NCO1ACCU
+    CLRF        NCO1ACCH
+    CLRF        NCO1ACCL
+    MOVLW       (BLINK_INC >> 16) & 0xFF
+    MOVWF       NCO1INCU
+    MOVLW       (BLINK_INC >> 8) & 0xFF
+    MOVWF       NCO1INCH
+    MOVLW       BLINK_INC & 0xFF
+    MOVWF       NCO1INCL             ; INCL last: the write loads all three bytes
+    MOVLW       0x80
+    MOVWF       NCO1CON              ; EN, FDC mode, active high
 
 ;---------------------------------------------------------------
-; Delay Implementation: Nested Loop
+; CLC1: 4-input AND of NCO1 and three idle gates, output inverted
 ;---------------------------------------------------------------
-_loop1:
-    DECF        REG10,1               ; Decrement REG10 (inner loop counter)
-    BNZ         _loop1                ; If REG10 is not zero, repeat inner loop
-    DECF        REG11,1               ; Decrement REG11 (outer loop counter)
-    BNZ         _loop1                ; If REG11 is not zero, repeat outer loop
+    BANKSEL     CLC1CON
+    CLRF        CLC1CON
+    MOVLW       CLC_NCO1
+    MOVWF       CLC1SEL0             ; d1 = NCO1
+    MOVLW       0x02
+    MOVWF       CLC1GLS0             ; gate 1 = d1 true
+    CLRF        CLC1GLS1             ; gates 2-4 have no inputs (0) ...
+    CLRF        CLC1GLS2
+    CLRF        CLC1GLS3
+    MOVLW       0x8E
+    MOVWF       CLC1POL              ; ... and are inverted to 1; output inverted
+    MOVLW       0x82
+    MOVWF       CLC1CON              ; EN, 4-input AND
 
 ;---------------------------------------------------------------
-; Toggle Register Value and Repeat
+; PPS: NCO1 -> RD0, CLC1 -> RD1 (PPS1WAY: one unlock only)
 ;---------------------------------------------------------------
-    COMF        REG01,1               ; Complement (negate) REG01 (toggle LED state)
-    BRA         _onoff                ; Repeat the loop (infinite loop)
+    BANKSEL     PPSLOCK
+    MOVLW       0x55
+    MOVWF       PPSLOCK
+    MOVLW       0xAA
+    MOVWF       PPSLOCK
+    BCF         PPSLOCK,0            ; Unlock PPS
+    BANKSEL     RD0PPS
+    MOVLW       NCO1_PPS
+    MOVWF       RD0PPS
+    MOVLW       CLC1_PPS
+    MOVWF       RD1PPS
+    BANKSEL     PPSLOCK
+    MOVLW       0x55
+    MOVWF       PPSLOCK
+    MOVLW       0xAA
+    MOVWF       PPSLOCK
+    BSF         PPSLOCK,0            ; Lock PPS
+
+;---------------------------------------------------------------
+; Main Loop: nothing left for the CPU to do
+;---------------------------------------------------------------
+    BANKSEL     CPUDOZE
+    BSF         CPUDOZE,7            ; IDLEN: SLEEP stops the CPU only
+_sleep:
+    SLEEP
+    BRA         _sleep
 
 ;---------------------------------------------------------------
 ; End of Program
@@ -4,20 +4,20 @@
 ; Program Details:
 ;This assembly program for the PIC18F46K42 toggles two LEDs (RD0 & RB0) when a 
 ;switch (RD1) is pressed. It initializes PORTD and PORTB, configures the switch as 
-;an input, and LEDs as outputs. A software delay loop controls the toggle speed. 
-;The program runs in an infinite loop, waiting for user input to trigger LED toggling
+;an input, and LEDs as outputs. NCO1 clocked from LFINTOSC drives both LEDs
+;through PPS, so the toggle speed is set by BLINK_INC alone and the CPU idles.
 
 ; Inputs:
-;LED0 (RD0) Toggles ON/OFF 
+;BLINK_INC (see nco_blink.py)
 ; Outputs: 
-;Inner_loop   
-;Outer_loop  
+;LED0 (RD0), LED1 (RB0) Toggle ON/OFF
 ; Date: March 13, 2025
 ; File Dependencies / Libraries: None 
 ; Compiler: xc8, 3.0
 ; Author: Eduardo Williams 
 ; Versions:
 ;       V1.0: First Version 
+;       V1.1: NCO1 blinks the LEDs instead of loopDelay
 ; Useful links: 
 ;       Datasheet: https://ww1.microchip.com/downloads/en/DeviceDoc/PIC18(L)F26-27-45-46-47-55-56-57K42-Data-Sheet-40001919G.pdf 
 ;       PIC18F Instruction Sets: https://onlinelibrary.wiley.com/doi/pdf/10.1002/9781119448457.app4 
@@ -31,14 +31,13 @@ PROCESSOR 18F46K42
 ;---------------------
 ; Program Inputs
 ;---------------------
-Inner_loop  equ 10 ;255  ; in decimal
-Outer_loop  equ 10 ;131
+BLINK_INC   equ 135   ; f = 31000 * BLINK_INC / 2^21 -> 1.996 Hz, -0.22% (nco_blink.py)
 
 ;---------------------
 ; Program Constants
 ;---------------------
-REG10   equ     10h   ; Register for inner loop
-REG11   equ     11h   ; Register for outer loop
+NCO_LFINTOSC equ 0x02 ; NCO1CLK: clock from LFINTOSC
+NCO1_PPS     equ 0x27 ; RxyPPS output code for NCO1OUT
 
 ;---------------------
 ; Definitions
@@ -60,28 +59,56 @@ REG11   equ     11h   ; Register for outer loop
 _initialization: 
     RCALL _setupPortD
     RCALL _setupPortB
+    RCALL _setupNCO
+    RCALL _setupPPS
+    BANKSEL  CPUDOZE
+    BSF      CPUDOZE,7  ; IDLEN: SLEEP stops the CPU, NCO1 keeps running
     
 _main:
-    BTG      LED0    ; Toggle LED0
-    BTG      LED1    ; Toggle LED1
-    CALL     loopDelay 
-    BRA      _main   ; Repeat forever
+    SLEEP             ; LED0 and LED1 toggle in hardware
+    BRA      _main    ; Repeat forever
     
 ;---------------------
-; Delay Subroutine
-;---------------------
-loopDelay: 
-    MOVLW    Inner_loop
-    MOVWF    REG10
-    MOVLW    Outer_loop
-    MOVWF    REG11
-_loop1:
-    DECFSZ   REG10,1  ; Decrease inner loop counter
-    GOTO     _loop1
-    MOVLW    Inner_loop  ; Reset inner loop counter
-    MOVWF    REG10
-    DECFSZ   REG11,1  ; Decrease outer loop counter
-    GOTO     _loop1
+; NCO1 Setup
+;---------------------
+_setupNCO:
+    BANKSEL  NCO1CON
+    CLRF     NCO1CON  ; Off while it is set up
+    MOVLW    NCO_LFINTOSC
+    MOVWF    NCO1CLK
+    CLRF     NCO1ACCU ; Clear accumulator
+    CLRF     NCO1ACCH
+    CLRF     NCO1ACCL
+    MOVLW    (BLINK_INC >> 16) & 0xFF
+    MOVWF    NCO1INCU
+    MOVLW    (BLINK_INC >> 8) & 0xFF
+    MOVWF    NCO1INCH
+    MOVLW    BLINK_INC & 0xFF
+    MOVWF    NCO1INCL ; Written last, loads the whole increment
+    MOVLW    0x80
+    MOVWF    NCO1CON  ; EN, fixed duty cycle, active high
+    RETURN
+
+;---------------------
+; PPS Setup: NCO1 -> RD0 and RB0
+;---------------------
+_setupPPS:
+    BANKSEL  PPSLOCK
+    MOVLW    0x55
+    MOVWF    PPSLOCK
+    MOVLW    0xAA
+    MOVWF    PPSLOCK
+    BCF      PPSLOCK,0  ; Unlock PPS
+    BANKSEL  RD0PPS
+    MOVLW    NCO1_PPS
+    MOVWF    RD0PPS
+    MOVWF    RB0PPS
+    BANKSEL  PPSLOCK
+    MOVLW    0x55
+    MOVWF    PPSLOCK
+    MOVLW    0xAA
+    MOVWF    PPSLOCK
+    BSF      PPSLOCK,0  ; Lock PPS (PPS1WAY: for good)
     RETURN
 
 ;---------------------
@@ -1,6 +1,6 @@
 // === CONFIG BITS ===
-#pragma config FEXTOSC = LP
-#pragma config RSTOSC = EXTOSC
+#pragma config FEXTOSC = OFF
+#pragma config RSTOSC = HFINTOSC_1MHZ
 #pragma config CLKOUTEN = OFF, PR1WAY = ON, CSWEN = ON, FCMEN = ON
 #pragma config MCLRE = EXTMCLR, PWRTS = PWRT_OFF, MVECEN = ON
 #pragma config IVT1WAY = ON, LPBOREN = OFF, BOREN = SBORDIS
@@ -13,113 +13,48 @@
 #pragma config CP = OFF
 
 #include <xc.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "adc_filter.h"
+#include "lcd.h"
+#include "fmt_mv.h"
+#include "power.h"
+#include "clock.h"
 
-#define _XTAL_FREQ 4000000
-#define Vref 5
-
-// === LCD Pin Macros ===
-#define RS LATD0
-#define EN LATD1
-#define ldata LATB
-#define LCD_Port TRISB
-#define LCD_Control TRISD
+#define VREF_MV 5000
 
 // === Function Prototypes ===
-void LCD_Init(void);
-void LCD_Command(char);
-void LCD_Char(char);
-void LCD_String(const char *);
-void LCD_String_xy(char, char, const char *);
-void LCD_Clear(void);
-void MSdelay(unsigned int);
 void ADC_Init(void);
 
-int digital;
-float voltage;
+uint16_t digital;
+uint16_t millivolts;
 char data[10];
 
 void main(void)
 {
-    // --- I/O Setup
-    LCD_Port = 0x00;
-    LCD_Control = 0x00;
-    TRISDbits.TRISD0 = 0;
-    TRISDbits.TRISD1 = 0;
-
+    clock_init();   // HFINTOSC 4 MHz
     LCD_Init();
     LCD_Clear();
     ADC_Init();
 
     while (1)
     {
-        ADCON0bits.GO = 1;
-        while (ADCON0bits.GO);  // Wait for conversion
-
-        digital = ((ADRESH << 8) | ADRESL);
-        voltage = (digital * Vref) / 4096.0;
-        sprintf(data, "%.2f V", voltage);
-
-        LCD_Clear();
-        LCD_String_xy(1, 0, "Voltage:");
-        LCD_String_xy(2, 0, data);
-
-        __delay_ms(500);
+        digital = adc_filtered_read(0);  // 16-sample average of RA0
+        millivolts = adc_to_mv(digital, VREF_MV);
+        strcpy(fmt_mv(data, millivolts), " V");
+
+        lcd_frame_clear();
+        lcd_puts_at(1, 0, "Voltage:");
+        lcd_puts_at(2, 0, data);
+        lcd_flush();
+
+        // Sleep between readings; the LCD has to finish first since its
+        // TMR4 stops along with the clock
+        LCD_Wait_Idle();
+        power_sleep_ms(500);
     }
 }
 
-// === LCD FUNCTIONS ===
-void LCD_Init()
-{
-    MSdelay(15);
-    LCD_Command(0x38); // 8-bit mode, 2 lines
-    LCD_Command(0x0C); // Display ON, Cursor OFF
-    LCD_Command(0x06); // Entry mode
-    LCD_Command(0x01); // Clear display
-}
-
-void LCD_Command(char cmd)
-{
-    ldata = cmd;
-    RS = 0;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(3);
-}
-
-void LCD_Char(char dat)
-{
-    ldata = dat;
-    RS = 1;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(1);
-}
-
-void LCD_String(const char *msg)
-{
-    while (*msg) LCD_Char(*msg++);
-}
-
-void LCD_String_xy(char row, char pos, const char *msg)
-{
-    char loc = (row == 1) ? (0x80 | (pos & 0x0F)) : (0xC0 | (pos & 0x0F));
-    LCD_Command(loc);
-    LCD_String(msg);
-}
-
-void LCD_Clear()
-{
-    LCD_Command(0x01);
-}
-
-// === Delay Function ===
-void MSdelay(unsigned int val)
-{
-    for (unsigned int i = 0; i < val; i++)
-        for (unsigned int j = 0; j < 165; j++);
-}
-
 // === ADC INIT ===
 void ADC_Init(void)
 {
@@ -139,4 +74,6 @@ void ADC_Init(void)
     ADPREH = 0x00;
     ADACQL = 0x00;
     ADACQH = 0x00;
+
+    adc_filter_init(4);
 }
@@ -1,7 +1,7 @@
 ;---------------------
 ; Config Bits
 ;---------------------
-CONFIG  FEXTOSC = LP
+CONFIG  FEXTOSC = OFF
 
 ;---------------------
 ; Initialization
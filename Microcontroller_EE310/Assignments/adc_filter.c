@@ -0,0 +1,29 @@
+#include <xc.h>
+#include "adc_filter.h"
+
+void adc_filter_init(uint8_t shift)
+{
+    ADCON2bits.MD = 0b011;              // burst average
+    ADCON2bits.CRS = shift;             // ADFLTR = ADACC >> CRS
+    ADRPT = (uint8_t)(1 << shift);      // conversions per burst
+    ADCON3bits.TMD = 0b111;             // ADTIF after every computation
+    ADCON2bits.ACLR = 1;                // clear ADACC/ADCNT
+    while (ADCON2bits.ACLR);
+}
+
+uint16_t adc_filtered_read(uint8_t channel)
+{
+    ADPCH = channel;
+    ADCON2bits.ACLR = 1;
+    while (ADCON2bits.ACLR);
+
+    ADCON0bits.GO = 1;                  // stays set for the whole burst
+    while (ADCON0bits.GO);
+
+    return adc_filter_result();
+}
+
+uint16_t adc_filter_result(void)
+{
+    return ((uint16_t)ADFLTRH << 8) | ADFLTRL;
+}
@@ -0,0 +1,27 @@
+/* 
+ * File:   adc_filter.h
+ * Filtered 12-bit reads using the K42 ADCC accumulator. Shared by
+ * ADC_Voltage_Reader.c, Lab_12.c and Project2/MCC_UART.c.
+ *
+ * In burst-average mode one GO starts 2^shift back-to-back
+ * conversions; the hardware sums them in ADACC and leaves the average in
+ * ADFLTR, so the CPU only waits for GO to clear and reads one result.
+ */
+
+#ifndef ADC_FILTER_H
+#define	ADC_FILTER_H
+
+#include <stdint.h>
+
+// Switch the ADCC into burst-average mode, averaging 2^shift samples
+// (shift 0..6). Call after the program's own ADC setup (clock, format, ON).
+// ADTIF is raised after every filtered result, for interrupt-driven readers.
+void adc_filter_init(uint8_t shift);
+
+// Select a channel, run one burst and return the averaged 12-bit result.
+uint16_t adc_filtered_read(uint8_t channel);
+
+// Averaged result of the last burst (ADFLTR), for interrupt-driven readers.
+uint16_t adc_filter_result(void);
+
+#endif	/* ADC_FILTER_H */
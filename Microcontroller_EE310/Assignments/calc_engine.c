@@ -0,0 +1,159 @@
+#include "calc_engine.h"
+
+// Checked arithmetic: nonzero if the true result does not fit in int32_t.
+// The compiler builtins when available, plain range tests otherwise
+// (or when CALC_NO_BUILTINS is defined, so a host can test that path).
+#if defined(__has_builtin) && !defined(CALC_NO_BUILTINS)
+#if __has_builtin(__builtin_add_overflow) && __has_builtin(__builtin_mul_overflow)
+#define CALC_HAVE_BUILTINS 1
+#endif
+#endif
+
+#ifdef CALC_HAVE_BUILTINS
+
+static uint8_t Add(int32_t a, int32_t b, int32_t *r) { return __builtin_add_overflow(a, b, r); }
+static uint8_t Sub(int32_t a, int32_t b, int32_t *r) { return __builtin_sub_overflow(a, b, r); }
+static uint8_t Mul(int32_t a, int32_t b, int32_t *r) { return __builtin_mul_overflow(a, b, r); }
+
+#else
+
+static uint8_t Add(int32_t a, int32_t b, int32_t *r)
+{
+    if ((b > 0 && a > INT32_MAX - b) || (b < 0 && a < INT32_MIN - b))
+        return 1;
+    *r = a + b;
+    return 0;
+}
+
+static uint8_t Sub(int32_t a, int32_t b, int32_t *r)
+{
+    if ((b < 0 && a > INT32_MAX + b) || (b > 0 && a < INT32_MIN + b))
+        return 1;
+    *r = a - b;
+    return 0;
+}
+
+static uint8_t Mul(int32_t a, int32_t b, int32_t *r)
+{
+    if (a && b) {
+        if (a > 0) {
+            if (b > 0 ? a > INT32_MAX / b : b < INT32_MIN / a)
+                return 1;
+        } else {
+            if (b > 0 ? a < INT32_MIN / b : b < INT32_MAX / a)
+                return 1;
+        }
+    }
+    *r = a * b;
+    return 0;
+}
+
+#endif
+
+// a * b / CALC_SCALE without forming the full a * b, rounded half away
+// from zero. Both halves of a carry a's sign, so they round the same way.
+static uint8_t Mul_Fixed(int32_t a, int32_t b, int32_t *r)
+{
+    int32_t whole, part, round;
+
+    if (Mul(a / CALC_SCALE, b, &whole))
+        return CALC_OVERFLOW;
+    if (Mul(a % CALC_SCALE, b, &part))
+        return CALC_OVERFLOW;
+    round = part % CALC_SCALE;
+    part /= CALC_SCALE;
+    if (round >= CALC_SCALE / 2)
+        part++;
+    else if (round <= -(CALC_SCALE / 2))
+        part--;
+    if (Add(whole, part, r))
+        return CALC_OVERFLOW;
+    return CALC_OK;
+}
+
+// a * CALC_SCALE / b, rounded half away from zero
+static uint8_t Div_Fixed(int32_t a, int32_t b, int32_t *r)
+{
+    int32_t whole, rem, frac, fracRem, result;
+
+    if (b == 0)
+        return CALC_DIV_ZERO;
+    if (a == INT32_MIN && b == -1)
+        return CALC_OVERFLOW;
+
+    whole = a / b;
+    rem = a % b;                        // |rem| < |b|, same sign as a
+    if (Mul(rem, CALC_SCALE, &frac))
+        return CALC_OVERFLOW;
+    fracRem = frac % b;
+    frac /= b;
+
+    // Round on what is left: |fracRem| >= |b| / 2
+    uint32_t left = fracRem < 0 ? (uint32_t)0 - (uint32_t)fracRem : (uint32_t)fracRem;
+    uint32_t div = b < 0 ? (uint32_t)0 - (uint32_t)b : (uint32_t)b;
+    if (left >= div - left)
+        frac += ((a < 0) != (b < 0)) ? -1 : 1;
+
+    if (Mul(whole, CALC_SCALE, &result) || Add(result, frac, r))
+        return CALC_OVERFLOW;
+    return CALC_OK;
+}
+
+uint8_t calc_apply(char op, int32_t a, int32_t b, int32_t *result)
+{
+    switch (op) {
+    case '+': return Add(a, b, result) ? CALC_OVERFLOW : CALC_OK;
+    case '-': return Sub(a, b, result) ? CALC_OVERFLOW : CALC_OK;
+    case '*': return Mul_Fixed(a, b, result);
+    case '/': return Div_Fixed(a, b, result);
+    default:  *result = b; return CALC_OK;      // no operator: take b
+    }
+}
+
+void calc_init(calc_t *c)
+{
+    c->acc = 0;
+    c->entry = 0;
+    c->digits = 0;
+    c->op = 0;
+    c->status = CALC_OK;
+}
+
+uint8_t calc_digit(calc_t *c, uint8_t digit)
+{
+    int32_t value;
+
+    if (c->status != CALC_OK)
+        return c->status;
+    if (Mul(c->entry, 10, &value) || Add(value, (int32_t)digit * CALC_SCALE, &value))
+        return CALC_OVERFLOW;
+    c->entry = value;
+    c->digits++;
+    return CALC_OK;
+}
+
+static uint8_t Apply_Pending(calc_t *c)
+{
+    if (c->status != CALC_OK)
+        return c->status;
+    if (c->digits) {
+        c->status = calc_apply(c->op, c->acc, c->entry, &c->acc);
+        c->entry = 0;
+        c->digits = 0;
+    }
+    return c->status;
+}
+
+uint8_t calc_operator(calc_t *c, char op)
+{
+    if (Apply_Pending(c) == CALC_OK)
+        c->op = op;
+    return c->status;
+}
+
+uint8_t calc_equals(calc_t *c)
+{
+    if (Apply_Pending(c) == CALC_OK)
+        c->op = 0;
+    return c->status;
+}
@@ -0,0 +1,57 @@
+/* 
+ * File:   calc_engine.h
+ * Calculator core for the keypad calculator: multi-digit operands,
+ * chained operators and two-decimal fixed-point results in 32-bit
+ * integers, with overflow checks instead of silently wrapping. Plain C
+ * with no register access, so it also builds on a host.
+ *
+ * Values are fixed point with CALC_FRAC_DIGITS decimals (3.50 is 350).
+ * Keys map onto calls: digits -> calc_digit(), an operator ->
+ * calc_operator() (which first applies any pending one, so 1+2+3 chains),
+ * '=' -> calc_equals(). The running result is in acc, the operand being
+ * typed in entry.
+ */
+
+#ifndef CALC_ENGINE_H
+#define	CALC_ENGINE_H
+
+#include <stdint.h>
+
+#define CALC_FRAC_DIGITS 2
+#define CALC_SCALE       100     // 10^CALC_FRAC_DIGITS
+
+// Status codes; once an error is set it sticks until calc_init()
+#define CALC_OK          0
+#define CALC_OVERFLOW    1
+#define CALC_DIV_ZERO    2
+
+typedef struct {
+    int32_t acc;        // running result
+    int32_t entry;      // operand being typed
+    uint8_t digits;     // digits typed into entry, 0 = none yet
+    char op;            // pending '+', '-', '*', '/', or 0
+    uint8_t status;
+} calc_t;
+
+void calc_init(calc_t *c);
+
+// Append a decimal digit (0-9) to the entry. CALC_OVERFLOW leaves the
+// entry as it was and does not set the sticky status.
+uint8_t calc_digit(calc_t *c, uint8_t digit);
+
+// Apply the pending operator to acc and entry, then make op pending.
+// Without a new entry op just replaces the pending operator.
+uint8_t calc_operator(calc_t *c, char op);
+
+// Apply the pending operator; acc holds the result.
+uint8_t calc_equals(calc_t *c);
+
+// *result = a op b on fixed-point values. Products and quotients round to
+// the nearest last decimal, halves away from zero.
+// Cost on a PIC18 is set by the 32-bit divisions, which XC8 does in
+// software: '+' and '-' need none; '*' and '/' up to six each (four for
+// the scaling and rounding, one per range-tested multiply). calc_digit()
+// needs one.
+uint8_t calc_apply(char op, int32_t a, int32_t b, int32_t *result);
+
+#endif	/* CALC_ENGINE_H */
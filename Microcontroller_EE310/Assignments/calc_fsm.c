@@ -0,0 +1,118 @@
+#include "calc_fsm.h"
+#include "calc_engine.h"
+#include "display_mux.h"
+
+// === Calculator State Machine ===
+// The state table gives, for each state and key class, the action to run
+// and the state to move to. An action returns ACT_IGNORE to leave the
+// state unchanged (e.g. '#' before a number was typed) and ACT_ERROR to
+// go straight to showing the error.
+#define ACT_DONE       0
+#define ACT_IGNORE     1
+#define ACT_ERROR      2
+
+typedef char (*calcAction)(char key);
+
+typedef struct {
+    calcAction action;
+    uint8_t next;
+} calcTransition;
+
+static calc_t calc;              // operands, pending operation and result
+static uint8_t state = CALC_ST_FIRST;
+
+uint8_t calc_fsm_key_class(char key)
+{
+    if (key >= '0' && key <= '9') return CALC_KEY_DIGIT;
+    if (key >= 'A' && key <= 'D') return CALC_KEY_OPERATION;
+    if (key == '#') return CALC_KEY_EQUALS;
+    return CALC_KEY_CLEAR;
+}
+
+// Calculator operator for an operation key
+static char calcOperator(char key)
+{
+    static const char ops[4] = { '+', '-', '*', '/' };   // A B C D
+    return ops[key - 'A'];
+}
+
+// Adds a typed digit to the current number and shows it; digits that
+// would not fit in the display are ignored
+static char actDigit(char key)
+{
+    if (calc.digits >= DISPLAY_DIGITS) return ACT_IGNORE;
+    if (calc_digit(&calc, (uint8_t)(key - '0')) != CALC_OK) return ACT_IGNORE;
+    display_set_fixed(calc.entry, CALC_FRAC_DIGITS);
+    return ACT_DONE;
+}
+
+// Applies any pending operation (chaining) and shows the running result
+static char actOperation(char key)
+{
+    if (state == CALC_ST_FIRST && !calc.digits) return ACT_IGNORE;
+    if (calc_operator(&calc, calcOperator(key)) != CALC_OK) return ACT_ERROR;
+    display_set_fixed(calc.acc, CALC_FRAC_DIGITS);
+    return ACT_DONE;
+}
+
+// Shows the result; "EEEE" if it overflowed or does not fit the display
+static char actEquals(char key)
+{
+    (void)key;
+    if (!calc.digits) return ACT_IGNORE;
+    if (calc_equals(&calc) != CALC_OK) return ACT_ERROR;
+    if (!display_set_fixed(calc.acc, CALC_FRAC_DIGITS)) return ACT_ERROR;
+    return ACT_DONE;
+}
+
+// Resets the calculator and clears the display
+static char actClear(char key)
+{
+    (void)key;
+    calc_init(&calc);
+    display_set_blink(0);
+    display_clear();
+    return ACT_DONE;
+}
+
+static char actNone(char key)
+{
+    (void)key;
+    return ACT_IGNORE;
+}
+
+static const calcTransition calcTable[CALC_ST_COUNT][CALC_KEY_CLASSES] = {
+    //                    CALC_KEY_DIGIT                CALC_KEY_OPERATION            CALC_KEY_EQUALS                CALC_KEY_CLEAR
+    /* CALC_ST_FIRST  */ {{actDigit, CALC_ST_FIRST},   {actOperation, CALC_ST_NEXT}, {actNone, CALC_ST_FIRST},      {actClear, CALC_ST_FIRST}},
+    /* CALC_ST_NEXT   */ {{actDigit, CALC_ST_NEXT},    {actOperation, CALC_ST_NEXT}, {actEquals, CALC_ST_RESULT},   {actClear, CALC_ST_FIRST}},
+    /* CALC_ST_RESULT */ {{actNone, CALC_ST_RESULT},   {actNone, CALC_ST_RESULT},    {actNone, CALC_ST_RESULT},     {actClear, CALC_ST_FIRST}},
+};
+
+void calc_fsm_init(void)
+{
+    calc_init(&calc);
+    state = CALC_ST_FIRST;
+}
+
+void calc_fsm_step(char key)
+{
+    const calcTransition *t = &calcTable[state][calc_fsm_key_class(key)];
+
+    switch (t->action(key)) {
+        case ACT_DONE:
+            state = t->next;
+            break;
+        case ACT_ERROR:
+            display_set_error();
+            display_set_blink(1);     // blink "EEEE" until '*'
+            state = CALC_ST_RESULT;
+            break;
+        default:
+            break;
+    }
+}
+
+uint8_t calc_fsm_state(void)
+{
+    return state;
+}
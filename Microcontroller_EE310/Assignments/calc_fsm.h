@@ -0,0 +1,40 @@
+/*
+ * File:   calc_fsm.h
+ * Key handling for the keypad calculator (Assigment7_Calculator.c): a
+ * state table that runs one key at a time through calc_engine.c and
+ * draws on the display through display_mux.h. No register access of its
+ * own, so it builds on a host against a display shim.
+ *
+ * Keys: '0'-'9' digits, 'A'-'D' + - * /, '#' equals, anything else
+ * clears. An error (overflow, divide by zero, result too wide) blinks
+ * "EEEE" until the clear key.
+ */
+
+#ifndef CALC_FSM_H
+#define	CALC_FSM_H
+
+#include <stdint.h>
+
+// States
+#define CALC_ST_FIRST   0   // typing the first number
+#define CALC_ST_NEXT    1   // operation chosen, typing the next number
+#define CALC_ST_RESULT  2   // result or error shown, waiting for '*'
+#define CALC_ST_COUNT   3
+
+// Key classes, one column of the state table each
+#define CALC_KEY_DIGIT      0   // '0'-'9'
+#define CALC_KEY_OPERATION  1   // 'A'-'D'
+#define CALC_KEY_EQUALS     2   // '#'
+#define CALC_KEY_CLEAR      3   // '*' (and any other key)
+#define CALC_KEY_CLASSES    4
+
+// Clears the calculator; the display is left alone.
+void calc_fsm_init(void);
+
+// Runs one key through the state table.
+void calc_fsm_step(char key);
+
+uint8_t calc_fsm_state(void);
+uint8_t calc_fsm_key_class(char key);
+
+#endif	/* CALC_FSM_H */
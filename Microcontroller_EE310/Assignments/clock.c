@@ -0,0 +1,14 @@
+#include <xc.h>
+#include "clock.h"
+
+#if FOSC_HZ != 4000000UL
+#error "clock_init() sets OSCFRQ for 4 MHz"
+#endif
+
+void clock_init(void)
+{
+    OSCFRQ = 0x02;                  // HFINTOSC 4 MHz
+    OSCCON1 = 0x60;                 // NOSC HFINTOSC, NDIV 1:1
+    while (!OSCCON3bits.ORDY)       // switch done
+        ;
+}
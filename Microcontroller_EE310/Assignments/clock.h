@@ -0,0 +1,33 @@
+/*
+ * File:   clock.h
+ * The one system clock for the C programs: HFINTOSC at 4 MHz, so FOSC/4
+ * (the timer and instruction clock) is 1 MHz.
+ *
+ * The config words reset onto HFINTOSC (RSTOSC = HFINTOSC_1MHZ, no
+ * crystal) and clock_init(), first thing in main(), switches to 4 MHz.
+ * Every timer period is worked out from FCY_HZ with FCY_COUNTS(), so the
+ * drivers (systick, keypad, lcd, display_mux, melody, PWM) and the delay
+ * calibration (_XTAL_FREQ) change together if FOSC_HZ ever does.
+ *
+ * The assembly labs use the same clock through clock.inc.
+ */
+
+#ifndef CLOCK_H
+#define	CLOCK_H
+
+#define FOSC_HZ     4000000UL
+#define FCY_HZ      (FOSC_HZ / 4)
+
+#ifndef _XTAL_FREQ
+#define _XTAL_FREQ  FOSC_HZ         // for __delay_ms() / __delay_us()
+#endif
+
+// Timer counts for us microseconds of FOSC/4 through a 1:prescale,
+// rounded; us up to 65535.
+#define FCY_COUNTS(us, prescale) \
+    (((FCY_HZ / 1000) * (us) / 1000 + (prescale) / 2) / (prescale))
+
+// HFINTOSC at FOSC_HZ, NDIV 1:1.
+void clock_init(void);
+
+#endif	/* CLOCK_H */
@@ -0,0 +1,139 @@
+#include <xc.h>
+#include "display_mux.h"
+#include "seg_glyphs.h"
+#include "clock.h"
+
+#define DIGIT_MASK  ((uint8_t)((1u << DISPLAY_DIGITS) - 1))
+
+// TMR3 counts FOSC/4; reload for 1 ms per digit
+#define TMR3_RELOAD ((uint16_t)(65536UL - FCY_COUNTS(1000, 1)))
+
+static volatile uint8_t frame[DISPLAY_DIGITS];
+static uint8_t scanDigit = 0;
+
+// Blinking: the ISR blanks the segments for every other half period
+static volatile uint8_t blinkOn = 0;
+static uint16_t blinkMs = 0;
+static uint8_t blinkDark = 0;
+
+void __interrupt(irq(TMR3), base(0x0008)) DISPLAY_ISR(void)
+{
+    TMR3H = TMR3_RELOAD >> 8;
+    TMR3L = TMR3_RELOAD & 0xFF;
+    TMR3IF = 0;
+
+    if (!blinkOn) {
+        blinkDark = 0;
+        blinkMs = 0;
+    } else if (++blinkMs >= DISPLAY_BLINK_MS) {
+        blinkMs = 0;
+        blinkDark ^= 1;
+    }
+
+    LATD &= (uint8_t)~DIGIT_MASK; // blank first so no digit ghosts into the next
+    LATB = blinkDark ? 0x00 : frame[scanDigit];
+    LATD |= (uint8_t)(1u << scanDigit);
+
+    if (++scanDigit >= DISPLAY_DIGITS)
+        scanDigit = 0;
+}
+
+void display_init(void)
+{
+    TRISB = 0x00;
+    ANSELB = 0x00;
+    LATB = 0x00;
+    TRISD &= (uint8_t)~DIGIT_MASK;
+    ANSELD &= (uint8_t)~DIGIT_MASK;
+    LATD &= (uint8_t)~DIGIT_MASK;
+    display_clear();
+
+    // TMR3: FOSC/4, 1:1, 16-bit, reloaded in the ISR
+    T3CLK = 0x01;
+    T3GCON = 0x00;
+    TMR3H = TMR3_RELOAD >> 8;
+    TMR3L = TMR3_RELOAD & 0xFF;
+    TMR3IF = 0;
+    TMR3IE = 1;
+    T3CON = 0x03;               // ON, 16-bit read/write
+
+    INTCON0bits.GIE = 1;
+}
+
+void display_clear(void)
+{
+    for (uint8_t i = 0; i < DISPLAY_DIGITS; i++)
+        frame[i] = seg_glyphs[SEG_GLYPH_BLANK];
+}
+
+void display_set_blink(uint8_t on)
+{
+    blinkOn = on;
+}
+
+void display_set_raw(uint8_t pos, uint8_t pattern)
+{
+    if (pos < DISPLAY_DIGITS)
+        frame[pos] = pattern;
+}
+
+void display_set_error(void)
+{
+    for (uint8_t i = 0; i < DISPLAY_DIGITS; i++)
+        frame[i] = seg_glyphs[SEG_GLYPH_E];
+}
+
+// Digits needed for value with the given decimals, sign included
+static uint8_t Width(int32_t value, uint8_t decimals)
+{
+    uint32_t mag = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+    uint8_t n = 0;
+
+    do {
+        n++;
+        mag /= 10;
+    } while (mag);
+    if (n < decimals + 1)
+        n = decimals + 1;       // "0.5", not ".5"
+    return n + (value < 0);
+}
+
+uint8_t display_set_fixed(int32_t value, uint8_t decimals)
+{
+    uint8_t text[DISPLAY_DIGITS];
+    uint32_t mag;
+    int8_t pos = DISPLAY_DIGITS - 1;
+
+    // Trailing zero decimals go, then whatever decimals do not fit
+    while (decimals && (value % 10 == 0 || Width(value, decimals) > DISPLAY_DIGITS)) {
+        value /= 10;
+        decimals--;
+    }
+    if (Width(value, decimals) > DISPLAY_DIGITS) {
+        display_set_error();
+        return 0;
+    }
+
+    // Digits right to left, the point on the units digit, then sign, blanks
+    mag = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+    for (uint8_t i = 0; mag || i <= decimals; i++) {
+        text[pos] = seg_glyphs[mag % 10];
+        if (decimals && i == decimals)
+            text[pos] |= SEG_DP;
+        pos--;
+        mag /= 10;
+    }
+    if (value < 0)
+        text[pos--] = seg_glyphs[SEG_GLYPH_MINUS];
+    while (pos >= 0)
+        text[pos--] = seg_glyphs[SEG_GLYPH_BLANK];
+
+    for (uint8_t i = 0; i < DISPLAY_DIGITS; i++)
+        frame[i] = text[i];
+    return 1;
+}
+
+uint8_t display_set_number(int32_t value)
+{
+    return display_set_fixed(value, 0);
+}
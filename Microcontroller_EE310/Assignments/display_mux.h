@@ -0,0 +1,50 @@
+/* 
+ * File:   display_mux.h
+ * Time-multiplexed common-cathode 7-segment display: all digits share the
+ * segment lines on PORTB (bit order from seg_glyphs.h, DP on RB0) and each
+ * digit's cathode is switched by RD0, RD1, ... (high = digit on, through
+ * an NPN or logic-level driver). Digit 0 (RD0) is the leftmost.
+ *
+ * The TMR3 interrupt lights one digit per millisecond from a RAM
+ * framebuffer, so with 4 digits each one is refreshed at 250 Hz with a
+ * 1/4 duty cycle. Main code only writes the framebuffer. The ISR is
+ * estimated at about 50 cycles, 5% of the CPU (tests/test_display_mux.c).
+ *
+ * Uses TMR3 and enables global interrupts in display_init().
+ */
+
+#ifndef DISPLAY_MUX_H
+#define	DISPLAY_MUX_H
+
+#include <stdint.h>
+
+#ifndef DISPLAY_DIGITS
+#define DISPLAY_DIGITS 4        // 1-8, enables on RD0..RD(DISPLAY_DIGITS-1)
+#endif
+
+#define DISPLAY_BLINK_MS 500    // on/off half period when blinking
+
+void display_init(void);
+
+// Blank every digit.
+void display_clear(void);
+
+// Blink the whole display (nonzero) or show it steadily (0).
+void display_set_blink(uint8_t on);
+
+// Raw segment pattern for one digit (0 = leftmost).
+void display_set_raw(uint8_t pos, uint8_t pattern);
+
+// Right-aligned decimal with a leading minus sign and no leading zeros.
+// Returns 0 and shows "E" in every digit if the value does not fit.
+uint8_t display_set_number(int32_t value);
+
+// Fixed-point value (value / 10^decimals) with the decimal point lit.
+// Trailing zero decimals are dropped, and so are decimals that do not
+// fit (truncated), before falling back to "E".
+uint8_t display_set_fixed(int32_t value, uint8_t decimals);
+
+// "E" in every digit.
+void display_set_error(void);
+
+#endif	/* DISPLAY_MUX_H */
@@ -0,0 +1,93 @@
+#include "estop.h"
+
+static const melody_step_t *sirenTune;
+static uint16_t sirenMs;
+
+static volatile uint8_t active = 0;
+static volatile uint16_t activeMs = 0;     // emergency time left
+static volatile uint8_t started = 0;
+static volatile uint8_t ended = 0;
+
+static volatile uint8_t relayOn = 0;
+static volatile uint16_t holdMs = 0;       // relay hold time left, 0 = none
+
+static void Relay(uint8_t on)
+{
+    relayOn = on;
+    estop_relay_write(on);
+}
+
+void estop_init(const melody_step_t *siren, uint16_t ms)
+{
+    sirenTune = siren;
+    sirenMs = ms;
+    active = 0;
+    activeMs = 0;
+    started = 0;
+    ended = 0;
+    holdMs = 0;
+    Relay(0);
+}
+
+// Relay first: nothing else here can hold it up
+void estop_trigger(void)
+{
+    Relay(0);
+    holdMs = 0;
+    melody_play(sirenTune, 1);
+    active = 1;
+    started = 1;
+    activeMs = sirenMs;     // (re)start the count
+}
+
+void estop_tick(void)
+{
+    if (holdMs && --holdMs == 0)
+        Relay(0);
+
+    if (active && --activeMs == 0) {
+        melody_stop();
+        active = 0;
+        ended = 1;
+    }
+}
+
+uint8_t estop_active(void)
+{
+    return active;
+}
+
+void estop_relay_set(uint8_t on)
+{
+    holdMs = 0;
+    Relay(on && !active);
+}
+
+void estop_relay_hold(uint16_t ms)
+{
+    if (active || !ms)
+        return;
+    holdMs = ms;
+    Relay(1);
+}
+
+uint8_t estop_relay_on(void)
+{
+    return relayOn;
+}
+
+uint8_t estop_take_started(void)
+{
+    if (!started)
+        return 0;
+    started = 0;
+    return 1;
+}
+
+uint8_t estop_take_ended(void)
+{
+    if (!ended)
+        return 0;
+    ended = 0;
+    return 1;
+}
@@ -0,0 +1,58 @@
+/*
+ * File:   estop.h
+ * Emergency stop and timed relay for the Assignment 8 security system
+ * (Assignment_8.c and Assignment_8/main.c).
+ *
+ * estop_trigger(), called from the stop button's interrupt, drops the
+ * relay at once, starts the siren and (re)starts the emergency countdown.
+ * estop_tick(), called every millisecond from the tick interrupt, ends
+ * the emergency and also times relay holds: estop_relay_hold() switches
+ * the relay on and the tick switches it off again, so nothing waits for
+ * it and the main loop keeps polling. While an emergency is active the
+ * relay stays off.
+ *
+ * The main loop learns what happened from estop_take_started() and
+ * estop_take_ended(), which clear as they are read, and redraws its
+ * screens from them.
+ *
+ * The relay is written through estop_relay_write(), which the program
+ * supplies, and the siren through melody.h, so the module builds on a
+ * host. Call the estop_relay_*() functions from main code with the tick
+ * and stop interrupts held off.
+ */
+
+#ifndef ESTOP_H
+#define	ESTOP_H
+
+#include <stdint.h>
+#include "melody.h"
+
+// Supplied by the program: drive the relay output.
+void estop_relay_write(uint8_t on);
+
+// Siren looped for ms after each stop; relay off, no emergency.
+void estop_init(const melody_step_t *siren, uint16_t ms);
+
+// From the stop button's interrupt.
+void estop_trigger(void);
+
+// Call every millisecond.
+void estop_tick(void);
+
+uint8_t estop_active(void);
+
+// Relay on or off until changed; cancels a hold. Ignored (off) during an
+// emergency.
+void estop_relay_set(uint8_t on);
+
+// Relay on, then off again ms later from the tick. Ignored during an
+// emergency; a stop cancels the hold.
+void estop_relay_hold(uint16_t ms);
+
+uint8_t estop_relay_on(void);
+
+// 1 once after each stop / each end of an emergency.
+uint8_t estop_take_started(void);
+uint8_t estop_take_ended(void);
+
+#endif	/* ESTOP_H */
@@ -0,0 +1,24 @@
+#include "fmt_mv.h"
+
+uint16_t adc_to_mv(uint16_t code, uint16_t vref_mv)
+{
+    return (uint16_t)(((uint32_t)code * vref_mv) >> 12);
+}
+
+// Rounding the truncated millivolts to hundredths gives the same result as
+// rounding the exact value, since the dropped fraction is below 1 mV.
+char *fmt_mv(char *buf, uint16_t mv)
+{
+    uint16_t cv = (uint16_t)((mv + 5u) / 10u);     // centivolts
+    uint8_t volts = (uint8_t)(cv / 100u);
+    uint8_t frac = (uint8_t)(cv % 100u);
+
+    if (volts >= 10)
+        *buf++ = (char)('0' + volts / 10);
+    *buf++ = (char)('0' + volts % 10);
+    *buf++ = '.';
+    *buf++ = (char)('0' + frac / 10);
+    *buf++ = (char)('0' + frac % 10);
+    *buf = '\0';
+    return buf;
+}
@@ -0,0 +1,22 @@
+/* 
+ * File:   fmt_mv.h
+ * Integer-only ADC-to-voltage conversion and formatting, so the ADC
+ * readers need neither the soft-float library nor printf("%f").
+ */
+
+#ifndef FMT_MV_H
+#define	FMT_MV_H
+
+#include <stdint.h>
+
+// 12-bit ADC code to millivolts, rounded down (code * vref_mv / 4096).
+uint16_t adc_to_mv(uint16_t code, uint16_t vref_mv);
+
+// Write mv as volts with two decimals ("3.30"), rounding half up, and
+// return a pointer to the terminating NUL so more text can be appended.
+// Of all 12-bit codes only the exact ties print differently from the old
+// float and sprintf("%.2f") path, one hundredth higher: codes 1024 and
+// 3072 at 3.3 V, 512 and 2560 at 5 V.
+char *fmt_mv(char *buf, uint16_t mv);
+
+#endif	/* FMT_MV_H */
@@ -0,0 +1,159 @@
+# Generates seg_glyphs.h / seg_glyphs.c (C) and seg_glyphs.inc (asm DB
+# lines) from one table of 7-segment glyphs, so the C and assembly
+# programs stop carrying their own copies of the bit patterns.
+#
+# Board wiring, MSB to LSB: E D G F A B C DP (common cathode, 1 = lit).
+#
+#   python gen_seg_glyphs.py
+
+import os
+
+BITS = {"E": 7, "D": 6, "G": 5, "F": 4, "A": 3, "B": 2, "C": 1, "DP": 0}
+
+GLYPHS = [
+    # (name, character, lit segments)
+    ("0", "0", "ABCDEF"),
+    ("1", "1", "BC"),
+    ("2", "2", "ABDEG"),
+    ("3", "3", "ABCDG"),
+    ("4", "4", "BCFG"),
+    ("5", "5", "ACDFG"),
+    ("6", "6", "ACDEFG"),
+    ("7", "7", "ABC"),
+    ("8", "8", "ABCDEFG"),
+    ("9", "9", "ABCFG"),
+    ("A", "A", "ABCEFG"),
+    ("B", "B", "CDEFG"),
+    ("C", "C", "ADEF"),
+    ("D", "D", "BCDEG"),
+    ("E", "E", "ADEFG"),
+    ("F", "F", "AEFG"),
+    ("STAR", "*", "ADG"),
+    ("HASH", "#", "BCEF"),
+    ("MINUS", "-", "G"),
+    ("BLANK", " ", ""),
+]
+
+# Patterns the programs used before the table existed; the generator
+# refuses to write anything that disagrees with them.
+LEGACY = {
+    "0": 0b11011110, "1": 0b00000110, "2": 0b11101100, "3": 0b01101110,
+    "4": 0b00110110, "5": 0b01111010, "6": 0b11111010, "7": 0b00001110,
+    "8": 0b11111110, "9": 0b00111110, "A": 0b10111110, "B": 0b11110010,
+    "C": 0b11011000, "D": 0b11100110, "E": 0b11111000, "F": 0b10111000,
+    "STAR": 0b01101000, "HASH": 0b10010110, "BLANK": 0b00000000,
+}
+
+HEADER = "Generated by gen_seg_glyphs.py -- do not edit."
+
+
+def pattern(segments):
+    value = 0
+    for seg in segments:
+        value |= 1 << BITS[seg]
+    return value
+
+
+def write_if_changed(path, text):
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    with open(path, "w") as f:
+        f.write(text)
+    print("gen_seg_glyphs: wrote %s" % path)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    table = [(name, ch, pattern(segs)) for name, ch, segs in GLYPHS]
+
+    for name, _, value in table:
+        if name in LEGACY and LEGACY[name] != value:
+            raise SystemExit("gen_seg_glyphs: %s is 0b%s, programs use 0b%s"
+                             % (name, format(value, "08b"),
+                                format(LEGACY[name], "08b")))
+
+    # --- C header ---
+    h = [
+        "/* ",
+        " * File:   seg_glyphs.h",
+        " * " + HEADER,
+        " * 7-segment patterns, bit order E D G F A B C DP (MSB to LSB).",
+        " * seg_glyphs[] is indexed by digit value 0-15 or SEG_GLYPH_*.",
+        " */",
+        "",
+        "#ifndef SEG_GLYPHS_H",
+        "#define\tSEG_GLYPHS_H",
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    for i, (name, _, _) in enumerate(table):
+        h.append("#define SEG_GLYPH_%-6s %d" % (name, i))
+    h += [
+        "#define SEG_GLYPH_COUNT  %d" % len(table),
+        "#define SEG_DP           0x01    // decimal point, RB0 on the shared segment port",
+        "",
+        "extern const uint8_t seg_glyphs[SEG_GLYPH_COUNT];",
+        "",
+        "// Pattern for '0'-'9', 'A'-'F', 'a'-'f', '*', '#', '-'; blank otherwise.",
+        "uint8_t seg_glyph_char(char c);",
+        "",
+        "#endif\t/* SEG_GLYPHS_H */",
+        "",
+    ]
+    write_if_changed(os.path.join(here, "seg_glyphs.h"), "\n".join(h))
+
+    # --- C table ---
+    c = [
+        "// " + HEADER,
+        '#include "seg_glyphs.h"',
+        "",
+        "const uint8_t seg_glyphs[SEG_GLYPH_COUNT] = {",
+    ]
+    for name, ch, value in table:
+        c.append("    0b%s,  // %s" % (format(value, "08b"), ch if ch != " " else "blank"))
+    c += [
+        "};",
+        "",
+        "uint8_t seg_glyph_char(char c)",
+        "{",
+        "    if (c >= '0' && c <= '9')",
+        "        return seg_glyphs[c - '0'];",
+        "    if (c >= 'A' && c <= 'F')",
+        "        return seg_glyphs[c - 'A' + 10];",
+        "    if (c >= 'a' && c <= 'f')",
+        "        return seg_glyphs[c - 'a' + 10];",
+        "    if (c == '*')",
+        "        return seg_glyphs[SEG_GLYPH_STAR];",
+        "    if (c == '#')",
+        "        return seg_glyphs[SEG_GLYPH_HASH];",
+        "    if (c == '-')",
+        "        return seg_glyphs[SEG_GLYPH_MINUS];",
+        "    return seg_glyphs[SEG_GLYPH_BLANK];",
+        "}",
+        "",
+    ]
+    write_if_changed(os.path.join(here, "seg_glyphs.c"), "\n".join(c))
+
+    # --- Assembly DB lines ---
+    a = [
+        "; " + HEADER,
+        "; 7-segment patterns, bit order E D G F A B C DP (MSB to LSB).",
+        "; Include right after the table label; entry n is the pattern for",
+        "; digit n (0-F), followed by the symbols below.",
+        "",
+    ]
+    for i, (name, _, _) in enumerate(table):
+        if i >= 16:
+            a.append("SEG_GLYPH_%-6s EQU %d" % (name, i))
+    a.append("")
+    for name, ch, value in table:
+        a.append("    DB  0b%s  ; %s" % (format(value, "08b"), ch if ch != " " else "blank"))
+    a.append("")
+    write_if_changed(os.path.join(here, "seg_glyphs.inc"), "\n".join(a))
+
+
+if __name__ == "__main__":
+    main()
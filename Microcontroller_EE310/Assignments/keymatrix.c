@@ -0,0 +1,29 @@
+#include "keymatrix.h"
+
+uint8_t keymatrix_ghosted(uint16_t map)
+{
+    for (uint8_t a = 0; a < 3; a++) {
+        uint8_t rowA = KEYMATRIX_ROW(map, a);
+        if (!(rowA & (rowA - 1)))
+            continue;           // fewer than two keys: cannot close a rectangle
+        for (uint8_t b = a + 1; b < 4; b++) {
+            uint8_t shared = rowA & KEYMATRIX_ROW(map, b);
+            if (shared & (shared - 1))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+uint8_t keymatrix_first(uint16_t map)
+{
+    uint8_t index = 0;
+
+    if (!map)
+        return 16;
+    while (!(map & 1)) {
+        map >>= 1;
+        index++;
+    }
+    return index;
+}
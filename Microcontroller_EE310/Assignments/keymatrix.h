@@ -0,0 +1,33 @@
+/* 
+ * File:   keymatrix.h
+ * Bitmap helpers for a 4x4 key matrix without diodes. Plain C with no
+ * register access, so the same code runs on the PIC and on a host.
+ *
+ * A scan is a 16-bit map with bit (row * 4 + col) set for each closed
+ * key. Three keys on three corners of a rectangle also connect the fourth
+ * corner, so a scan in which two rows share two or more columns cannot be
+ * told apart from a real four-key chord; such scans are flagged as
+ * ghosted and should be thrown away rather than reported.
+ */
+
+#ifndef KEYMATRIX_H
+#define	KEYMATRIX_H
+
+#include <stdint.h>
+
+#define KEYMATRIX_BIT(row, col)  ((uint16_t)1 << ((row) * 4 + (col)))
+
+// Column bits (0-3) of one row of a scan.
+#define KEYMATRIX_ROW(map, row)  ((uint8_t)((map) >> ((row) * 4)) & 0x0F)
+
+// Nonzero if the scan may contain phantom keys.
+uint8_t keymatrix_ghosted(uint16_t map);
+
+// Keys that went down / came up between two accepted scans.
+#define KEYMATRIX_PRESSED(prev, now)   ((uint16_t)(~(prev) & (now)))
+#define KEYMATRIX_RELEASED(prev, now)  ((uint16_t)((prev) & ~(now)))
+
+// Index (row * 4 + col) of the lowest set bit, 16 if map is 0.
+uint8_t keymatrix_first(uint16_t map);
+
+#endif	/* KEYMATRIX_H */
@@ -0,0 +1,181 @@
+#include <xc.h>
+#include "keypad.h"
+#include "keymatrix.h"
+#include "clock.h"
+
+#define KEYPAD_COLS_MASK  0xF0  // RC4-RC7
+#define KEYPAD_DEBOUNCE   1     // repeat scans (5 ms apart) before a change counts
+
+static const char *keys;
+
+// === Event Queue ===
+// The TMR6 ISR writes head, main code writes tail.
+static uint8_t queue[KEYPAD_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueTail = 0;
+
+// === Debounce State ===
+// Bitmaps of (row * 4 + col): keys last reported down, and the last scan.
+static volatile uint16_t stableMap = 0;
+static uint16_t lastScan = 0;
+static uint8_t sameCount = 0;
+
+static void Queue_Event(uint8_t ev)
+{
+    uint8_t head = queueHead;
+
+    if ((uint8_t)(head - queueTail) >= KEYPAD_QUEUE_SIZE)
+        return;                 // full: drop, the reader is far behind
+    queue[head & (KEYPAD_QUEUE_SIZE - 1)] = ev;
+    queueHead = head + 1;
+}
+
+// Drive one row low at a time and collect every closed key. The rows are
+// open-drain, so the rows not being scanned float instead of fighting the
+// driven one when two keys share a column.
+static uint16_t Scan(void)
+{
+    uint16_t map = 0;
+
+    for (uint8_t row = 0; row < 4; row++)
+    {
+        LATA = (LATA & 0xF0) | (uint8_t)(~(1u << row) & 0x0F);
+        __delay_us(10);         // let the pull-ups recharge the columns
+        uint8_t cols = (uint8_t)(~PORTC & KEYPAD_COLS_MASK) >> 4;
+        map |= (uint16_t)cols << (row * 4);
+    }
+    LATA &= 0xF0;               // all rows low again
+    return map;
+}
+
+// Queue one event per key in map, lowest index first.
+static void Queue_Keys(uint16_t map, uint8_t flags)
+{
+    for (uint8_t i = 0; map; i++, map >>= 1)
+        if (map & 1)
+            Queue_Event((uint8_t)keys[i] | flags);
+}
+
+// Back to sleep: rows low, column IOC armed, tick stopped. A key that
+// went down after the last scan gave no edge, so keep ticking for it.
+static void Arm_IOC(void)
+{
+    IOCCF &= ~KEYPAD_COLS_MASK;
+    IOCCN |= KEYPAD_COLS_MASK;
+    if ((PORTC & KEYPAD_COLS_MASK) != KEYPAD_COLS_MASK) {
+        IOCCN &= ~KEYPAD_COLS_MASK;
+        TMR6IE = 1;
+        T6CONbits.ON = 1;
+        return;
+    }
+    TMR6IE = 0;
+    T6CONbits.ON = 0;
+}
+
+void keypad_ioc_isr(void)
+{
+    uint8_t flags = IOCCF & KEYPAD_COLS_MASK;
+
+    if (!flags)
+        return;
+    IOCCF ^= flags;             // clear only what was seen
+
+    // Columns stay quiet until the scan tick has seen everything released
+    IOCCN &= ~KEYPAD_COLS_MASK;
+    lastScan = 0;
+    sameCount = 0;
+    T6TMR = 0;
+    TMR6IF = 0;
+    TMR6IE = 1;
+    T6CONbits.ON = 1;
+}
+
+void __interrupt(irq(TMR6), base(0x0008)) KEYPAD_ISR(void)
+{
+    TMR6IF = 0;
+
+    uint16_t map = Scan();
+    if (keymatrix_ghosted(map))
+        return;                 // can't trust it: wait for a cleaner scan
+    if (map != lastScan) {
+        lastScan = map;
+        sameCount = 0;
+        return;
+    }
+    if (sameCount < KEYPAD_DEBOUNCE)
+        sameCount++;
+    if (sameCount < KEYPAD_DEBOUNCE)
+        return;
+
+    uint16_t prev = stableMap;
+    if (map != prev) {
+        Queue_Keys(KEYMATRIX_RELEASED(prev, map), KEYPAD_EV_UP);
+        Queue_Keys(KEYMATRIX_PRESSED(prev, map), 0);
+        stableMap = map;
+    }
+    if (!map)
+        Arm_IOC();
+}
+
+void keypad_init(const char keymap[16])
+{
+    keys = keymap;
+
+    // Rows RA0-RA3 driven low, columns RC4-RC7 inputs with pull-ups
+    ANSELA &= 0xF0;
+    TRISA &= 0xF0;
+    ODCONA |= 0x0F;
+    LATA &= 0xF0;
+    ANSELC &= ~KEYPAD_COLS_MASK;
+    TRISC |= KEYPAD_COLS_MASK;
+    WPUC |= KEYPAD_COLS_MASK;
+
+    // TMR6: FOSC/4, 1:32, 5 ms scan tick, only on while a key is down
+    T6CLKCON = 0x01;
+    T6HLT = 0x00;
+    T6RST = 0x00;
+    T6PR = FCY_COUNTS(5000, 32) - 1;
+    T6TMR = 0x00;
+    TMR6IF = 0;
+    TMR6IE = 0;
+    T6CON = 0x50;
+
+    // Falling edge on any column starts a scan
+    IOCCP &= ~KEYPAD_COLS_MASK;
+    Arm_IOC();
+    PIE0bits.IOCIE = 1;
+
+    INTCON0bits.GIE = 1;
+}
+
+uint8_t keypad_get_event(void)
+{
+    uint8_t tail = queueTail;
+
+    if (tail == queueHead)
+        return KEYPAD_NONE;
+    uint8_t ev = queue[tail & (KEYPAD_QUEUE_SIZE - 1)];
+    queueTail = tail + 1;
+    return ev;
+}
+
+char keypad_get_key(void)
+{
+    uint8_t ev;
+
+    while ((ev = keypad_get_event()) != KEYPAD_NONE)
+        if (!(ev & KEYPAD_EV_UP))
+            return (char)ev;
+    return 0;
+}
+
+uint16_t keypad_held(void)
+{
+    uint16_t map;
+    uint8_t gie = INTCON0bits.GIE;
+
+    INTCON0bits.GIE = 0;        // 16-bit read, keep the tick out
+    map = stableMap;
+    INTCON0bits.GIE = gie;
+    return map;
+}
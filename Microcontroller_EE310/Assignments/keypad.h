@@ -0,0 +1,46 @@
+/* 
+ * File:   keypad.h
+ * Interrupt-driven 4x4 matrix keypad: rows RA0-RA3 (open-drain), columns
+ * RC4-RC7 (inputs with weak pull-ups).
+ *
+ * While idle all rows are held low and the columns wait on a falling-edge
+ * interrupt-on-change, so nothing runs until a key goes down. The IOC then
+ * hands over to a 5 ms TMR6 tick that scans the whole matrix into a 16-bit
+ * map once per tick and debounces it; every key that went down or came up
+ * becomes an event in a small queue that the program reads whenever it
+ * likes. Holding one key while pressing the next (rollover) reports both,
+ * and scans that could contain ghost keys are discarded (keymatrix.h).
+ * After the last key is released the timer stops and the keypad goes back
+ * to waiting on IOC.
+ *
+ * Uses TMR6 and IOC on RC4-RC7. IOC has a single vector, so the program's
+ * IOC (or default) interrupt handler must call keypad_ioc_isr().
+ */
+
+#ifndef KEYPAD_H
+#define	KEYPAD_H
+
+#include <stdint.h>
+
+#define KEYPAD_NONE     0       // no event queued
+#define KEYPAD_EV_UP    0x80    // or-ed into the key for a release event
+#define KEYPAD_QUEUE_SIZE 8     // queued events, power of two
+
+// keymap[row * 4 + col] is the character reported for each key.
+// Configures the pins, TMR6 and IOC; enables global interrupts.
+void keypad_init(const char keymap[16]);
+
+// Call from the program's IOC interrupt; only touches IOCCF4-IOCCF7.
+void keypad_ioc_isr(void);
+
+// Next queued event: a key character, or-ed with KEYPAD_EV_UP on
+// release, or KEYPAD_NONE if the queue is empty.
+uint8_t keypad_get_event(void);
+
+// Next key-down character (release events are skipped), 0 if none.
+char keypad_get_key(void);
+
+// Debounced map of keys held right now, bit (row * 4 + col).
+uint16_t keypad_held(void);
+
+#endif	/* KEYPAD_H */
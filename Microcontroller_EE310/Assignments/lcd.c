@@ -0,0 +1,239 @@
+#include <xc.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include "lcd.h"
+#include "clock.h"
+
+// === LCD Connections ===
+#define RS LATD0
+#define EN LATD1
+#define ldata LATB
+
+// Ticks of 100 us to hold after clear/home (1.52 ms on the datasheet)
+#define LCD_SLOW_TICKS 16
+
+// === Command FIFO ===
+// Main code writes head, the TMR4 ISR writes tail; 8-bit indices so each
+// side's update is a single byte write. A full FIFO never blocks: the byte
+// is dropped and counted, so no caller can wait on the ISR that drains it.
+static uint8_t fifoData[LCD_FIFO_SIZE];
+static uint8_t fifoRS[LCD_FIFO_SIZE];
+static volatile uint8_t fifoHead = 0;
+static volatile uint8_t fifoTail = 0;
+static volatile uint8_t holdTicks = 0;
+uint16_t lcd_dropped = 0;
+
+// === Shadow Frames ===
+// glass mirrors what the display shows, frame is what the program drew.
+// cursor is the DDRAM column the display will write next (0xFF = unknown).
+static char glass[LCD_ROWS][LCD_COLS];
+static char frame[LCD_ROWS][LCD_COLS];
+static uint8_t cursorRow = 0;
+static uint8_t cursorCol = 0xFF;
+
+static void Fill(char buf[LCD_ROWS][LCD_COLS], char ch)
+{
+    for (uint8_t r = 0; r < LCD_ROWS; r++)
+        for (uint8_t c = 0; c < LCD_COLS; c++)
+            buf[r][c] = ch;
+}
+
+static void LCD_Write_Now(uint8_t value, uint8_t rs)
+{
+    ldata = value;
+    RS = rs;
+    EN = 1; NOP(); EN = 0;
+}
+
+#ifdef LCD_RW
+static uint8_t LCD_Busy(void)
+{
+    uint8_t busy;
+
+    TRISBbits.TRISB7 = 1;
+    RS = 0;
+    LCD_RW = 1;
+    EN = 1; NOP();
+    busy = PORTBbits.RB7;
+    EN = 0;
+    LCD_RW = 0;
+    TRISBbits.TRISB7 = 0;
+    return busy;
+}
+#endif
+
+static uint8_t LCD_Free(void)
+{
+    return (uint8_t)(LCD_FIFO_SIZE - (uint8_t)(fifoHead - fifoTail));
+}
+
+// Returns 0 when the FIFO is full; the caller counts the drop
+static uint8_t LCD_Queue(uint8_t value, uint8_t rs)
+{
+    uint8_t head = fifoHead;
+
+    if ((uint8_t)(head - fifoTail) >= LCD_FIFO_SIZE)
+        return 0;
+
+    fifoData[head & (LCD_FIFO_SIZE - 1)] = value;
+    fifoRS[head & (LCD_FIFO_SIZE - 1)] = rs;
+    fifoHead = head + 1;
+    TMR4IE = 1;
+    return 1;
+}
+
+void __interrupt(irq(TMR4), base(0x0008)) LCD_ISR(void)
+{
+    TMR4IF = 0;
+
+#ifdef LCD_RW
+    if (LCD_Busy())
+        return;
+#else
+    if (holdTicks) {
+        holdTicks--;
+        return;
+    }
+#endif
+
+    uint8_t tail = fifoTail;
+    if (tail == fifoHead) {
+        TMR4IE = 0;             // idle until the next LCD_Queue()
+        return;
+    }
+
+    uint8_t value = fifoData[tail & (LCD_FIFO_SIZE - 1)];
+    uint8_t rs = fifoRS[tail & (LCD_FIFO_SIZE - 1)];
+    fifoTail = tail + 1;
+
+    LCD_Write_Now(value, rs);
+#ifndef LCD_RW
+    if (!rs && value < 0x04)    // clear display / return home
+        holdTicks = LCD_SLOW_TICKS;
+#endif
+}
+
+void LCD_Init(void)
+{
+    TRISB = 0x00;
+    TRISDbits.TRISD0 = 0;
+    TRISDbits.TRISD1 = 0;
+
+    // Power-up sequence is written directly, before the ISR takes over
+    __delay_ms(20);
+    LCD_Write_Now(0x38, 0); __delay_ms(5);  // 8-bit, 2 lines, 5x8 dots
+    LCD_Write_Now(0x0C, 0); __delay_ms(1);  // display on, cursor off
+    LCD_Write_Now(0x06, 0); __delay_ms(1);  // entry mode: increment
+    LCD_Write_Now(0x01, 0); __delay_ms(2);  // clear
+    Fill(glass, ' ');
+    Fill(frame, ' ');
+    cursorCol = 0xFF;
+
+    // TMR4: FOSC/4, 1:1, 100 us tick, interrupt only while busy
+    T4CLKCON = 0x01;
+    T4HLT = 0x00;
+    T4RST = 0x00;
+    T4PR = FCY_COUNTS(100, 1) - 1;
+    T4TMR = 0x00;
+    TMR4IF = 0;
+    TMR4IE = 0;
+    T4CON = 0x80;
+
+    INTCON0bits.GIE = 1;
+}
+
+void LCD_Command(char cmd)
+{
+    if (!LCD_Queue((uint8_t)cmd, 0))
+        lcd_dropped++;
+}
+
+void LCD_Char(char dat)
+{
+    if (!LCD_Queue((uint8_t)dat, 1))
+        lcd_dropped++;
+}
+
+void LCD_String(const char *msg)
+{
+    while (*msg) LCD_Char(*msg++);
+}
+
+void LCD_String_xy(char row, char pos, const char *msg)
+{
+    uint8_t r = (row == 1) ? 0 : 1;
+    uint8_t c = pos & 0x0F;
+    char loc = (row == 1) ? (0x80 | c) : (0xC0 | c);
+
+    LCD_Command(loc);
+
+    // Keep the shadow in step so a later lcd_flush() does not resend it.
+    // After a drop the rest is not sent and is marked unknown, so
+    // lcd_flush() redraws it.
+    for (; *msg && LCD_Queue((uint8_t)*msg, 1); msg++, c++)
+        if (c < LCD_COLS) glass[r][c] = *msg;
+    for (; *msg; msg++, c++) {
+        if (c < LCD_COLS) glass[r][c] = 0;
+        lcd_dropped++;
+    }
+    cursorCol = 0xFF;
+}
+
+void LCD_Clear(void)
+{
+    if (LCD_Queue(0x01, 0)) {
+        Fill(glass, ' ');
+    } else {
+        Fill(glass, 0);         // unknown: lcd_flush() redraws everything
+        lcd_dropped++;
+    }
+    cursorCol = 0xFF;
+}
+
+void LCD_Wait_Idle(void)
+{
+    while (fifoTail != fifoHead || holdTicks);
+}
+
+// === Frame API ===
+void lcd_frame_clear(void)
+{
+    Fill(frame, ' ');
+}
+
+void lcd_puts_at(char row, char col, const char *text)
+{
+    uint8_t r = (row == 1) ? 0 : 1;
+    uint8_t c = (uint8_t)col;
+
+    while (*text && c < LCD_COLS) frame[r][c++] = *text++;
+}
+
+void lcd_printf_at(char row, char col, const char *fmt, ...)
+{
+    char buf[LCD_COLS + 1];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    lcd_puts_at(row, col, buf);
+}
+
+void lcd_flush(void)
+{
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            if (frame[r][c] == glass[r][c])
+                continue;
+            if (LCD_Free() < 2)
+                return;         // the rest goes out on the next flush
+            if (cursorRow != r || cursorCol != c)
+                LCD_Command((char)((r ? 0xC0 : 0x80) | c));
+            LCD_Char(frame[r][c]);
+            glass[r][c] = frame[r][c];
+            cursorRow = r;
+            cursorCol = c + 1;
+        }
+    }
+}
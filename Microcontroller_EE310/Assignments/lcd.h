@@ -0,0 +1,54 @@
+/* 
+ * File:   lcd.h
+ * Shared HD44780 16x2 driver (8-bit bus on PORTB, RS = RD0, EN = RD1).
+ *
+ * LCD_Command/LCD_Char/LCD_String_xy only queue bytes and return; the
+ * TMR4 interrupt writes one byte per 100 us tick and waits out the long
+ * clear/home commands, so no caller spends time in delay loops.
+ * Define LCD_RW (e.g. LATD2) to poll the busy flag instead of using the
+ * fixed timing.
+ *
+ * Nothing here waits for room in the FIFO, so no call can hang in an ISR.
+ * The byte API drops what does not fit and counts it in lcd_dropped; keep
+ * each burst under LCD_FIFO_SIZE bytes or call LCD_Wait_Idle() (main code
+ * only) between bursts. lcd_flush() stops when the FIFO is full and sends
+ * the rest on the next call. Queue from one context only.
+ *
+ * Frame API: lcd_printf_at()/lcd_puts_at() draw into a 2x16 RAM frame and
+ * lcd_flush() sends only the characters that differ from what is already
+ * on the display, plus a cursor move wherever the changes are not
+ * contiguous. Redrawing a whole screen every cycle costs nothing when it
+ * has not changed, and nothing flickers.
+ *
+ * Uses TMR4 and enables global interrupts in LCD_Init().
+ */
+
+#ifndef LCD_H
+#define	LCD_H
+
+#include <stdint.h>
+
+#define LCD_FIFO_SIZE 64    // queued bytes, power of two
+#define LCD_ROWS      2
+#define LCD_COLS      16
+
+void LCD_Init(void);
+void LCD_Command(char);
+void LCD_Char(char);
+void LCD_String(const char *);
+void LCD_String_xy(char row, char pos, const char *);
+void LCD_Clear(void);
+
+// Block until every queued byte has reached the display. Main code only.
+void LCD_Wait_Idle(void);
+
+// Bytes dropped because the FIFO was full
+extern uint16_t lcd_dropped;
+
+// === Frame API (rows 1-2, columns 0-15, text clipped at the edge) ===
+void lcd_frame_clear(void);
+void lcd_puts_at(char row, char col, const char *text);
+void lcd_printf_at(char row, char col, const char *fmt, ...);
+void lcd_flush(void);
+
+#endif	/* LCD_H */
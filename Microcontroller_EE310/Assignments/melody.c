@@ -0,0 +1,76 @@
+#include <stddef.h>
+#include "melody.h"
+#include "tone.h"
+
+// Timer counts per period for a frequency in 0.01 Hz at a prescale of
+// 1 << ps, rounded; the smallest prescale that fits 8 bits keeps the most
+// resolution. The shift is done in unsigned long: with XC8's 16-bit int,
+// 26163 << 7 would overflow.
+#define NOTE_COUNTS(cHz, ps) \
+    ((MELODY_FCY * 100 + ((unsigned long)(cHz) << (ps)) / 2) / ((unsigned long)(cHz) << (ps)))
+#define NOTE_FITS(cHz, ps)   (NOTE_COUNTS(cHz, ps) <= 256)
+#define NOTE_CKPS(cHz) \
+    (NOTE_FITS(cHz, 0) ? 0 : NOTE_FITS(cHz, 1) ? 1 : NOTE_FITS(cHz, 2) ? 2 : \
+     NOTE_FITS(cHz, 3) ? 3 : NOTE_FITS(cHz, 4) ? 4 : NOTE_FITS(cHz, 5) ? 5 : \
+     NOTE_FITS(cHz, 6) ? 6 : 7)
+#define N(cHz) { NOTE_CKPS(cHz), NOTE_COUNTS(cHz, NOTE_CKPS(cHz)) - 1 }
+
+// Equal temperament from A4 = 440 Hz, in 0.01 Hz
+const melody_period_t melody_periods[NOTE_COUNT] = {
+    N(26163), N(27718), N(29366), N(31113), N(32963), N(34923),
+    N(36999), N(39200), N(41530), N(44000), N(46616), N(49388),
+    N(52325), N(55437), N(58733), N(62225), N(65926), N(69846),
+    N(73999), N(78399), N(83061), N(88000), N(93233), N(98777),
+    N(104650), N(110873), N(117466), N(124451), N(131851), N(139691),
+    N(147998), N(156798), N(166122), N(176000), N(186466), N(197553),
+    N(209300), N(221746), N(234932), N(248902), N(263702), N(279383),
+    N(295996), N(313596), N(332244), N(352000), N(372931), N(395107),
+};
+
+static const melody_step_t *first;      // NULL when idle
+static const melody_step_t *step;
+static uint8_t looping;
+static uint16_t msLeft;
+
+static void Start_Step(void)
+{
+    if (!step->ms && looping && step != first)
+        step = first;
+    if (!step->ms) {
+        melody_stop();
+        return;
+    }
+
+    msLeft = step->ms;
+    if (step->note < NOTE_COUNT)
+        tone_start(melody_periods[step->note].ckps, melody_periods[step->note].pr);
+    else
+        tone_stop();
+}
+
+void melody_play(const melody_step_t *steps, uint8_t loop)
+{
+    first = steps;
+    step = steps;
+    looping = loop;
+    Start_Step();
+}
+
+void melody_stop(void)
+{
+    first = NULL;
+    tone_stop();
+}
+
+uint8_t melody_busy(void)
+{
+    return first != NULL;
+}
+
+void melody_tick(void)
+{
+    if (!first || --msLeft)
+        return;
+    step++;
+    Start_Step();
+}
@@ -0,0 +1,61 @@
+/* 
+ * File:   melody.h
+ * Note table and melody sequencer for a PWM buzzer.
+ *
+ * Notes C4..B7 (equal temperament, A4 = 440 Hz) are stored as the timer
+ * prescale and period that give the closest frequency from MELODY_FCY,
+ * all worked out at compile time; every note is within 0.35% of pitch.
+ * A melody is an array of steps ended by MELODY_END. melody_play() starts
+ * it and melody_tick(), called every millisecond from a timer interrupt,
+ * moves through it, so playback never holds up the main loop.
+ *
+ * The sequencer only calls tone_start()/tone_stop() (tone.h) and touches
+ * no registers itself, so it also builds on a host. Call melody_play()
+ * and melody_stop() from the tick's interrupt level, or with it held off.
+ */
+
+#ifndef MELODY_H
+#define	MELODY_H
+
+#include <stdint.h>
+#include "clock.h"
+
+#define MELODY_FCY FCY_HZ       // timer clock: FOSC/4
+
+enum {
+    NOTE_C4, NOTE_CS4, NOTE_D4, NOTE_DS4, NOTE_E4, NOTE_F4,
+    NOTE_FS4, NOTE_G4, NOTE_GS4, NOTE_A4, NOTE_AS4, NOTE_B4,
+    NOTE_C5, NOTE_CS5, NOTE_D5, NOTE_DS5, NOTE_E5, NOTE_F5,
+    NOTE_FS5, NOTE_G5, NOTE_GS5, NOTE_A5, NOTE_AS5, NOTE_B5,
+    NOTE_C6, NOTE_CS6, NOTE_D6, NOTE_DS6, NOTE_E6, NOTE_F6,
+    NOTE_FS6, NOTE_G6, NOTE_GS6, NOTE_A6, NOTE_AS6, NOTE_B6,
+    NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7, NOTE_E7, NOTE_F7,
+    NOTE_FS7, NOTE_G7, NOTE_GS7, NOTE_A7, NOTE_AS7, NOTE_B7,
+    NOTE_COUNT
+};
+#define NOTE_REST 0xFF
+
+typedef struct {
+    uint8_t ckps;           // prescale is 1 << ckps (TxCON.CKPS)
+    uint8_t pr;             // period register: pr + 1 timer counts
+} melody_period_t;
+
+extern const melody_period_t melody_periods[NOTE_COUNT];
+
+typedef struct {
+    uint8_t note;           // NOTE_x or NOTE_REST
+    uint16_t ms;            // duration, 0 ends the melody
+} melody_step_t;
+
+#define MELODY_END { NOTE_REST, 0 }
+
+// Starts a melody from its first step; with loop set it repeats until
+// melody_stop().
+void melody_play(const melody_step_t *steps, uint8_t loop);
+void melody_stop(void);
+uint8_t melody_busy(void);
+
+// Call every millisecond.
+void melody_tick(void);
+
+#endif	/* MELODY_H */
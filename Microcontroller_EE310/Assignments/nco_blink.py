@@ -0,0 +1,78 @@
+# Works out the NCO1 increment for a blink rate, as used by
+# Lab5_LED_Blink.asm and Lab6_Blinking_LED_Delay.asm.
+#
+# In fixed duty cycle mode the output toggles each time the 20-bit
+# accumulator overflows, so one full blink takes two overflows:
+#
+#     f_blink = F_CLK * INC / 2^21        INC = round(f_blink * 2^21 / F_CLK)
+#
+# Rounding INC is off by at most half a step, so the rate error from the
+# register value is at most 0.5 / (INC - 0.5). From a 31 kHz clock INC is
+# small at low rates, so that error grows as the rate falls. Worst case
+# over each band, at 0.01 Hz steps (checked by running with no arguments):
+#
+#     0.1 - 0.2 Hz    5.93%        2 - 5 Hz         0.33%
+#     0.2 - 0.5 Hz    3.47%        5 - 10 Hz        0.137%
+#     0.5 - 1 Hz      1.45%        10 - 100 Hz      0.074%
+#     1 - 2 Hz        0.62%        100 - 1000 Hz    0.0073%
+#
+# Below about 1 Hz this is not small next to LFINTOSC's own tolerance
+# (see the datasheet's oscillator specifications); add the two. The lab
+# rates come out at +0.52% (1 Hz, INC 68) and -0.22% (2 Hz, INC 135).
+#
+#   python3 nco_blink.py 1 2.5       increments for 1 Hz and 2.5 Hz
+#   python3 nco_blink.py             checks every rate from 0.1 Hz to 1 kHz
+
+import sys
+
+F_CLK = 31000                   # LFINTOSC, Hz
+ACC_BITS = 20
+
+
+def increment(hz):
+    inc = round(hz * 2 ** (ACC_BITS + 1) / F_CLK)
+    if not 1 <= inc < 2 ** ACC_BITS:
+        raise ValueError("%g Hz is out of range for a %d Hz clock" % (hz, F_CLK))
+    return inc
+
+
+def actual(inc):
+    return F_CLK * inc / 2 ** (ACC_BITS + 1)
+
+
+# (low Hz, high Hz, worst rounding error in %) as documented above
+BANDS = [
+    (0.1, 0.2, 5.93), (0.2, 0.5, 3.47), (0.5, 1, 1.45), (1, 2, 0.62),
+    (2, 5, 0.33), (5, 10, 0.137), (10, 100, 0.074), (100, 1000, 0.0073),
+]
+
+
+def check():
+    for lo, hi, documented in BANDS:
+        worst = 0.0
+        for centi in range(round(lo * 100), round(hi * 100) + 1):
+            hz = centi / 100
+            inc = increment(hz)
+            err = abs(actual(inc) / hz - 1)
+            assert err <= 0.5 / (inc - 0.5) + 1e-12, (hz, inc, err)
+            worst = max(worst, err)
+        # The documented figure is the worst case, rounded
+        assert abs(worst * 100 - documented) <= documented * 0.02, (lo, hi, worst)
+        print("%g - %g Hz: worst error %.3f%%" % (lo, hi, worst * 100))
+    print("0.1 Hz .. 1 kHz: all within 0.5 / (INC - 0.5) and the documented bands")
+
+
+def main():
+    if len(sys.argv) == 1:
+        check()
+        return
+    for arg in sys.argv[1:]:
+        hz = float(arg)
+        inc = increment(hz)
+        print("%g Hz: INC = %d (NCO1INCU 0x%02X, INCH 0x%02X, INCL 0x%02X) -> %.4f Hz, %+.3f%%"
+              % (hz, inc, inc >> 16, (inc >> 8) & 0xFF, inc & 0xFF,
+                 actual(inc), (actual(inc) / hz - 1) * 100))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,73 @@
+#include <xc.h>
+#include "power.h"
+
+#define LFINTOSC_PER_MS 31      // 31 kHz LFINTOSC counts per millisecond
+
+static volatile uint8_t alarmDone = 0;
+
+void __interrupt(irq(TMR1), base(0x0008)) POWER_ISR(void)
+{
+    TMR1IF = 0;
+    T1CONbits.ON = 0;
+    alarmDone = 1;
+}
+
+void power_idle(void)
+{
+    CPUDOZEbits.IDLEN = 1;
+    SLEEP();
+    NOP();
+}
+
+void power_sleep(void)
+{
+    CPUDOZEbits.IDLEN = 0;
+    VREGCONbits.VREGPM = 1;     // low-power regulator while asleep
+    SLEEP();
+    NOP();
+}
+
+void power_doze(uint8_t ratio)
+{
+    // DOZEN, ROI (full speed in interrupts), DOE (doze again on return)
+    CPUDOZE = 0x70 | (ratio & 0x07);
+}
+
+void power_doze_off(void)
+{
+    CPUDOZE = 0x00;
+}
+
+void power_sleep_ms(uint16_t ms)
+{
+    uint32_t ticks = (uint32_t)ms * LFINTOSC_PER_MS;
+
+    // TMR1: LFINTOSC, 16-bit, not synchronized so it counts during sleep
+    T1CLK = 0x04;
+    T1GCON = 0x00;
+    TMR1IE = 1;
+    INTCON0bits.GIE = 1;
+
+    while (ticks) {
+        uint16_t chunk = ticks > 0xFFFF ? 0xFFFF : (uint16_t)ticks;
+        uint16_t start = (uint16_t)(0u - chunk);    // overflow after chunk counts
+        ticks -= chunk;
+
+        T1CON = 0x00;
+        TMR1H = start >> 8;
+        TMR1L = start & 0xFF;
+        alarmDone = 0;
+        TMR1IF = 0;
+        T1CON = 0x07;           // ON, RD16, SYNC off
+
+        // GIE is off across the test and SLEEP, so an alarm that fires in
+        // between leaves TMR1IF set and SLEEP returns at once
+        while (!alarmDone) {
+            INTCON0bits.GIE = 0;
+            if (!alarmDone)
+                power_sleep();
+            INTCON0bits.GIE = 1;    // service whatever woke us
+        }
+    }
+    TMR1IE = 0;
+}
@@ -0,0 +1,50 @@
+/* 
+ * File:   power.h
+ * Low-power waits for the K42, so event loops stop spinning between
+ * events.
+ *
+ * power_idle()   CPU stops, peripherals keep FOSC: timers on FOSC/4, PWM,
+ *                UART, ADC. Any enabled interrupt wakes it. Use it while a
+ *                FOSC-clocked peripheral must keep running (display refresh,
+ *                PWM, UART traffic).
+ * power_sleep()  FOSC stops as well. Only blocks with their own clock can
+ *                wake it: IOC and INTx pins, TMR1/3/5 on LFINTOSC or SOSC,
+ *                the ADCC on ADCRC (e.g. a threshold interrupt), UART
+ *                wake-up (UxCON1.WUE) and the WDT.
+ * power_doze()   CPU keeps running at 1/2..1/256 of the instruction rate;
+ *                interrupts run at full speed and doze resumes on return.
+ *
+ * The wake interrupt must be enabled (PIExx) and have a handler; with GIE
+ * clear the CPU wakes and carries on after SLEEP without vectoring.
+ *
+ * power_sleep_ms() uses TMR1 on LFINTOSC as the alarm and owns its
+ * interrupt.
+ */
+
+#ifndef POWER_H
+#define	POWER_H
+
+#include <stdint.h>
+
+// Doze ratios for power_doze(): CPU runs 1 of every 2^(n+1) instruction cycles
+#define POWER_DOZE_2    0
+#define POWER_DOZE_4    1
+#define POWER_DOZE_8    2
+#define POWER_DOZE_16   3
+#define POWER_DOZE_32   4
+#define POWER_DOZE_64   5
+#define POWER_DOZE_128  6
+#define POWER_DOZE_256  7
+
+void power_idle(void);
+void power_sleep(void);
+
+void power_doze(uint8_t ratio);
+void power_doze_off(void);
+
+// Sleep for ms milliseconds (LFINTOSC accuracy). Other interrupts are
+// serviced as they arrive and the CPU goes back to sleep until the time is
+// up. Enables global interrupts.
+void power_sleep_ms(uint16_t ms);
+
+#endif	/* POWER_H */
@@ -0,0 +1,110 @@
+#include <stddef.h>
+#include "sched.h"
+
+static sched_task_t *taskList;
+static uint8_t taskCount;
+static uint16_t (*runClock)(void);
+
+// The tick ISR only bumps an 8-bit count (a single-instruction update);
+// the main loop folds it into the 16-bit time, so neither side needs to
+// hold off interrupts.
+static volatile uint8_t tickCount = 0;
+static uint8_t tickSeen = 0;
+static uint16_t now = 0;
+
+static void Catch_Up(void)
+{
+    uint8_t t = tickCount;
+
+    now += (uint8_t)(t - tickSeen);
+    tickSeen = t;
+}
+
+// Counts stick at 65535 rather than wrap back to a clean-looking 0
+static void Overrun(sched_task_t *t)
+{
+    if (t->overruns != 0xFFFF)
+        t->overruns++;
+}
+
+void sched_init(sched_task_t *tasks, uint8_t count, uint16_t (*clock)(void))
+{
+    taskList = tasks;
+    taskCount = count;
+    runClock = clock;
+
+    tickSeen = tickCount;
+    now = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        tasks[i].next = 0;          // periodic tasks start right away
+        tasks[i].release = 0;
+        tasks[i].ready = 0;
+        tasks[i].wcet = 0;
+        tasks[i].overruns = 0;
+    }
+}
+
+void sched_tick(void)
+{
+    tickCount++;
+}
+
+uint16_t sched_now(void)
+{
+    return now;
+}
+
+void sched_ready(sched_task_t *task)
+{
+    if (task->ready)
+        return;
+    task->ready = 1;
+    task->release = now;
+}
+
+uint8_t sched_run(void)
+{
+    sched_task_t *t;
+    uint8_t i;
+
+    Catch_Up();
+
+    // Release every periodic task that is due. Releases missed while the
+    // loop was busy are skipped, each counting as an overrun.
+    for (i = 0, t = taskList; i < taskCount; i++, t++) {
+        if (!t->period || (int16_t)(now - t->next) < 0)
+            continue;
+        if (t->ready)
+            Overrun(t);
+        t->ready = 1;
+        t->release = t->next;
+        t->next += t->period;
+        while ((int16_t)(now - t->next) >= 0) {
+            t->next += t->period;
+            Overrun(t);
+        }
+    }
+
+    for (i = 0, t = taskList; i < taskCount; i++, t++)
+        if (t->ready)
+            break;
+    if (i == taskCount)
+        return 0;
+
+    t->ready = 0;
+    if (runClock) {
+        uint16_t start = runClock();
+        t->run();
+        uint16_t took = runClock() - start;
+        if (took > t->wcet)
+            t->wcet = took;
+    } else {
+        t->run();
+    }
+
+    Catch_Up();
+    uint16_t limit = t->deadline ? t->deadline : t->period;
+    if (limit && (uint16_t)(now - t->release) > limit)
+        Overrun(t);
+    return 1;
+}
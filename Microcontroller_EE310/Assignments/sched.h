@@ -0,0 +1,59 @@
+/* 
+ * File:   sched.h
+ * Cooperative run-to-completion scheduler on a 1 ms tick.
+ *
+ * The program owns the tick interrupt and calls sched_tick() from it;
+ * everything else happens in the main loop through sched_run(), which
+ * starts at most one task per call, lowest table index first. A task must
+ * return quickly: anything that would wait becomes state it checks again
+ * on its next release.
+ *
+ * A task with a period is released every period ms; a period of 0 makes
+ * it event-driven, released only by sched_ready(). Finishing more than
+ * deadline ms after the release (0 = the period) counts an overrun, and
+ * so does a release that comes while the previous one is still waiting.
+ * Run times are measured with the clock given to sched_init(), if any.
+ *
+ * No registers are touched, so it also builds on a host with a simulated
+ * tick.
+ */
+
+#ifndef SCHED_H
+#define	SCHED_H
+
+#include <stdint.h>
+
+typedef struct {
+    void (*run)(void);
+    uint16_t period;        // ms between releases, 0 = event-driven
+    uint16_t deadline;      // ms from release to finish, 0 = period
+
+    // Kept by the scheduler
+    uint16_t next;          // next periodic release
+    uint16_t release;       // time of the pending (or last) release
+    uint8_t ready;
+    uint16_t wcet;          // longest run seen, in clock units
+    uint16_t overruns;      // stops at 65535
+} sched_task_t;
+
+#define SCHED_TASK(fn, period, deadline)  { (fn), (period), (deadline), 0, 0, 0, 0, 0 }
+
+// tasks[] is in priority order. clock returns a free-running 16-bit time
+// for the run-time measurement (e.g. microseconds); NULL skips it.
+void sched_init(sched_task_t *tasks, uint8_t count, uint16_t (*clock)(void));
+
+// Call from the 1 ms tick interrupt. The main loop must get back to
+// sched_run() within 255 ticks or time is lost.
+void sched_tick(void);
+
+// Releases due tasks and runs the first ready one. Returns 0 if nothing
+// was ready, so the caller can idle until the next interrupt.
+uint8_t sched_run(void);
+
+// Releases a task now (main code only).
+void sched_ready(sched_task_t *task);
+
+// Milliseconds since sched_init(), as of the last sched_run().
+uint16_t sched_now(void);
+
+#endif	/* SCHED_H */
@@ -0,0 +1,42 @@
+// Generated by gen_seg_glyphs.py -- do not edit.
+#include "seg_glyphs.h"
+
+const uint8_t seg_glyphs[SEG_GLYPH_COUNT] = {
+    0b11011110,  // 0
+    0b00000110,  // 1
+    0b11101100,  // 2
+    0b01101110,  // 3
+    0b00110110,  // 4
+    0b01111010,  // 5
+    0b11111010,  // 6
+    0b00001110,  // 7
+    0b11111110,  // 8
+    0b00111110,  // 9
+    0b10111110,  // A
+    0b11110010,  // B
+    0b11011000,  // C
+    0b11100110,  // D
+    0b11111000,  // E
+    0b10111000,  // F
+    0b01101000,  // *
+    0b10010110,  // #
+    0b00100000,  // -
+    0b00000000,  // blank
+};
+
+uint8_t seg_glyph_char(char c)
+{
+    if (c >= '0' && c <= '9')
+        return seg_glyphs[c - '0'];
+    if (c >= 'A' && c <= 'F')
+        return seg_glyphs[c - 'A' + 10];
+    if (c >= 'a' && c <= 'f')
+        return seg_glyphs[c - 'a' + 10];
+    if (c == '*')
+        return seg_glyphs[SEG_GLYPH_STAR];
+    if (c == '#')
+        return seg_glyphs[SEG_GLYPH_HASH];
+    if (c == '-')
+        return seg_glyphs[SEG_GLYPH_MINUS];
+    return seg_glyphs[SEG_GLYPH_BLANK];
+}
@@ -0,0 +1,41 @@
+/* 
+ * File:   seg_glyphs.h
+ * Generated by gen_seg_glyphs.py -- do not edit.
+ * 7-segment patterns, bit order E D G F A B C DP (MSB to LSB).
+ * seg_glyphs[] is indexed by digit value 0-15 or SEG_GLYPH_*.
+ */
+
+#ifndef SEG_GLYPHS_H
+#define	SEG_GLYPHS_H
+
+#include <stdint.h>
+
+#define SEG_GLYPH_0      0
+#define SEG_GLYPH_1      1
+#define SEG_GLYPH_2      2
+#define SEG_GLYPH_3      3
+#define SEG_GLYPH_4      4
+#define SEG_GLYPH_5      5
+#define SEG_GLYPH_6      6
+#define SEG_GLYPH_7      7
+#define SEG_GLYPH_8      8
+#define SEG_GLYPH_9      9
+#define SEG_GLYPH_A      10
+#define SEG_GLYPH_B      11
+#define SEG_GLYPH_C      12
+#define SEG_GLYPH_D      13
+#define SEG_GLYPH_E      14
+#define SEG_GLYPH_F      15
+#define SEG_GLYPH_STAR   16
+#define SEG_GLYPH_HASH   17
+#define SEG_GLYPH_MINUS  18
+#define SEG_GLYPH_BLANK  19
+#define SEG_GLYPH_COUNT  20
+#define SEG_DP           0x01    // decimal point, RB0 on the shared segment port
+
+extern const uint8_t seg_glyphs[SEG_GLYPH_COUNT];
+
+// Pattern for '0'-'9', 'A'-'F', 'a'-'f', '*', '#', '-'; blank otherwise.
+uint8_t seg_glyph_char(char c);
+
+#endif	/* SEG_GLYPHS_H */
@@ -0,0 +1,37 @@
+#include <xc.h>
+#include "systick.h"
+#include "clock.h"
+#include "timing.h"
+
+#define TICK_PRESCALE 4             // T0CON1.CKPS 1:4
+#define TICK_COUNTS   FCY_COUNTS(1000, TICK_PRESCALE)
+#define TICK_US_PER_COUNT (1000u / TICK_COUNTS)
+
+void systick_init(void)
+{
+    // TMR0: FOSC/4, 1:4, 8-bit period of 1 ms (250 counts at FCY = 1 MHz)
+    T0CON1 = 0x42;
+    TMR0H = TICK_COUNTS - 1;
+    TMR0L = 0;
+    PIR3bits.TMR0IF = 0;
+    PIE3bits.TMR0IE = 1;
+    T0CON0 = 0x80;
+}
+
+uint16_t systick_us(void)
+{
+    uint16_t ms;
+    uint8_t sub;
+    uint8_t gie = INTCON0bits.GIE;
+
+    INTCON0bits.GIE = 0;
+    sub = TMR0L;
+    ms = millis();
+    if (PIR3bits.TMR0IF)            // rolled over, tick not counted yet
+    {
+        ms++;
+        sub = TMR0L;
+    }
+    INTCON0bits.GIE = gie;
+    return ms * 1000u + sub * TICK_US_PER_COUNT;
+}
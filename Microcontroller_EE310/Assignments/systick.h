@@ -0,0 +1,31 @@
+/* 
+ * File:   systick.h
+ * 1 ms system tick from TMR0, for timing.h and sched.h.
+ *
+ * TMR0 runs from FOSC/4 (clock.h) with a 1:4 prescale and an 8-bit
+ * period worked out from FCY_HZ: 250 counts at FCY = 1 MHz. The program
+ * owns the TMR0 interrupt and calls timing_tick() from it (and
+ * sched_tick(), melody_tick() ... as needed):
+ *
+ *     void __interrupt(irq(TMR0), base(0x0008)) TICK_ISR(void)
+ *     {
+ *         PIR3bits.TMR0IF = 0;
+ *         timing_tick();
+ *     }
+ *
+ * Uses TMR0.
+ */
+
+#ifndef SYSTICK_H
+#define	SYSTICK_H
+
+#include <stdint.h>
+
+// Starts the tick and enables its interrupt (GIE is left to the caller).
+void systick_init(void);
+
+// Microseconds from millis() and TMR0 (4 us steps at FCY = 1 MHz),
+// wrapping at 16 bits; for timing short stretches of code.
+uint16_t systick_us(void);
+
+#endif	/* SYSTICK_H */
@@ -0,0 +1,54 @@
+#include <stddef.h>
+#include "timing.h"
+
+static volatile uint16_t tickMs = 0;
+static void (*yieldFn)(void) = NULL;
+
+void timing_tick(void)
+{
+    tickMs++;
+}
+
+// The tick can land between the two byte reads of a 16-bit count, so read
+// it until two reads agree rather than holding interrupts off.
+uint16_t millis(void)
+{
+    uint16_t a, b;
+
+    do {
+        a = tickMs;
+        b = tickMs;
+    } while (a != b);
+    return a;
+}
+
+uint16_t elapsed_since(uint16_t start)
+{
+    return (uint16_t)(millis() - start);
+}
+
+uint8_t timing_due(uint16_t deadline)
+{
+    return (int16_t)(millis() - deadline) >= 0;
+}
+
+void timing_set_yield(void (*yield)(void))
+{
+    yieldFn = yield;
+}
+
+void delay_until(uint16_t deadline)
+{
+    while (!timing_due(deadline)) {
+        if (yieldFn)
+            yieldFn();
+    }
+}
+
+// The current millisecond is already partly gone, so one more tick is
+// waited for to make the delay at least ms.
+void delay_ms(uint16_t ms)
+{
+    if (ms)
+        delay_until((uint16_t)(millis() + ms + 1));
+}
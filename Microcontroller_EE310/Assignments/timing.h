@@ -0,0 +1,46 @@
+/* 
+ * File:   timing.h
+ * Millisecond time and waits on a 1 ms tick.
+ *
+ * The program calls timing_tick() from its tick interrupt (systick.h sets
+ * up TMR0 for it). millis() wraps every 65.5 s, so times are compared
+ * with elapsed_since() or timing_due(), which stay right across the wrap
+ * for spans up to 32767 ms.
+ *
+ * delay_until() and delay_ms() wait on the tick instead of counting
+ * cycles, so they keep time at any optimization level. While waiting
+ * they call the yield function, if one is set: power_idle() to stop the
+ * CPU until the next interrupt, or a background job that must keep
+ * running. A yield function must not wait itself.
+ *
+ * No registers are touched, so it also builds on a host with a simulated
+ * tick.
+ */
+
+#ifndef TIMING_H
+#define	TIMING_H
+
+#include <stdint.h>
+
+// Call from the 1 ms tick interrupt.
+void timing_tick(void);
+
+// Milliseconds since start-up, wrapping at 16 bits.
+uint16_t millis(void);
+
+uint16_t elapsed_since(uint16_t start);
+
+// 1 once millis() has reached deadline.
+uint8_t timing_due(uint16_t deadline);
+
+// Called over and over while a delay waits; NULL spins.
+void timing_set_yield(void (*yield)(void));
+
+// Waits until millis() reaches deadline; returns at once if it already
+// has. For a steady period: next += period; delay_until(next);
+void delay_until(uint16_t deadline);
+
+// Waits at least ms (at most ms + 1) milliseconds, ms up to 32766.
+void delay_ms(uint16_t ms);
+
+#endif	/* TIMING_H */
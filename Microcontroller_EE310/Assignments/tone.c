@@ -0,0 +1,50 @@
+#include <xc.h>
+#include "tone.h"
+
+void tone_init(void)
+{
+    ANSELDbits.ANSELD7 = 0;
+    TRISDbits.TRISD7 = 0;
+    LATDbits.LATD7 = 0;
+
+    PPSLOCK = 0x55;
+    PPSLOCK = 0xAA;
+    PPSLOCKbits.PPSLOCKED = 0x00; // unlock PPS
+
+    RD7PPS = 0x0A;                // RD7 driven by CCP2
+
+    PPSLOCK = 0x55;
+    PPSLOCK = 0xAA;
+    PPSLOCKbits.PPSLOCKED = 0x01; // lock PPS
+
+    // TMR2: FOSC/4, software control, off until a tone starts
+    T2CLKCON = 0x01;
+    T2HLT = 0x00;
+    T2RST = 0x00;
+    T2CON = 0x00;
+    PIR4bits.TMR2IF = 0;
+
+    // CCP2: PWM, right aligned, on TMR2; enabled per tone
+    CCPTMRS0bits.C2TSEL = 0x1;
+    CCP2CON = 0x0C;
+}
+
+void tone_start(uint8_t ckps, uint8_t pr)
+{
+    // Duty counts FOSC (4 per timer count): half of 4 * (pr + 1)
+    uint16_t duty = 2 * ((uint16_t)pr + 1);
+
+    T2CON = 0x00;
+    T2PR = pr;
+    CCPR2H = duty >> 8;
+    CCPR2L = duty;
+    T2TMR = 0x00;
+    CCP2CONbits.EN = 1;
+    T2CON = 0x80 | (uint8_t)(ckps << 4);    // ON, CKPS, postscale 1:1
+}
+
+void tone_stop(void)
+{
+    CCP2CONbits.EN = 0;           // disabled CCP drives its output low
+    T2CON = 0x00;
+}
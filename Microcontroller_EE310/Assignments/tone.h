@@ -0,0 +1,27 @@
+/* 
+ * File:   tone.h
+ * Square-wave tone on the RD7 buzzer from CCP2 in PWM mode on TMR2.
+ *
+ * The period and prescale come straight from the note table
+ * (melody.h); the duty is kept at 50%. Once a tone is started it runs in
+ * hardware with no CPU time until tone_stop(). tone_init() maps CCP2 to
+ * RD7 through PPS, using the program's one unlock when PPS1WAY is on, so
+ * LATD7 no longer drives the pin.
+ *
+ * Uses TMR2 and CCP2.
+ */
+
+#ifndef TONE_H
+#define	TONE_H
+
+#include <stdint.h>
+
+void tone_init(void);
+
+// Period of (pr + 1) << ckps timer counts from FOSC/4.
+void tone_start(uint8_t ckps, uint8_t pr);
+
+// Output low, timer stopped.
+void tone_stop(void);
+
+#endif	/* TONE_H */
@@ -3,6 +3,9 @@
 #include <Adafruit_SSD1306.h>
 #include <ESPAsyncWebServer.h>
 #include <ESP8266WiFi.h>
+#include "web_assets.h"   // generated from web/ by embed_assets.py
+#include "serial_parser.h"
+#include "joy_protocol.h"
 
 // === OLED Setup ===
 #define SCREEN_WIDTH 128
@@ -11,16 +14,47 @@ Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
 // === WebServer Setup ===
 AsyncWebServer server(80);
-
-String latestJoystick = "WAIT";
-String latestButton = "WAIT";
+AsyncEventSource events("/events");  // pushes each parsed line to the browser
+
+LineParser parser;
+jp_decoder_t frames;
+bool binaryLink = false;         // PIC has answered HELLO with binary frames
+unsigned long lastHello = 0;
+SerialEvent latestJoystick = EV_NONE;
+SerialEvent latestButton = EV_NONE;
+
+// A redraw sends the whole 1 KB frame over I2C (tens of ms) and holds up
+// every event behind it, so it waits until the serial input is drained and
+// runs at most once per OLED_MIN_MS.
+#define OLED_MIN_MS 200
+bool oledDirty = false;
+unsigned long lastDraw = 0;
 
 void notFound(AsyncWebServerRequest *request) {
   request->send(404, "text/plain", "Not found");
 }
 
+// Serves a pre-gzipped asset straight from flash. The browser revalidates
+// with If-None-Match on every load and gets a 304 while the ETag matches.
+void sendAsset(AsyncWebServerRequest *request, const char *type,
+               const uint8_t *data, size_t len, const char *etag) {
+  if (request->hasHeader("If-None-Match") &&
+      request->getHeader("If-None-Match")->value() == etag) {
+    request->send(304);
+    return;
+  }
+
+  AsyncWebServerResponse *response = request->beginResponse_P(200, type, data, len);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("Cache-Control", "no-cache");
+  response->addHeader("ETag", etag);
+  request->send(response);
+}
+
 void setup() {
   Serial.begin(9600);
+  parserInit(&parser);
+  jp_decoder_init(&frames);
   delay(1000);
 
   // === Initialize OLED ===
@@ -45,140 +79,29 @@ void setup() {
   display.println(myIP);
   display.display();
 
-  // === Serve Webpage ===
+  // === Serve Webpage (web/index.html, web/game.js) ===
   server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
-    String html = R"rawliteral(
-      <!DOCTYPE html><html><head><title>ESP8266 Snake</title>
-      <meta name='viewport' content='width=device-width, initial-scale=1.0'>
-      <style>
-        body {
-          display: flex;
-          flex-direction: column;
-          align-items: center;
-          font-family: sans-serif;
-          text-align: center;
-          margin: 0;
-          padding: 0;
-        }
-        .canvas-container {
-          display: flex;
-          flex-direction: column;
-          align-items: center;
-          gap: 20px;
-          margin-top: 10px;
-        }
-        canvas {
-          border: 2px solid black;
-          width: 150px;
-          height: 150px;
-        }
-      </style>
-      </head><body>
-      <h2>ESP8266 Dual Snake Game</h2>
-      <div><b>Joystick:</b> <span id='joystick'>WAIT</span></div>
-      <div><b>Button:</b> <span id='button'>WAIT</span></div>
-      <div class="canvas-container">
-        <canvas id='canvasJoy' width='150' height='150'></canvas>
-        <canvas id='canvasBtn' width='150' height='150'></canvas>
-      </div>
-      <script src='/game.js'></script>
-      </body></html>
-    )rawliteral";
-    request->send(200, "text/html", html);
+    sendAsset(request, "text/html", INDEX_HTML_GZ, INDEX_HTML_GZ_LEN, INDEX_HTML_ETAG);
   });
 
   server.on("/joystick", HTTP_GET, [](AsyncWebServerRequest *request){
-    request->send(200, "text/plain", latestJoystick);
+    request->send(200, "text/plain", eventLabel(latestJoystick));
   });
 
   server.on("/button", HTTP_GET, [](AsyncWebServerRequest *request){
-    request->send(200, "text/plain", latestButton);
+    request->send(200, "text/plain", eventLabel(latestButton));
+  });
+
+  // === Event Stream ===
+  // New clients get the current state immediately, then one event per line.
+  events.onConnect([](AsyncEventSourceClient *client){
+    client->send(eventLabel(latestJoystick), "joystick", millis(), 1000);
+    client->send(eventLabel(latestButton), "button", millis());
   });
+  server.addHandler(&events);
 
   server.on("/game.js", HTTP_GET, [](AsyncWebServerRequest *request){
-    String js = R"rawliteral(
-      const joyCanvas = document.getElementById('canvasJoy');
-      const btnCanvas = document.getElementById('canvasBtn');
-      const joyCtx = joyCanvas.getContext('2d');
-      const btnCtx = btnCanvas.getContext('2d');
-
-      const gridSize = 15;
-      const canvasSize = 150;
-
-      let joySnake = [{x: 75, y: 75}];
-      let btnSnake = [{x: 75, y: 75}];
-      let joyDir = 'RIGHT';
-      let btnDir = 'RIGHT';
-      let joyGameOver = false;
-      let btnGameOver = false;
-
-      function drawSnake(ctx, snake) {
-        ctx.clearRect(0, 0, canvasSize, canvasSize);
-        ctx.fillStyle = 'black';
-        snake.forEach(p => ctx.fillRect(p.x, p.y, gridSize, gridSize));
-      }
-
-      function moveSnake(snake, direction, ctx, gameFlag) {
-        if (gameFlag.value) return;
-
-        const head = {...snake[0]};
-        if (direction === 'UP') head.y -= gridSize;
-        if (direction === 'DOWN') head.y += gridSize;
-        if (direction === 'LEFT') head.x -= gridSize;
-        if (direction === 'RIGHT') head.x += gridSize;
-
-        if (head.x < 0 || head.x >= canvasSize || head.y < 0 || head.y >= canvasSize) {
-          gameFlag.value = true;
-          ctx.fillStyle = 'red';
-          ctx.font = '14px Arial';
-          ctx.fillText('Game Over', 30, 75);
-          setTimeout(() => {
-            snake.splice(0, snake.length, {x: 75, y: 75});
-            gameFlag.value = false;
-          }, 2000);
-          return;
-        }
-
-        snake.unshift(head);
-        snake.pop();
-        drawSnake(ctx, snake);
-      }
-
-      function fetchInputs() {
-        Promise.all([
-          fetch('/joystick').then(r => r.text()),
-          fetch('/button').then(r => r.text())
-        ]).then(([joy, btn]) => {
-          document.getElementById('joystick').innerText = joy;
-          document.getElementById('button').innerText = btn;
-
-          if (joy.includes('LEFT')) joyDir = 'LEFT';
-          if (joy.includes('RIGHT')) joyDir = 'RIGHT';
-          if (joy.includes('UP')) joyDir = 'UP';
-          if (joy.includes('DOWN')) joyDir = 'DOWN';
-
-          if (btn.includes('LEFT')) btnDir = 'LEFT';
-          if (btn.includes('RIGHT')) btnDir = 'RIGHT';
-          if (btn.includes('UP')) btnDir = 'UP';
-          if (btn.includes('DOWN')) btnDir = 'DOWN';
-        });
-      }
-
-      setInterval(() => moveSnake(joySnake, joyDir, joyCtx, {
-        get value() { return joyGameOver; },
-        set value(v) { joyGameOver = v; }
-      }), 200);
-
-      setInterval(() => moveSnake(btnSnake, btnDir, btnCtx, {
-        get value() { return btnGameOver; },
-        set value(v) { btnGameOver = v; }
-      }), 200);
-
-      setInterval(fetchInputs, 100);
-      drawSnake(joyCtx, joySnake);
-      drawSnake(btnCtx, btnSnake);
-    )rawliteral";
-    request->send(200, "application/javascript", js);
+    sendAsset(request, "application/javascript", GAME_JS_GZ, GAME_JS_GZ_LEN, GAME_JS_ETAG);
   });
 
   server.onNotFound(notFound);
@@ -186,34 +109,55 @@ void setup() {
 }
 
 void loop() {
-  if (Serial.available()) {
-    String receivedData = Serial.readStringUntil('\n');
-    receivedData.trim();
-
-    if (receivedData.length() > 0) {
-      Serial.print("Received: ");
-      Serial.println(receivedData);
-
-      if (receivedData.indexOf("(button)") >= 0) {
-        latestButton = receivedData;
-      } else {
-        latestJoystick = receivedData;
-      }
-
-      // === Update OLED ===
-      display.clearDisplay();
-      display.setTextSize(1);
-      display.setCursor(0, 0);
-      display.println("Joystick_Controller");
-      display.print("IP: ");
-      display.println(WiFi.softAPIP());
-      display.setCursor(0, 32);
-      display.print("Joy: ");
-      display.println(latestJoystick);
-      display.setCursor(0, 50);
-      display.print("Btn: ");
-      display.println(latestButton);
-      display.display();
+  // Ask the PIC for binary frames until it starts sending them.
+  if (!binaryLink && millis() - lastHello >= 1000) {
+    uint8_t hello[JP_FRAME_MAX];
+    Serial.write(hello, jp_encode(hello, JP_EV_HELLO));
+    lastHello = millis();
+  }
+
+  // Drain whatever has arrived; a partial line or frame just waits.
+  // Frames start with JP_SYNC, which never occurs in the ASCII lines.
+  while (Serial.available()) {
+    uint8_t c = Serial.read();
+    SerialEvent ev;
+
+    if (jp_decoder_busy(&frames) || c == JP_SYNC) {
+      uint8_t code = jp_decode(&frames, c);
+      if (code == JP_NONE || code == JP_EV_HELLO) continue;
+      binaryLink = true;
+      ev = (SerialEvent)code;
+    } else {
+      ev = parserFeed(&parser, (char)c);
     }
+    if (ev == EV_NONE || ev == EV_UNKNOWN) continue;
+
+    if (eventIsButton(ev)) {
+      latestButton = ev;
+      events.send(eventLabel(latestButton), "button", millis());
+    } else {
+      latestJoystick = ev;
+      events.send(eventLabel(latestJoystick), "joystick", millis());
+    }
+    oledDirty = true;
+  }
+
+  // === Update OLED ===
+  if (oledDirty && !Serial.available() && millis() - lastDraw >= OLED_MIN_MS) {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("Joystick_Controller");
+    display.print("IP: ");
+    display.println(WiFi.softAPIP());
+    display.setCursor(0, 32);
+    display.print("Joy: ");
+    display.println(eventLabel(latestJoystick));
+    display.setCursor(0, 50);
+    display.print("Btn: ");
+    display.println(eventLabel(latestButton));
+    display.display();
+    oledDirty = false;
+    lastDraw = millis();
   }
 }
@@ -4,42 +4,84 @@
 #include <string.h>
 #include "mcc_generated_files/system/system.h"
 #include "mcc_generated_files/uart/uart1.h"
+#include "joy_protocol.h"
+#include "uart_txq.h"
+#include "../Assignments/adc_filter.h"
+#include "../Assignments/lcd.h"
+#include "joy_classify.h"
+#include "../Assignments/power.h"
+#include "../Assignments/clock.h"
 
-#define _XTAL_FREQ 4000000
+// 1: TMR2 triggers the ADC and an ISR samples RA0/RA1 at a fixed 1 kHz
+// 0: ADC1_Read() polls both channels from the main loop
+#define ADC_AUTO_TRIGGER 1
 
-// === LCD Connections ===
-#define RS LATD0
-#define EN LATD1
-#define ldata LATB
-#define LCD_Port TRISB
-#define LCD_Control TRISD
+// Joystick calibration in data EEPROM
+#define CAL_EE_ADDR   0x00
+#define CAL_MAGIC     0xC5
+#define CAL_SWEEP_MS  5000      // time allowed to sweep the stick to its extremes
+#define CAL_PAIR_MS   1         // one auto-triggered X/Y pair per ms
+
+// Attach the raw X/Y reading to each binary frame (6 bytes instead of 3)
+#define SEND_RAW_XY 0
 
 // === Function Prototypes ===
-void LCD_Init(void);
-void LCD_Command(char);
-void LCD_Char(char);
-void LCD_String(const char *);
-void LCD_String_xy(char row, char pos, const char *);
-void LCD_Clear(void);
-void MSdelay(unsigned int);
 void ADC1_Initialize(void);
 uint16_t ADC1_Read(uint8_t channel);
+void ADC1_Start_Auto(void);
+uint8_t ADC1_Get_Pair(uint16_t *x, uint16_t *y);
 void UART1_Write_Text(const char*);
+void UART1_Write_Bytes(const uint8_t*, uint8_t);
+void UART1_Check_Hello(void);
+void Send_Event(uint8_t event, const char *text, uint16_t x, uint16_t y);
+uint8_t EEPROM_Read(uint8_t addr);
+void EEPROM_Write(uint8_t addr, uint8_t data);
+uint8_t Cal_Load(joy_cal_t *cal);
+void Cal_Save(const joy_cal_t *cal);
+void Cal_Run(joy_cal_t *cal);
+void Read_Joystick(uint16_t *x, uint16_t *y);
+
+// === Joystick Direction ===
+joy_classifier_t joy;
+const uint8_t dirEvent[] = {
+    JP_EV_JOY_CENTER, JP_EV_JOY_LEFT, JP_EV_JOY_RIGHT, JP_EV_JOY_UP, JP_EV_JOY_DOWN
+};
+const char *const dirText[] = {
+    "CENTER\r\n", "LEFT\r\n", "RIGHT\r\n", "UP\r\n", "DOWN\r\n"
+};
+
+// === Link Mode ===
+// ASCII lines until the ESP8266 sends a HELLO frame, then binary frames.
+uint8_t binaryMode = 0;
+jp_decoder_t rxDecoder;
+
+// === UART1 TX Queue ===
+// Filled by UART1_Write_Bytes(), drained by the U1TX interrupt, so sending a
+// message no longer stalls the sampling loop. Overflow counts are kept in
+// txQueue.overflows / txQueue.droppedBytes.
+txq_t txQueue;
+
+// === Auto-Triggered Sampling ===
+// The ADC ISR fills the back buffer (X then Y) and flips adcFront when the
+// pair is complete, so the main loop always copies a matching X/Y pair.
+volatile uint16_t adcPair[2][2];    // [buffer][0 = X (RA0), 1 = Y (RA1)]
+volatile uint8_t adcFront = 0;
+volatile uint8_t adcPairReady = 0;
 
 // === Main ===
 void main(void)
 {
-    SYSTEM_Initialize();
+    SYSTEM_Initialize();        // the MCC clock setup must be HFINTOSC 4 MHz (clock.h)
     ADC1_Initialize();
 
-    LCD_Port = 0x00;
-    LCD_Control = 0x00;
-    TRISB = 0x00;
-    TRISDbits.TRISD0 = 0;
-    TRISDbits.TRISD1 = 0;
-
     LCD_Init();
     LCD_Clear();
+    jp_decoder_init(&rxDecoder);
+    txq_init(&txQueue);
+    INTCON0bits.GIE = 1;    // U1TX interrupt drains txQueue
+#if ADC_AUTO_TRIGGER
+    ADC1_Start_Auto();
+#endif
 
     LCD_String_xy(1, 0, "EDUARDO WILLIAMS");
     __delay_ms(300);
@@ -52,72 +94,80 @@ void main(void)
     TRISDbits.TRISD2 = 1; ANSELDbits.ANSELD2 = 0;
     TRISDbits.TRISD3 = 1; ANSELDbits.ANSELD3 = 0;
 
+    // === Joystick Calibration ===
+    // Runs when EEPROM holds no calibration or the UP button (RC2) is held.
+    joy_cal_t cal;
+    if (!Cal_Load(&cal) || PORTCbits.RC2 == 0) {
+        Cal_Run(&cal);
+        Cal_Save(&cal);
+    }
+    joy_classifier_init(&joy, &cal);
+
     uint16_t x_val, y_val;
-    char displayLine[17];
-    uint8_t last_dir_x = 0, last_dir_y = 0;
+    uint8_t last_dir = JOY_DIR_CENTER;
     uint8_t last_RC2 = 1, last_RC3 = 1, last_RD2 = 1, last_RD3 = 1;
     static uint16_t lcd_counter = 0;
     static uint16_t last_x = 0, last_y = 0;
 
     while (1)
     {
+        UART1_Check_Hello();
+
         // === Read ADC for Joystick ===
-        x_val = ADC1_Read(0);  // RA0
-        y_val = ADC1_Read(1);  // RA1
+#if ADC_AUTO_TRIGGER
+        if (!ADC1_Get_Pair(&x_val, &y_val)) {
+            // Idle until the ADC interrupt brings the next pair (within
+            // 1 ms). Before the HELLO arrives keep polling instead, since the
+            // 2-byte UART RX FIFO could overflow while the CPU is stopped.
+            if (binaryMode)
+                power_idle();
+            continue;
+        }
+#else
+        Read_Joystick(&x_val, &y_val);
+#endif
 
         // === Throttle LCD update ===
         lcd_counter++;
         if ((x_val != last_x || y_val != last_y) && lcd_counter > 1000)
         {
-            sprintf(displayLine, "X:%4u Y:%4u", x_val, y_val);
-            LCD_String_xy(1, 0, displayLine);
+            lcd_printf_at(1, 0, "X:%4u Y:%4u", x_val, y_val);
+            lcd_flush();
             last_x = x_val;
             last_y = y_val;
             lcd_counter = 0;
         }
 
-        // === Direction Detection Based on Your Ranges ===
-        if (x_val >= 3200 && x_val <= 3300 && y_val >= 1640 && y_val <= 1680 && last_dir_x != 1) {
-            UART1_Write_Text("LEFT\r\n"); last_dir_x = 1; last_dir_y = 0;
-        }
-        else if (x_val >= 6 && x_val <= 60 && y_val >= 1400 && y_val <= 1800 && last_dir_x != 2) {
-            UART1_Write_Text("RIGHT\r\n"); last_dir_x = 2; last_dir_y = 0;
-        }
-        else if (y_val >= 6 && y_val <= 60 && x_val >= 1400 && x_val <= 1800 && last_dir_y != 2) {
-            UART1_Write_Text("UP\r\n"); last_dir_y = 2; last_dir_x = 0;
-        }
-        else if (y_val >= 3200 && y_val <= 3300 && x_val >= 1640 && x_val <= 1700 && last_dir_y != 1) {
-            UART1_Write_Text("DOWN\r\n"); last_dir_y = 1; last_dir_x = 0;
-        }
-        else if (x_val >= 1630 && x_val <= 1650 && y_val >= 1630 && y_val <= 1650 &&
-                 (last_dir_x != 0 || last_dir_y != 0)) {
-            UART1_Write_Text("CENTER\r\n");
-            last_dir_x = 0; last_dir_y = 0;
+        // === Direction Detection (calibrated sectors) ===
+        uint8_t dir = joy_classify(&joy, x_val, y_val);
+        if (dir != last_dir) {
+            Send_Event(dirEvent[dir], dirText[dir], x_val, y_val);
+            last_dir = dir;
         }
 
         // === Button Debounced Check ===
         if (PORTCbits.RC2 == 0 && last_RC2 == 1) {
             __delay_ms(5);
             if (PORTCbits.RC2 == 0)
-                UART1_Write_Text("UP (button)\r\n");
+                Send_Event(JP_EV_BTN_UP, "UP (button)\r\n", x_val, y_val);
         } last_RC2 = PORTCbits.RC2;
 
         if (PORTCbits.RC3 == 0 && last_RC3 == 1) {
             __delay_ms(5);
             if (PORTCbits.RC3 == 0)
-                UART1_Write_Text("DOWN (button)\r\n");
+                Send_Event(JP_EV_BTN_DOWN, "DOWN (button)\r\n", x_val, y_val);
         } last_RC3 = PORTCbits.RC3;
 
         if (PORTDbits.RD2 == 0 && last_RD2 == 1) {
             __delay_ms(5);
             if (PORTDbits.RD2 == 0)
-                UART1_Write_Text("LEFT (button)\r\n");
+                Send_Event(JP_EV_BTN_LEFT, "LEFT (button)\r\n", x_val, y_val);
         } last_RD2 = PORTDbits.RD2;
 
         if (PORTDbits.RD3 == 0 && last_RD3 == 1) {
             __delay_ms(5);
             if (PORTDbits.RD3 == 0)
-                UART1_Write_Text("RIGHT (button)\r\n");
+                Send_Event(JP_EV_BTN_RIGHT, "RIGHT (button)\r\n", x_val, y_val);
         } last_RD3 = PORTDbits.RD3;
     }
 }
@@ -130,73 +180,229 @@ void ADC1_Initialize(void)
     ADCON0bits.CONT = 0;
     ADCON0bits.FM = 1;
     ADCON0bits.CS = 1;
+
+    // 8-sample bursts: short enough to finish inside the 500 us TMR2 period
+    adc_filter_init(3);
 }
 
 uint16_t ADC1_Read(uint8_t channel)
 {
     ADPCH = channel;
     __delay_us(5);
-    ADCON0bits.GO = 1;
-    while (ADCON0bits.GO);
-    return ((uint16_t)ADRESH << 8) | ADRESL;
+    return adc_filtered_read(channel);
+}
+
+// Blocking read of one X/Y pair from whichever path is configured
+void Read_Joystick(uint16_t *x, uint16_t *y)
+{
+#if ADC_AUTO_TRIGGER
+    while (!ADC1_Get_Pair(x, y));
+#else
+    *x = ADC1_Read(0);  // RA0
+    *y = ADC1_Read(1);  // RA1
+#endif
+}
+
+// TMR2 overflows every 500 us and starts a burst (ADACT); the ISR
+// alternates RA0/RA1, so each averaged X/Y pair is sampled at exactly 1 kHz.
+void ADC1_Start_Auto(void)
+{
+    // T2CS FOSC/4; 1:4 prescale; 500 us period -> 2 kHz
+    T2CLKCON = 0x01;
+    T2HLT = 0x00;
+    T2RST = 0x00;
+    T2PR = FCY_COUNTS(500, 4) - 1;
+    T2TMR = 0x00;
+    T2CON = 0xA0;
+
+    ADPCH = 0x00;
+    ADACQL = 0x08;              // 8 TAD acquisition before each triggered conversion
+    ADACQH = 0x00;
+    ADACT = 0x04;               // auto-conversion trigger: TMR2
+
+    PIR1bits.ADTIF = 0;
+    PIE1bits.ADTIE = 1;
+}
+
+// ADTIF fires once per burst, after the hardware average is in ADFLTR.
+void __interrupt(irq(ADT), base(0x0008)) ADC1_ISR(void)
+{
+    static uint8_t channel = 0;
+    uint8_t back = adcFront ^ 1;
+
+    PIR1bits.ADTIF = 0;
+    ADCON2bits.ACLR = 1;        // start the next burst from an empty ADACC
+    adcPair[back][channel] = adc_filter_result();
+
+    if (channel == 0) {
+        channel = 1;
+    } else {
+        channel = 0;
+        adcFront = back;
+        adcPairReady = 1;
+    }
+    ADPCH = channel;            // acquired during the next 500 us
+}
+
+// Copies the newest X/Y pair. Returns 0 if none arrived since the last call.
+uint8_t ADC1_Get_Pair(uint16_t *x, uint16_t *y)
+{
+    if (!adcPairReady)
+        return 0;
+
+    PIE1bits.ADTIE = 0;
+    *x = adcPair[adcFront][0];
+    *y = adcPair[adcFront][1];
+    adcPairReady = 0;
+    PIE1bits.ADTIE = 1;
+    return 1;
 }
 
 // === UART ===
+// UART1 must be left in polled mode in MCC; the TX interrupt below is ours.
 void UART1_Write_Text(const char* text)
 {
-    while (*text) {
-        while (!UART1_IsTxReady());
-        UART1_Write((uint8_t)*text);
-        text++;
-    }
+    UART1_Write_Bytes((const uint8_t*)text, (uint8_t)strlen(text));
 }
 
-// === LCD ===
-void LCD_Init(void)
+void UART1_Write_Bytes(const uint8_t* data, uint8_t len)
 {
-    MSdelay(20);
-    LCD_Command(0x38); MSdelay(5);
-    LCD_Command(0x0C); MSdelay(5);
-    LCD_Command(0x06); MSdelay(5);
-    LCD_Command(0x01); MSdelay(5);
+    if (txq_push(&txQueue, data, len))
+        PIE3bits.U1TXIE = 1;
 }
 
-void LCD_Command(char cmd)
+void __interrupt(irq(U1TX), base(0x0008)) UART1_TX_ISR(void)
 {
-    ldata = cmd;
-    RS = 0;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(2);
+    uint8_t byte;
+
+    if (txq_pop(&txQueue, &byte))
+        U1TXB = byte;
+    else
+        PIE3bits.U1TXIE = 0;    // queue empty, wait for the next message
 }
 
-void LCD_Char(char dat)
+// Switches to binary frames once the ESP8266 asks for them (needs UART1 RX
+// enabled in MCC and wired to the ESP8266 TX; otherwise we stay on ASCII).
+void UART1_Check_Hello(void)
 {
-    ldata = dat;
-    RS = 1;
-    EN = 1; NOP(); EN = 0;
-    MSdelay(1);
+    while (UART1_IsRxReady()) {
+        if (jp_decode(&rxDecoder, UART1_Read()) == JP_EV_HELLO)
+            binaryMode = 1;
+    }
 }
 
-void LCD_String(const char *msg)
+void Send_Event(uint8_t event, const char *text, uint16_t x, uint16_t y)
 {
-    while (*msg) LCD_Char(*msg++);
+    uint8_t frame[JP_FRAME_MAX];
+
+    if (!binaryMode) {
+        UART1_Write_Text(text);
+        return;
+    }
+#if SEND_RAW_XY
+    UART1_Write_Bytes(frame, jp_encode_xy(frame, event, x, y));
+#else
+    UART1_Write_Bytes(frame, jp_encode(frame, event));
+#endif
 }
 
-void LCD_String_xy(char row, char pos, const char *msg)
+// === Calibration ===
+// Center: average of 64 samples at rest. Extremes: min/max while the user
+// sweeps the stick around for CAL_SWEEP_MS. With auto-triggered sampling
+// Read_Joystick() waits for the next 1 kHz pair, so the sweep is timed by
+// counting pairs; polled reads return at once and need the delay.
+void Cal_Run(joy_cal_t *cal)
 {
-    char loc = (row == 1) ? (0x80 | (pos & 0x0F)) : (0xC0 | (pos & 0x0F));
-    LCD_Command(loc);
-    LCD_String(msg);
+    uint16_t x, y;
+    uint32_t sumX = 0, sumY = 0;
+
+    joy_cal_default(cal);
+
+    LCD_Clear();
+    LCD_String_xy(1, 0, "Calibrate: leave");
+    LCD_String_xy(2, 0, "stick centered");
+    __delay_ms(1000);
+    for (uint8_t i = 0; i < 64; i++) {
+        Read_Joystick(&x, &y);
+        sumX += x;
+        sumY += y;
+    }
+    cal->cx = (uint16_t)(sumX / 64);
+    cal->cy = (uint16_t)(sumY / 64);
+    cal->xMin = cal->xMax = cal->cx;
+    cal->yMin = cal->yMax = cal->cy;
+
+    LCD_Clear();
+    LCD_String_xy(1, 0, "Move stick to");
+    LCD_String_xy(2, 0, "all 4 edges");
+    for (uint16_t ms = 0; ms < CAL_SWEEP_MS; ms += CAL_PAIR_MS) {
+        Read_Joystick(&x, &y);
+        if (x < cal->xMin) cal->xMin = x;
+        if (x > cal->xMax) cal->xMax = x;
+        if (y < cal->yMin) cal->yMin = y;
+        if (y > cal->yMax) cal->yMax = y;
+#if !ADC_AUTO_TRIGGER
+        __delay_ms(CAL_PAIR_MS);
+#endif
+    }
+    LCD_Clear();
+}
+
+// Layout: magic, the joy_cal_t bytes, then their CRC-8 (joy_protocol.c).
+// Anything that fails the magic, the CRC or the range check loads the
+// defaults and returns 0, so main() runs the calibration again.
+uint8_t Cal_Load(joy_cal_t *cal)
+{
+    uint8_t *p = (uint8_t *)cal;
+
+    if (EEPROM_Read(CAL_EE_ADDR) == CAL_MAGIC) {
+        for (uint8_t i = 0; i < sizeof(joy_cal_t); i++)
+            p[i] = EEPROM_Read(CAL_EE_ADDR + 1 + i);
+        if (EEPROM_Read(CAL_EE_ADDR + 1 + sizeof(joy_cal_t)) == jp_crc8(p, sizeof(joy_cal_t)) &&
+            joy_cal_valid(cal))
+            return 1;
+    }
+    joy_cal_default(cal);
+    return 0;
 }
 
-void LCD_Clear(void)
+void Cal_Save(const joy_cal_t *cal)
 {
-    LCD_Command(0x01);
-    MSdelay(2);
+    const uint8_t *p = (const uint8_t *)cal;
+
+    EEPROM_Write(CAL_EE_ADDR, 0xFF);        // invalid while the record changes
+    for (uint8_t i = 0; i < sizeof(joy_cal_t); i++)
+        EEPROM_Write(CAL_EE_ADDR + 1 + i, p[i]);
+    EEPROM_Write(CAL_EE_ADDR + 1 + sizeof(joy_cal_t), jp_crc8(p, sizeof(joy_cal_t)));
+    EEPROM_Write(CAL_EE_ADDR, CAL_MAGIC);   // last, so a cut write stays invalid
+}
+
+// === Data EEPROM (same sequence as Write_EEPROM.asm) ===
+uint8_t EEPROM_Read(uint8_t addr)
+{
+    NVMCON1 = 0x00;             // REG = data EEPROM
+    NVMADRH = 0x00;
+    NVMADRL = addr;
+    NVMCON1bits.RD = 1;
+    return NVMDAT;
 }
 
-void MSdelay(unsigned int val)
+void EEPROM_Write(uint8_t addr, uint8_t data)
 {
-    for (unsigned int i = 0; i < val; i++)
-        for (unsigned int j = 0; j < 165; j++);
+    uint8_t gie = INTCON0bits.GIE;
+
+    NVMCON1 = 0x00;
+    NVMADRH = 0x00;
+    NVMADRL = addr;
+    NVMDAT = data;
+    NVMCON1bits.WREN = 1;
+
+    INTCON0bits.GIE = 0;
+    NVMCON2 = 0x55;
+    NVMCON2 = 0xAA;
+    NVMCON1bits.WR = 1;
+    INTCON0bits.GIE = gie;
+
+    while (NVMCON1bits.WR);     // about 4 ms per byte
+    NVMCON1bits.WREN = 0;
 }
@@ -0,0 +1,68 @@
+# Generates web_assets.h from the plain sources in web/.
+#
+# Each file is gzipped (fixed mtime so the output is reproducible) and
+# written out as a PROGMEM byte array with its length and an ETag taken
+# from the source contents.
+#
+# Runs standalone (python embed_assets.py) or as a PlatformIO pre-script:
+#   extra_scripts = pre:embed_assets.py
+
+import gzip
+import hashlib
+import os
+
+ASSETS = [
+    # (source file, C symbol prefix)
+    ("index.html", "INDEX_HTML"),
+    ("game.js", "GAME_JS"),
+]
+
+
+def embed(project_dir):
+    web_dir = os.path.join(project_dir, "web")
+    out_path = os.path.join(project_dir, "web_assets.h")
+
+    lines = [
+        "// Generated by embed_assets.py from web/ -- do not edit.",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+
+    for name, symbol in ASSETS:
+        with open(os.path.join(web_dir, name), "rb") as f:
+            raw = f.read()
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(raw).hexdigest()[:16]
+
+        lines.append("// %s: %d bytes, %d gzipped" % (name, len(raw), len(packed)))
+        lines.append('#define %s_ETAG "\\"%s\\""' % (symbol, etag))
+        lines.append("const size_t %s_GZ_LEN = %d;" % (symbol, len(packed)))
+        lines.append("const uint8_t %s_GZ[] PROGMEM = {" % symbol)
+        for i in range(0, len(packed), 16):
+            chunk = packed[i:i + 16]
+            lines.append("  " + ", ".join("0x%02x" % b for b in chunk) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("#endif")
+    text = "\n".join(lines) + "\n"
+
+    # Only touch the header when it changes so incremental builds stay quick.
+    if os.path.exists(out_path):
+        with open(out_path) as f:
+            if f.read() == text:
+                return
+    with open(out_path, "w") as f:
+        f.write(text)
+    print("embed_assets: wrote %s" % out_path)
+
+
+try:
+    Import("env")  # noqa: F821 -- provided by PlatformIO/SCons
+    embed(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        embed(os.path.dirname(os.path.abspath(__file__)))
@@ -0,0 +1,89 @@
+#include "joy_classify.h"
+
+void joy_cal_default(joy_cal_t *cal)
+{
+    cal->cx = 1640;
+    cal->cy = 1640;
+    cal->xMin = 6;
+    cal->xMax = 3300;
+    cal->yMin = 6;
+    cal->yMax = 3300;
+    cal->deadZone = 40;
+    cal->hysteresis = 10;
+}
+
+uint8_t joy_cal_valid(const joy_cal_t *cal)
+{
+    if (cal->xMax > 4095 || cal->yMax > 4095)
+        return 0;
+    if (cal->cx <= cal->xMin || cal->cx - cal->xMin < 100 ||
+        cal->cx >= cal->xMax || cal->xMax - cal->cx < 100)
+        return 0;
+    if (cal->cy <= cal->yMin || cal->cy - cal->yMin < 100 ||
+        cal->cy >= cal->yMax || cal->yMax - cal->cy < 100)
+        return 0;
+    return cal->deadZone + cal->hysteresis < 100;
+}
+
+// Q12 factor that maps a half-axis travel onto 0..100
+static uint16_t scale(uint16_t travel)
+{
+    if (travel < 100) travel = 100;     // guard a bad calibration
+    return (uint16_t)((100UL << 12) / travel);
+}
+
+void joy_classifier_init(joy_classifier_t *c, const joy_cal_t *cal)
+{
+    c->cal = *cal;
+    c->kxLo = scale(cal->cx > cal->xMin ? cal->cx - cal->xMin : 0);
+    c->kxHi = scale(cal->xMax > cal->cx ? cal->xMax - cal->cx : 0);
+    c->kyLo = scale(cal->cy > cal->yMin ? cal->cy - cal->yMin : 0);
+    c->kyHi = scale(cal->yMax > cal->cy ? cal->yMax - cal->cy : 0);
+    c->dir = JOY_DIR_CENTER;
+}
+
+// Signed position on one axis, clamped to -100..+100
+static int8_t normalize(uint16_t v, uint16_t center, uint16_t kLo, uint16_t kHi)
+{
+    uint32_t n;
+
+    if (v >= center) {
+        n = ((uint32_t)(v - center) * kHi) >> 12;
+        return (int8_t)(n > 100 ? 100 : n);
+    }
+    n = ((uint32_t)(center - v) * kLo) >> 12;
+    return (int8_t)-(int8_t)(n > 100 ? 100 : n);
+}
+
+uint8_t joy_classify(joy_classifier_t *c, uint16_t x, uint16_t y)
+{
+    int8_t nx = normalize(x, c->cal.cx, c->kxLo, c->kxHi);
+    int8_t ny = normalize(y, c->cal.cy, c->kyLo, c->kyHi);
+    uint8_t ax = (uint8_t)(nx < 0 ? -nx : nx);
+    uint8_t ay = (uint8_t)(ny < 0 ? -ny : ny);
+    uint8_t m = ax > ay ? ax : ay;
+    uint8_t horizontal;
+
+    // Dead zone: leaving CENTER needs the extra hysteresis margin
+    if (c->dir == JOY_DIR_CENTER) {
+        if (m < c->cal.deadZone + c->cal.hysteresis)
+            return JOY_DIR_CENTER;
+    } else if (m < c->cal.deadZone) {
+        c->dir = JOY_DIR_CENTER;
+        return c->dir;
+    }
+
+    // Sector: stay on the current axis until the other one leads by the margin
+    if (c->dir == JOY_DIR_LEFT || c->dir == JOY_DIR_RIGHT)
+        horizontal = ay <= ax + c->cal.hysteresis;
+    else if (c->dir == JOY_DIR_UP || c->dir == JOY_DIR_DOWN)
+        horizontal = ax > ay + c->cal.hysteresis;
+    else
+        horizontal = ax >= ay;
+
+    if (horizontal)
+        c->dir = nx > 0 ? JOY_DIR_LEFT : JOY_DIR_RIGHT;
+    else
+        c->dir = ny < 0 ? JOY_DIR_UP : JOY_DIR_DOWN;
+    return c->dir;
+}
@@ -0,0 +1,64 @@
+/* 
+ * File:   joy_classify.h
+ * Calibrated joystick direction classifier. Plain C, no register access.
+ *
+ * Each reading is scaled to -100..+100 per half-axis using the calibrated
+ * rest point and extremes, then mapped to a sector: CENTER inside the dead
+ * zone, otherwise the direction of the dominant axis. Every position maps
+ * to exactly one direction and each sample costs the same few operations.
+ * Hysteresis keeps the output from chattering on sector boundaries.
+ */
+
+#ifndef JOY_CLASSIFY_H
+#define	JOY_CLASSIFY_H
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define JOY_DIR_CENTER 0
+#define JOY_DIR_LEFT   1    // X toward xMax
+#define JOY_DIR_RIGHT  2    // X toward xMin
+#define JOY_DIR_UP     3    // Y toward yMin
+#define JOY_DIR_DOWN   4    // Y toward yMax
+
+// Stored in EEPROM by MCC_UART.c
+typedef struct {
+    uint16_t cx, cy;            // rest position
+    uint16_t xMin, xMax;        // extremes seen during calibration
+    uint16_t yMin, yMax;
+    uint8_t deadZone;           // % of travel reported as CENTER
+    uint8_t hysteresis;         // % of travel needed to change sector
+} joy_cal_t;
+
+typedef struct {
+    joy_cal_t cal;
+    uint16_t kxLo, kxHi;        // Q12 scale factors, 100 / half-axis travel
+    uint16_t kyLo, kyHi;
+    uint8_t dir;                // last reported direction
+} joy_classifier_t;
+
+// Default calibration: the rest point (1640) and extremes (6..3300) of the
+// original fixed windows in MCC_UART.c, with a 40% dead zone and 10%
+// hysteresis. The thresholds are much wider than the old windows: LEFT now
+// fires at X >= 2473 coming from CENTER, where the old window needed
+// 3200..3300, and CENTER returns at X <= 2306 instead of inside 1630..1650.
+void joy_cal_default(joy_cal_t *cal);
+
+// 1 if cal is usable: rest point strictly inside the extremes on both axes,
+// at least 100 counts of travel each way, dead zone below 100%.
+uint8_t joy_cal_valid(const joy_cal_t *cal);
+
+// Precompute the scale factors. Call after changing cal.
+void joy_classifier_init(joy_classifier_t *c, const joy_cal_t *cal);
+
+// Classify one sample; returns JOY_DIR_*.
+uint8_t joy_classify(joy_classifier_t *c, uint16_t x, uint16_t y);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* JOY_CLASSIFY_H */
@@ -0,0 +1,116 @@
+#include "joy_protocol.h"
+
+uint8_t jp_crc8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0;
+
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+uint8_t jp_encode(uint8_t *out, uint8_t event)
+{
+    out[0] = JP_SYNC;
+    out[1] = event & 0x7F;
+    out[2] = jp_crc8(&out[1], 1);
+    return 3;
+}
+
+uint8_t jp_encode_xy(uint8_t *out, uint8_t event, uint16_t x, uint16_t y)
+{
+    out[0] = JP_SYNC;
+    out[1] = (event & 0x7F) | JP_FLAG_XY;
+    out[2] = (uint8_t)(x >> 4);
+    out[3] = (uint8_t)((x << 4) | ((y >> 8) & 0x0F));
+    out[4] = (uint8_t)y;
+    out[5] = jp_crc8(&out[1], 4);
+    return 6;
+}
+
+void jp_decoder_init(jp_decoder_t *d)
+{
+    d->len = 0;
+    d->x = 0;
+    d->y = 0;
+    d->crcErrors = 0;
+}
+
+uint8_t jp_decoder_busy(const jp_decoder_t *d)
+{
+    return d->len != 0;
+}
+
+// Expected frame length once the event byte is known.
+static uint8_t frame_length(uint8_t event)
+{
+    return (event & JP_FLAG_XY) ? 6 : 3;
+}
+
+static uint8_t decode_byte(jp_decoder_t *d, uint8_t byte)
+{
+    if (d->len == 0) {
+        if (byte == JP_SYNC) d->buf[d->len++] = byte;
+        return JP_NONE;
+    }
+
+    d->buf[d->len++] = byte;
+
+    if (d->len == 2 && (byte & 0x7F) > JP_EV_MAX) {
+        d->len = 0xFF;                  // not a frame, resync below
+        return JP_NONE;
+    }
+    if (d->len < 2 || d->len < frame_length(d->buf[1]))
+        return JP_NONE;
+
+    uint8_t n = d->len;
+    if (jp_crc8(&d->buf[1], n - 2) != d->buf[n - 1]) {
+        d->crcErrors++;
+        d->len = 0xFF;
+        return JP_NONE;
+    }
+
+    if (d->buf[1] & JP_FLAG_XY) {
+        d->x = ((uint16_t)d->buf[2] << 4) | (d->buf[3] >> 4);
+        d->y = ((uint16_t)(d->buf[3] & 0x0F) << 8) | d->buf[4];
+    }
+    d->len = 0;
+    return d->buf[1] & 0x7F;
+}
+
+uint8_t jp_decode(jp_decoder_t *d, uint8_t byte)
+{
+    // Bytes still to be fed. A bad frame is dropped by replaying everything
+    // after its SYNC, so a SYNC byte hidden inside it can start the next
+    // frame. Each replay discards one byte, so this never exceeds a frame.
+    uint8_t pending[JP_FRAME_MAX];
+    uint8_t count = 1, next = 0;
+    uint8_t ev = JP_NONE;
+
+    pending[0] = byte;
+    while (next < count) {
+        uint8_t b = pending[next++];
+        uint8_t len = d->len;
+        uint8_t r = decode_byte(d, b);
+
+        if (d->len != 0xFF) {
+            if (r != JP_NONE) ev = r;
+            continue;
+        }
+
+        uint8_t replay[JP_FRAME_MAX];
+        uint8_t n = 0;
+        for (uint8_t i = 1; i < len; i++) replay[n++] = d->buf[i];
+        replay[n++] = b;
+        while (next < count) replay[n++] = pending[next++];
+
+        for (uint8_t i = 0; i < n; i++) pending[i] = replay[i];
+        count = n;
+        next = 0;
+        d->len = 0;
+    }
+    return ev;
+}
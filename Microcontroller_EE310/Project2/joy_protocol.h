@@ -0,0 +1,82 @@
+/* 
+ * File:   joy_protocol.h
+ * Binary event frames between the PIC joystick sender (MCC_UART.c) and the
+ * ESP8266 bridge (ESP8266_WiFi.cpp). Both sides build joy_protocol.c.
+ *
+ * Frame:   SYNC | EVENT | [X/Y: 3 bytes] | CRC-8
+ *   SYNC   0xA5, never a valid ASCII byte, so frames and the old text
+ *          lines can share the link.
+ *   EVENT  event code; bit 7 set means 12-bit X and Y follow, packed
+ *          as XXXXXXXX XXXXYYYY YYYYYYYY.
+ *   CRC-8  polynomial 0x07 over EVENT and the X/Y bytes.
+ *
+ * Mode negotiation: the PIC starts in ASCII mode. The ESP8266 sends a
+ * HELLO frame until it sees a binary frame back; a PIC that receives HELLO
+ * switches to binary. If the PIC RX line is not wired, both stay on ASCII.
+ *
+ * Wire time per event (8N1, 10 bits per byte):
+ *   message                 bytes    9600 baud    115200 baud
+ *   "RIGHT (button)\r\n"      16    16.667 ms      1.389 ms
+ *   "CENTER\r\n"               8     8.333 ms      0.694 ms
+ *   binary frame               3     3.125 ms      0.260 ms
+ *   binary frame + X/Y         6     6.250 ms      0.521 ms
+ */
+
+#ifndef JOY_PROTOCOL_H
+#define	JOY_PROTOCOL_H
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define JP_SYNC          0xA5
+#define JP_FLAG_XY       0x80
+#define JP_FRAME_MAX     6
+
+// Event codes (same order as SerialEvent on the ESP8266)
+#define JP_EV_HELLO      0x00
+#define JP_EV_JOY_LEFT   0x01
+#define JP_EV_JOY_RIGHT  0x02
+#define JP_EV_JOY_UP     0x03
+#define JP_EV_JOY_DOWN   0x04
+#define JP_EV_JOY_CENTER 0x05
+#define JP_EV_BTN_LEFT   0x06
+#define JP_EV_BTN_RIGHT  0x07
+#define JP_EV_BTN_UP     0x08
+#define JP_EV_BTN_DOWN   0x09
+#define JP_EV_BTN_CENTER 0x0A
+#define JP_EV_MAX        JP_EV_BTN_CENTER
+
+#define JP_NONE          0xFF   // jp_decode(): no complete frame yet
+
+typedef struct {
+    uint8_t buf[JP_FRAME_MAX];  // frame bytes received so far (buf[0] = SYNC)
+    uint8_t len;
+    uint16_t x, y;              // X/Y of the last frame that carried them
+    uint16_t crcErrors;
+} jp_decoder_t;
+
+uint8_t jp_crc8(const uint8_t *data, uint8_t len);
+
+// Write a frame into out (at least JP_FRAME_MAX bytes); returns its length.
+uint8_t jp_encode(uint8_t *out, uint8_t event);
+uint8_t jp_encode_xy(uint8_t *out, uint8_t event, uint16_t x, uint16_t y);
+
+void jp_decoder_init(jp_decoder_t *d);
+
+// Nonzero while the decoder is inside a frame; bytes that arrive while it is
+// idle and are not JP_SYNC belong to the ASCII protocol.
+uint8_t jp_decoder_busy(const jp_decoder_t *d);
+
+// Feed one byte. Returns the event code when a frame with a good CRC ends,
+// JP_NONE otherwise. A bad frame is dropped and the decoder resyncs on the
+// next SYNC byte inside it.
+uint8_t jp_decode(jp_decoder_t *d, uint8_t byte);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* JOY_PROTOCOL_H */
@@ -0,0 +1,72 @@
+#include "serial_parser.h"
+#include <string.h>
+
+static const char *const labels[] = {
+  "WAIT",
+  "LEFT", "RIGHT", "UP", "DOWN", "CENTER",
+  "LEFT (button)", "RIGHT (button)", "UP (button)", "DOWN (button)", "CENTER (button)",
+  "?"
+};
+
+static const char *const directions[] = { "LEFT", "RIGHT", "UP", "DOWN", "CENTER" };
+
+#define BUTTON_SUFFIX     " (button)"
+#define BUTTON_SUFFIX_LEN 9
+
+void parserInit(LineParser *p) {
+  p->len = 0;
+  p->overflow = false;
+}
+
+// Classifies a trimmed line of n characters.
+static SerialEvent classify(const char *s, uint8_t n) {
+  uint8_t offset = EV_JOY_LEFT;
+
+  if (n > BUTTON_SUFFIX_LEN &&
+      memcmp(s + n - BUTTON_SUFFIX_LEN, BUTTON_SUFFIX, BUTTON_SUFFIX_LEN) == 0) {
+    n -= BUTTON_SUFFIX_LEN;
+    offset = EV_BTN_LEFT;
+  }
+
+  for (uint8_t i = 0; i < 5; i++) {
+    if (strlen(directions[i]) == n && memcmp(s, directions[i], n) == 0)
+      return (SerialEvent)(offset + i);
+  }
+  return EV_UNKNOWN;
+}
+
+SerialEvent parserFeed(LineParser *p, char c) {
+  if (c == '\n') {
+    SerialEvent ev = EV_NONE;
+
+    if (!p->overflow) {
+      // Trim the '\r' and any padding the sender left around the message.
+      const char *s = p->buf;
+      uint8_t n = p->len;
+      while (n > 0 && (s[0] == ' ' || s[0] == '\r')) { s++; n--; }
+      while (n > 0 && (s[n - 1] == ' ' || s[n - 1] == '\r')) n--;
+      if (n > 0) ev = classify(s, n);
+    } else {
+      ev = EV_UNKNOWN;
+    }
+
+    parserInit(p);
+    return ev;
+  }
+
+  if (p->len < LINE_BUF_SIZE)
+    p->buf[p->len++] = c;
+  else
+    p->overflow = true;
+
+  return EV_NONE;
+}
+
+bool eventIsButton(SerialEvent ev) {
+  return ev >= EV_BTN_LEFT && ev <= EV_BTN_CENTER;
+}
+
+const char *eventLabel(SerialEvent ev) {
+  if (ev > EV_UNKNOWN) ev = EV_UNKNOWN;
+  return labels[ev];
+}
@@ -0,0 +1,44 @@
+#ifndef SERIAL_PARSER_H
+#define SERIAL_PARSER_H
+
+#include <stdint.h>
+
+// === Messages from the PIC (MCC_UART.c) ===
+// "LEFT\r\n" ... "CENTER\r\n" for the joystick, "UP (button)\r\n" for buttons.
+enum SerialEvent : uint8_t {
+  EV_NONE = 0,          // no complete line yet
+  EV_JOY_LEFT,
+  EV_JOY_RIGHT,
+  EV_JOY_UP,
+  EV_JOY_DOWN,
+  EV_JOY_CENTER,
+  EV_BTN_LEFT,
+  EV_BTN_RIGHT,
+  EV_BTN_UP,
+  EV_BTN_DOWN,
+  EV_BTN_CENTER,
+  EV_UNKNOWN            // complete line that is not a known message
+};
+
+// Longest valid line is "CENTER (button)" (15 chars); anything longer is
+// discarded up to the next '\n'.
+#define LINE_BUF_SIZE 24
+
+struct LineParser {
+  char buf[LINE_BUF_SIZE];
+  uint8_t len;
+  bool overflow;
+};
+
+void parserInit(LineParser *p);
+
+// Feed one received byte. Returns the classified event when c ends a line,
+// EV_NONE otherwise. Never blocks and never allocates.
+SerialEvent parserFeed(LineParser *p, char c);
+
+bool eventIsButton(SerialEvent ev);
+
+// Text shown on the OLED / sent to the browser ("WAIT" for EV_NONE).
+const char *eventLabel(SerialEvent ev);
+
+#endif
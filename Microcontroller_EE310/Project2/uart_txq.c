@@ -0,0 +1,43 @@
+#include "uart_txq.h"
+
+void txq_init(txq_t *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->overflows = 0;
+    q->droppedBytes = 0;
+}
+
+uint8_t txq_used(const txq_t *q)
+{
+    return (uint8_t)(q->head - q->tail);
+}
+
+uint8_t txq_push(txq_t *q, const uint8_t *data, uint8_t len)
+{
+    uint8_t head = q->head;
+
+    if (len > TXQ_SIZE - txq_used(q)) {
+        q->overflows++;
+        q->droppedBytes += len;
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < len; i++)
+        q->buf[(uint8_t)(head + i) & (TXQ_SIZE - 1)] = data[i];
+
+    q->head = head + len;   // publish only after the bytes are in place
+    return 1;
+}
+
+uint8_t txq_pop(txq_t *q, uint8_t *byte)
+{
+    uint8_t tail = q->tail;
+
+    if (tail == q->head)
+        return 0;
+
+    *byte = q->buf[tail & (TXQ_SIZE - 1)];
+    q->tail = tail + 1;
+    return 1;
+}
@@ -0,0 +1,44 @@
+/* 
+ * File:   uart_txq.h
+ * Fixed-size transmit queue shared between the main loop (producer) and
+ * the UART1 TX interrupt (consumer). Pure C with no register access, so
+ * the same file builds on the PIC and on a PC.
+ */
+
+#ifndef UART_TXQ_H
+#define	UART_TXQ_H
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define TXQ_SIZE 64     // must be a power of two, at most 128
+
+// head is only written by txq_push() and tail only by txq_pop(). Both are
+// free-running 8-bit counters, so each update is a single byte write and
+// the queue needs no interrupt masking on the PIC18.
+typedef struct {
+    uint8_t buf[TXQ_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    uint16_t overflows;      // messages rejected because the queue was full
+    uint16_t droppedBytes;   // bytes in those messages
+} txq_t;
+
+void txq_init(txq_t *q);
+uint8_t txq_used(const txq_t *q);
+
+// Queue a whole message or nothing. Returns 1 if queued, 0 on overflow
+// (counted in overflows/droppedBytes); never waits.
+uint8_t txq_push(txq_t *q, const uint8_t *data, uint8_t len);
+
+// Take the next byte. Returns 0 if the queue is empty.
+uint8_t txq_pop(txq_t *q, uint8_t *byte);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* UART_TXQ_H */
@@ -0,0 +1,79 @@
+const joyCanvas = document.getElementById('canvasJoy');
+const btnCanvas = document.getElementById('canvasBtn');
+const joyCtx = joyCanvas.getContext('2d');
+const btnCtx = btnCanvas.getContext('2d');
+
+const gridSize = 15;
+const canvasSize = 150;
+
+let joySnake = [{x: 75, y: 75}];
+let btnSnake = [{x: 75, y: 75}];
+let joyDir = 'RIGHT';
+let btnDir = 'RIGHT';
+let joyGameOver = false;
+let btnGameOver = false;
+
+function drawSnake(ctx, snake) {
+  ctx.clearRect(0, 0, canvasSize, canvasSize);
+  ctx.fillStyle = 'black';
+  snake.forEach(p => ctx.fillRect(p.x, p.y, gridSize, gridSize));
+}
+
+function moveSnake(snake, direction, ctx, gameFlag) {
+  if (gameFlag.value) return;
+
+  const head = {...snake[0]};
+  if (direction === 'UP') head.y -= gridSize;
+  if (direction === 'DOWN') head.y += gridSize;
+  if (direction === 'LEFT') head.x -= gridSize;
+  if (direction === 'RIGHT') head.x += gridSize;
+
+  if (head.x < 0 || head.x >= canvasSize || head.y < 0 || head.y >= canvasSize) {
+    gameFlag.value = true;
+    ctx.fillStyle = 'red';
+    ctx.font = '14px Arial';
+    ctx.fillText('Game Over', 30, 75);
+    setTimeout(() => {
+      snake.splice(0, snake.length, {x: 75, y: 75});
+      gameFlag.value = false;
+    }, 2000);
+    return;
+  }
+
+  snake.unshift(head);
+  snake.pop();
+  drawSnake(ctx, snake);
+}
+
+function parseDir(text) {
+  if (text.includes('LEFT')) return 'LEFT';
+  if (text.includes('RIGHT')) return 'RIGHT';
+  if (text.includes('UP')) return 'UP';
+  if (text.includes('DOWN')) return 'DOWN';
+  return null;
+}
+
+const source = new EventSource('/events');
+
+source.addEventListener('joystick', e => {
+  document.getElementById('joystick').innerText = e.data;
+  joyDir = parseDir(e.data) || joyDir;
+});
+
+source.addEventListener('button', e => {
+  document.getElementById('button').innerText = e.data;
+  btnDir = parseDir(e.data) || btnDir;
+});
+
+setInterval(() => moveSnake(joySnake, joyDir, joyCtx, {
+  get value() { return joyGameOver; },
+  set value(v) { joyGameOver = v; }
+}), 200);
+
+setInterval(() => moveSnake(btnSnake, btnDir, btnCtx, {
+  get value() { return btnGameOver; },
+  set value(v) { btnGameOver = v; }
+}), 200);
+
+drawSnake(joyCtx, joySnake);
+drawSnake(btnCtx, btnSnake);
@@ -0,0 +1,98 @@
+// Generated by embed_assets.py from web/ -- do not edit.
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// index.html: 898 bytes, 455 gzipped
+#define INDEX_HTML_ETAG "\"a07a55b7cd780593\""
+const size_t INDEX_HTML_GZ_LEN = 455;
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x53, 0xc1, 0x6e, 0xdb, 0x30,
+  0x0c, 0xbd, 0xe7, 0x2b, 0xb4, 0x5e, 0x74, 0x99, 0xe3, 0x34, 0xc0, 0x8a, 0x21, 0x93, 0x0d, 0xac,
+  0x6b, 0x31, 0x6c, 0x97, 0x15, 0x68, 0x81, 0x61, 0x47, 0x5a, 0x52, 0x1c, 0x36, 0xb2, 0x6c, 0x48,
+  0x4c, 0x9a, 0x60, 0xe8, 0xbf, 0x8f, 0xb2, 0xdc, 0xa0, 0x2b, 0x5a, 0x60, 0x87, 0x1d, 0x6c, 0x88,
+  0x8f, 0x7c, 0x8f, 0xf4, 0xa3, 0xac, 0xde, 0x5d, 0xfd, 0xf8, 0x72, 0xf7, 0xeb, 0xe6, 0x5a, 0x6c,
+  0xa8, 0x73, 0xb5, 0x9a, 0xde, 0x16, 0x4c, 0xad, 0x08, 0xc9, 0xd9, 0xfa, 0xfa, 0xf6, 0xe6, 0xe3,
+  0xf2, 0xe2, 0x42, 0xdc, 0x7a, 0xd8, 0x5a, 0x55, 0x66, 0x70, 0xa6, 0x3a, 0x4b, 0x20, 0x3c, 0x74,
+  0xb6, 0x92, 0x7b, 0xb4, 0x0f, 0x43, 0x1f, 0x48, 0x0a, 0xdd, 0x7b, 0xb2, 0x9e, 0x2a, 0xf9, 0x80,
+  0x86, 0x36, 0x95, 0xb1, 0x7b, 0xd4, 0xb6, 0x18, 0x83, 0xf7, 0x02, 0x3d, 0x12, 0x82, 0x2b, 0xa2,
+  0x06, 0x67, 0xab, 0xf3, 0xf9, 0x42, 0xb2, 0x4c, 0xa4, 0x63, 0x92, 0x13, 0xa2, 0xe9, 0xcd, 0x51,
+  0xfc, 0xe6, 0x83, 0x10, 0x06, 0xe3, 0xe0, 0xe0, 0xb8, 0x12, 0x6b, 0x67, 0x0f, 0x9f, 0x46, 0x28,
+  0x9d, 0x0a, 0x83, 0xc1, 0x6a, 0xc2, 0xde, 0xaf, 0xb8, 0x91, 0xdb, 0x75, 0x3e, 0xe7, 0xc0, 0x61,
+  0xeb, 0x0b, 0x24, 0xdb, 0x45, 0x4e, 0x70, 0x7b, 0x1b, 0x26, 0x12, 0x4f, 0x53, 0xac, 0xa1, 0x43,
+  0xc7, 0x5a, 0x11, 0x7c, 0x2c, 0xa2, 0x0d, 0xb8, 0xce, 0x49, 0xb2, 0x07, 0x2a, 0x46, 0xea, 0xdf,
+  0xa4, 0x0e, 0x42, 0x8b, 0x8c, 0x2d, 0x72, 0x38, 0x80, 0x31, 0xe8, 0xdb, 0x29, 0x7e, 0xe4, 0x67,
+  0xae, 0xc1, 0xef, 0x21, 0x16, 0xe9, 0x5b, 0x01, 0xbd, 0x0d, 0xff, 0x79, 0xea, 0x16, 0x86, 0x95,
+  0x58, 0x2e, 0x86, 0xc3, 0xf3, 0x79, 0x0a, 0xea, 0x19, 0x3d, 0x9f, 0xd0, 0x34, 0x46, 0x9e, 0x62,
+  0xea, 0xdd, 0xf4, 0xc1, 0xd8, 0xc0, 0xb4, 0xe1, 0x20, 0x62, 0xef, 0xd0, 0x88, 0xc6, 0x81, 0xde,
+  0x66, 0x85, 0xd1, 0x7e, 0x26, 0x7f, 0x38, 0x69, 0x6e, 0x2c, 0xb6, 0x1b, 0x7a, 0x06, 0x3d, 0xce,
+  0x54, 0x39, 0x6d, 0x42, 0x95, 0x79, 0xf9, 0x69, 0x1f, 0x1c, 0x6d, 0x96, 0xa7, 0x0b, 0x70, 0xb5,
+  0x03, 0x97, 0x6f, 0x81, 0xf8, 0xca, 0x7b, 0xe7, 0xc2, 0x25, 0x17, 0x18, 0xdc, 0x73, 0x71, 0xfd,
+  0xbd, 0x3f, 0x46, 0x42, 0xbd, 0x5d, 0xa9, 0xb2, 0xa9, 0x85, 0x8a, 0x03, 0x78, 0x81, 0xa6, 0x92,
+  0xf7, 0x13, 0x2e, 0xeb, 0x9f, 0x9f, 0xbf, 0xdd, 0x71, 0x17, 0x4e, 0xd4, 0xaa, 0x4c, 0xac, 0x13,
+  0xf7, 0x72, 0x47, 0xc4, 0xf6, 0xbc, 0x60, 0x36, 0x23, 0xfa, 0x16, 0x4f, 0x68, 0x07, 0x31, 0x56,
+  0x67, 0x2f, 0x97, 0x71, 0x96, 0xee, 0x92, 0x9a, 0xcc, 0x49, 0x32, 0xf9, 0xc8, 0xe3, 0xc9, 0x6c,
+  0x44, 0x25, 0xf9, 0xab, 0xe5, 0x64, 0x41, 0x0e, 0x58, 0x37, 0x57, 0xbd, 0xce, 0xbd, 0x24, 0xff,
+  0x4f, 0xdc, 0xa7, 0xe9, 0xa2, 0x0e, 0x38, 0x90, 0x88, 0x41, 0x57, 0xb2, 0x6c, 0xd9, 0xa9, 0xf9,
+  0x7d, 0x4c, 0x75, 0x19, 0x4f, 0x75, 0xa3, 0xb7, 0xec, 0x5f, 0xfa, 0xd7, 0x66, 0x7f, 0x00, 0xe1,
+  0xa0, 0x44, 0xd7, 0x82, 0x03, 0x00, 0x00,
+};
+
+// game.js: 2186 bytes, 800 gzipped
+#define GAME_JS_ETAG "\"9eba1b8de691578b\""
+const size_t GAME_JS_GZ_LEN = 800;
+const uint8_t GAME_JS_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x55, 0xdf, 0x4f, 0xdb, 0x30,
+  0x10, 0x7e, 0xef, 0x5f, 0xe1, 0xb7, 0x24, 0x9a, 0x97, 0x15, 0x36, 0x84, 0xb4, 0xae, 0x48, 0x03,
+  0xca, 0xc6, 0x84, 0xc6, 0x44, 0x3b, 0xed, 0x01, 0xf1, 0x60, 0x12, 0xb7, 0xcd, 0x70, 0x9d, 0xc8,
+  0x71, 0x42, 0xb3, 0xd2, 0xff, 0x7d, 0xe7, 0x9f, 0x69, 0xb6, 0x14, 0x90, 0x2a, 0xd5, 0xf6, 0x7d,
+  0x77, 0xfe, 0xee, 0xf2, 0xdd, 0x39, 0xc9, 0x79, 0x29, 0xd1, 0xef, 0xbc, 0x39, 0x23, 0xbc, 0x26,
+  0x25, 0x1a, 0xa3, 0x34, 0x4f, 0xaa, 0x15, 0xe5, 0x32, 0x5e, 0x50, 0x39, 0x61, 0x54, 0x2d, 0x4f,
+  0x9b, 0xcb, 0x34, 0x0c, 0x12, 0x8d, 0xf8, 0x96, 0x37, 0x41, 0x34, 0x1a, 0x24, 0xda, 0xef, 0x5e,
+  0xf2, 0xd7, 0xfa, 0x9d, 0x4a, 0xde, 0xfa, 0xa9, 0xfb, 0xe4, 0x1a, 0x9c, 0xfc, 0xc5, 0xca, 0xeb,
+  0x2c, 0xe7, 0x92, 0xae, 0x65, 0x18, 0x1c, 0xa6, 0xdd, 0x2b, 0x34, 0xd4, 0xdf, 0xd5, 0x03, 0xb5,
+  0xd8, 0x85, 0xc8, 0xd2, 0x69, 0xf6, 0x87, 0x02, 0xfa, 0xe0, 0xc8, 0x05, 0x30, 0xd7, 0xfb, 0xe3,
+  0x21, 0xa0, 0x19, 0xd5, 0x14, 0xa6, 0x9c, 0x3c, 0xa8, 0xc3, 0xdb, 0xcd, 0xfa, 0x23, 0x3a, 0x3e,
+  0xc2, 0xa8, 0x51, 0x7f, 0xdb, 0xbb, 0x91, 0x06, 0xc0, 0x7d, 0xcf, 0x03, 0x20, 0xc2, 0x79, 0x26,
+  0xc0, 0x1c, 0xdc, 0x5c, 0x7e, 0xf9, 0x3a, 0x0b, 0xbc, 0x5b, 0xcf, 0x29, 0x60, 0xbf, 0x90, 0x15,
+  0xbd, 0xae, 0xa9, 0x32, 0xcd, 0x09, 0x2b, 0xa9, 0x87, 0xff, 0x6f, 0x18, 0xcc, 0x2b, 0x9e, 0xc8,
+  0x2c, 0xe7, 0x28, 0x15, 0xe4, 0x51, 0xb3, 0x08, 0x13, 0xb9, 0xc6, 0xa8, 0x54, 0xcb, 0x08, 0x6d,
+  0x06, 0x08, 0xc1, 0x3e, 0x4e, 0x18, 0x25, 0xe2, 0x86, 0x26, 0x32, 0x1c, 0x62, 0x04, 0xbf, 0x36,
+  0xd5, 0xdd, 0x35, 0xd4, 0xc7, 0xc0, 0xe7, 0x19, 0x63, 0x53, 0xd9, 0x30, 0x95, 0x52, 0x70, 0xcf,
+  0x48, 0xf2, 0x10, 0x28, 0x93, 0x0e, 0x1a, 0xcf, 0x73, 0x31, 0x21, 0xc9, 0x32, 0x2c, 0xd0, 0xf8,
+  0xc4, 0xa3, 0x75, 0xec, 0x22, 0x86, 0x9b, 0x8b, 0xb8, 0xc1, 0xbe, 0xbe, 0xed, 0x2a, 0x82, 0xe0,
+  0xdb, 0x1d, 0xbe, 0xab, 0xbc, 0xa6, 0x86, 0xaf, 0x8e, 0x8a, 0x51, 0x9a, 0x09, 0xaa, 0x4d, 0x18,
+  0xe9, 0x0c, 0x16, 0x90, 0xec, 0x05, 0x23, 0x0b, 0x93, 0x44, 0x36, 0x47, 0xa1, 0x3b, 0x89, 0x6b,
+  0xc2, 0x2a, 0x48, 0x4e, 0x50, 0x59, 0x09, 0x0e, 0x45, 0x00, 0xd2, 0xfa, 0x03, 0x2e, 0x29, 0x49,
+  0x81, 0xf1, 0x26, 0x8e, 0x63, 0x1d, 0xf4, 0x76, 0x78, 0xb7, 0x1d, 0x59, 0x67, 0x1f, 0x1e, 0x8d,
+  0xc7, 0x90, 0xd4, 0xcf, 0x1f, 0x41, 0xa4, 0xf1, 0x71, 0x83, 0xde, 0x8e, 0x3d, 0xcb, 0x3d, 0xe8,
+  0xf3, 0xeb, 0x5f, 0xdf, 0x5b, 0xfc, 0x9b, 0x17, 0xf1, 0x57, 0x93, 0x8b, 0x99, 0xc3, 0xaf, 0x5f,
+  0x11, 0xdf, 0x08, 0xc0, 0x3b, 0x74, 0x2e, 0xb0, 0x1e, 0xd6, 0xf4, 0x09, 0x0d, 0xd1, 0xd3, 0x93,
+  0x03, 0x9e, 0x8c, 0x77, 0x45, 0xeb, 0xce, 0x9b, 0x0e, 0xaa, 0xe9, 0xa2, 0x4c, 0x39, 0x11, 0xea,
+  0x16, 0x13, 0xaa, 0x26, 0x45, 0xa5, 0xe9, 0xf5, 0x28, 0x40, 0xd0, 0x34, 0xd8, 0x31, 0x41, 0x47,
+  0xa9, 0xd3, 0x83, 0x0f, 0xc5, 0x1a, 0x7d, 0x16, 0x19, 0x61, 0x41, 0xd7, 0x6f, 0xa6, 0xfb, 0x4d,
+  0x89, 0x15, 0x29, 0xb5, 0x06, 0x18, 0xbd, 0x07, 0xc9, 0x1d, 0x1f, 0x45, 0x06, 0x56, 0x52, 0x39,
+  0xcb, 0x56, 0x34, 0xaf, 0x64, 0x18, 0x46, 0x4a, 0x43, 0x86, 0x90, 0x93, 0x57, 0x59, 0xb0, 0x2c,
+  0xa1, 0x4a, 0xa7, 0x66, 0xcf, 0x28, 0x5f, 0xc8, 0x25, 0x46, 0xdd, 0xce, 0xb2, 0xb1, 0x7a, 0xf2,
+  0xb0, 0x9d, 0xa1, 0x6c, 0x5b, 0x8c, 0x0e, 0x87, 0xc3, 0xa1, 0xc5, 0x3a, 0xb9, 0xc0, 0xf9, 0xc0,
+  0x8b, 0xb9, 0xe2, 0xe5, 0x32, 0x9b, 0x4b, 0x5d, 0xde, 0xa8, 0xd5, 0x78, 0x91, 0x17, 0xa1, 0xde,
+  0xf6, 0xb6, 0x55, 0x57, 0xc9, 0x05, 0x11, 0x25, 0x85, 0x4e, 0x0e, 0xd5, 0x9c, 0x69, 0xd5, 0xaa,
+  0x76, 0x71, 0xc6, 0x13, 0x56, 0xa5, 0xb4, 0x0c, 0xad, 0x24, 0x9c, 0x68, 0xad, 0x44, 0x46, 0xfd,
+  0x58, 0x2b, 0x87, 0x16, 0xec, 0x06, 0x44, 0x2f, 0x5a, 0x49, 0xb9, 0x85, 0xc2, 0x6e, 0x0f, 0xce,
+  0x88, 0xb8, 0x45, 0xea, 0xbd, 0xc2, 0xda, 0x03, 0x5e, 0x31, 0xa6, 0x33, 0x33, 0xcd, 0x54, 0xe6,
+  0x95, 0x48, 0x54, 0x41, 0x39, 0x7d, 0x44, 0x93, 0x1a, 0x86, 0xf4, 0x54, 0x9f, 0x84, 0xc1, 0x3b,
+  0xaa, 0x76, 0xa5, 0x1e, 0xa7, 0x06, 0x15, 0x93, 0x34, 0xd5, 0x90, 0xab, 0xac, 0x94, 0x94, 0x53,
+  0x11, 0x06, 0x30, 0xc7, 0x4a, 0x99, 0xc1, 0xe0, 0xc0, 0x88, 0xba, 0x8f, 0xbc, 0x77, 0xf0, 0x7b,
+  0x70, 0x04, 0x7c, 0xc1, 0x5d, 0x29, 0x08, 0x6e, 0xa6, 0x71, 0x4a, 0x24, 0x51, 0x14, 0xfd, 0x04,
+  0xf5, 0xc5, 0x36, 0xb6, 0x48, 0xc9, 0xdc, 0x18, 0x81, 0xfa, 0xb3, 0x84, 0xee, 0x2b, 0x29, 0x73,
+  0xfe, 0x2a, 0x3a, 0x16, 0xba, 0x8f, 0x8c, 0x1f, 0xdc, 0x7d, 0x64, 0x8c, 0xd1, 0x91, 0xa1, 0xf2,
+  0x12, 0x9e, 0x1f, 0x01, 0xda, 0xb4, 0x5a, 0x6f, 0xc7, 0x9e, 0x7b, 0x56, 0xb0, 0xe5, 0x8f, 0xed,
+  0x5b, 0x87, 0x35, 0x37, 0xa0, 0x84, 0xb4, 0xa2, 0xc1, 0x6d, 0xe3, 0xbe, 0xd0, 0xce, 0xdb, 0x30,
+  0x02, 0x71, 0x0f, 0x74, 0x2f, 0x59, 0x58, 0xad, 0x70, 0xdd, 0xc7, 0xa3, 0x06, 0x10, 0xf0, 0xd0,
+  0x4d, 0xf0, 0x12, 0x1b, 0xf7, 0x86, 0x61, 0x9b, 0x00, 0xb6, 0xcf, 0xe9, 0x33, 0x6c, 0x76, 0x1e,
+  0xa4, 0x7e, 0x36, 0xdd, 0x17, 0xeb, 0x5f, 0x36, 0x6d, 0x67, 0xb9, 0xbc, 0x5d, 0x45, 0xc0, 0xda,
+  0x1a, 0x1d, 0x0d, 0x47, 0x10, 0x8c, 0x7f, 0x01, 0x2b, 0xe2, 0x07, 0xb0, 0x8a, 0x08, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,31 @@
+/* 
+ * File:   check.h
+ * Minimal checks for the host tests: CHECK() reports a failed condition
+ * with its line and carries on, check_done() prints the tally and gives
+ * the exit status.
+ */
+
+#ifndef CHECK_H
+#define	CHECK_H
+
+#include <stdio.h>
+
+static int check_count = 0;
+static int check_failures = 0;
+
+#define CHECK(cond) do {                                                \
+        check_count++;                                                  \
+        if (!(cond)) {                                                  \
+            check_failures++;                                           \
+            if (check_failures <= 20)                                   \
+                printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        }                                                               \
+    } while (0)
+
+static int check_done(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, check_count, check_failures);
+    return check_failures ? 1 : 0;
+}
+
+#endif	/* CHECK_H */
@@ -0,0 +1,225 @@
+// Model (not a measurement) of joystick sampling in Project2/MCC_UART.c:
+// the polled ADC1_Read() path (ADC_AUTO_TRIGGER 0) against the TMR2
+// auto-triggered ADC1_ISR() path, for sample jitter and CPU occupancy.
+//
+// Both run the same main-loop workload in virtual microseconds. At
+// FOSC 4 MHz one instruction cycle is 1 us, so cycles and us are the same
+// number here. The ADCC timing follows ADC1_Initialize() and
+// ADC1_Start_Auto(); the rest are stated assumptions, not something
+// measured on the PIC:
+//
+//   TAD_US        ADCRC clock period (CS = 1)
+//   CONV_TAD      one 12-bit conversion
+//   READ_CYCLES   ADC1_Read() call, ADPCH, ACLR and result, besides the waits
+//   ISR_CYCLES    ADC1_ISR() with vectored entry and return
+//   LOOP_CYCLES   one pass of the loop with nothing to report
+//   SEND_CYCLES   Send_Event() into the TX queue
+//   LCD_CYCLES    lcd_printf_at() formatting "X:%4u Y:%4u"
+//
+// The stick moves every 150..1500 ms (one Send_Event) and a button is
+// pressed every 2..10 s (a 5 ms __delay_ms debounce), in the quiet run;
+// the busy run moves it every 20..200 ms and presses every 0.3..2 s.
+// Other interrupts (U1TX, the LCD tick) are left out; they delay the
+// polled reads but not the hardware-triggered conversions.
+//
+// Reported per path: the interval between successive X samples (the start
+// of the X burst), its standard deviation and range, and where the CPU
+// time goes. Checked: the auto-triggered interval is exactly 1 ms, the ISR
+// ends before the next trigger, and it takes less CPU than the polled
+// reads' busy-waits.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "check.h"
+
+#define SIM_US          60000000ull     // one minute
+#define BURST           8               // adc_filter_init(3)
+#define TAD_US          2               // assumed: ADCRC typical
+#define CONV_TAD        15              // assumed: 12-bit conversion with hold
+#define ACQ_TAD         8               // ADACQ in ADC1_Start_Auto()
+#define TRIGGER_US      500             // TMR2 period, FCY_COUNTS(500, 4)
+#define READ_CYCLES     30              // assumed
+#define ISR_CYCLES      40              // assumed: counted from the C, not a listing
+#define LOOP_CYCLES     250             // assumed: hello check, classify, buttons
+#define SEND_CYCLES     300             // assumed
+#define LCD_CYCLES      4000            // assumed
+#define DEBOUNCE_US     5000            // __delay_ms(5) after a button edge
+#define LCD_EVERY       1000            // lcd_counter threshold in the main loop
+
+// One ADC1_Read(): the 5 us settle, then a burst of back-to-back
+// conversions with no acquisition time between them (ADACQ = 0)
+#define POLL_WAIT_US    (5 + BURST * CONV_TAD * TAD_US)
+// One triggered burst: ADACQ before every conversion
+#define AUTO_BURST_US   (BURST * (ACQ_TAD + CONV_TAD) * TAD_US)
+
+static uint32_t seed;
+
+static uint32_t rnd(uint32_t n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % n;
+}
+
+typedef struct {
+    const char *name;
+    uint32_t moveMin, moveMax;      // ms between stick moves
+    uint32_t pressMin, pressMax;    // ms between button presses
+} load_t;
+
+// The main loop's own work after a pair is read, for the pass at time t
+static uint64_t nextMove, nextPress;
+static uint32_t lcdCounter;
+
+static uint32_t loopWork(const load_t *ld, uint64_t t)
+{
+    uint32_t us = LOOP_CYCLES;
+
+    if (++lcdCounter > LCD_EVERY) {
+        us += LCD_CYCLES;
+        lcdCounter = 0;
+    }
+    if (t >= nextMove) {
+        us += SEND_CYCLES;
+        nextMove = t + 1000ull * (ld->moveMin + rnd(ld->moveMax - ld->moveMin + 1));
+    }
+    if (t >= nextPress) {
+        us += DEBOUNCE_US + SEND_CYCLES;
+        nextPress = t + 1000ull * (ld->pressMin + rnd(ld->pressMax - ld->pressMin + 1));
+    }
+    return us;
+}
+
+typedef struct {
+    long samples;
+    double meanUs, sdUs;
+    uint64_t minUs, maxUs;
+    uint64_t adcUs;                 // busy-waiting on the ADC, or in the ISR
+    uint64_t idleUs;                // waiting for a pair (auto only)
+    long pairsUsed, pairsSkipped;   // auto only
+} stats_t;
+
+static void interval(stats_t *s, uint64_t *last, uint64_t at, double *sum, double *sq)
+{
+    if (*last) {
+        uint64_t d = at - *last;
+        if (d < s->minUs) s->minUs = d;
+        if (d > s->maxUs) s->maxUs = d;
+        *sum += (double)d;
+        *sq += (double)d * d;
+        s->samples++;
+    }
+    *last = at;
+}
+
+static void finish(stats_t *s, double sum, double sq)
+{
+    s->meanUs = sum / s->samples;
+    s->sdUs = sqrt(sq / s->samples - s->meanUs * s->meanUs);
+}
+
+// ADC_AUTO_TRIGGER 0: Read_Joystick() reads X, then Y, every pass
+static stats_t runPolled(const load_t *ld)
+{
+    stats_t s = { 0, 0, 0, UINT64_MAX, 0, 0, 0, 0, 0 };
+    uint64_t t = 1, lastX = 0;
+    double sum = 0, sq = 0;
+
+    seed = 99;
+    nextMove = nextPress = 0;
+    lcdCounter = 0;
+    while (t < SIM_US) {
+        t += READ_CYCLES + 5;
+        interval(&s, &lastX, t, &sum, &sq);     // X burst starts
+        t += POLL_WAIT_US - 5 + READ_CYCLES;    // rest of X, then Y
+        t += POLL_WAIT_US;
+        s.adcUs += 2 * POLL_WAIT_US;
+        t += loopWork(ld, t);
+    }
+    finish(&s, sum, sq);
+    return s;
+}
+
+// ADC_AUTO_TRIGGER 1: TMR2 starts a burst every 500 us, X and Y in turn.
+// Pair k is complete when the ISR for its Y burst returns; the loop takes
+// the newest pair, or idles until the next one, and every ISR that fires
+// during a pass adds its cycles to that pass.
+#define PAIR_DONE_US(k) \
+    ((uint64_t)(k) * 2 * TRIGGER_US + TRIGGER_US + AUTO_BURST_US + ISR_CYCLES)
+
+static stats_t runAuto(const load_t *ld, uint32_t *isrEndUs)
+{
+    stats_t s = { 0, 0, 0, UINT64_MAX, 0, 0, 0, 0, 0 };
+    uint64_t t = 0, lastX = 0, nextIsr = AUTO_BURST_US;
+    int64_t used = -1;
+    double sum = 0, sq = 0;
+
+    seed = 99;
+    nextMove = nextPress = 0;
+    lcdCounter = 0;
+    *isrEndUs = AUTO_BURST_US + ISR_CYCLES;     // after its trigger
+    for (uint64_t trig = 0; trig < SIM_US; trig += 2 * TRIGGER_US)
+        interval(&s, &lastX, trig + ACQ_TAD * TAD_US, &sum, &sq);
+
+    while (t < SIM_US) {
+        if (t < PAIR_DONE_US(used + 1)) {
+            s.idleUs += PAIR_DONE_US(used + 1) - t;     // power_idle()
+            t = PAIR_DONE_US(used + 1);
+        }
+        int64_t newest = (int64_t)((t - PAIR_DONE_US(0)) / (2 * TRIGGER_US));
+        s.pairsSkipped += newest - used - 1;
+        s.pairsUsed++;
+        used = newest;
+
+        t += loopWork(ld, t);
+        for (; nextIsr < t; nextIsr += TRIGGER_US)
+            t += ISR_CYCLES;
+    }
+    s.adcUs = SIM_US / TRIGGER_US * ISR_CYCLES;
+    finish(&s, sum, sq);
+    return s;
+}
+
+static void report(const char *path, const stats_t *s)
+{
+    printf("  %-7s X every %6.0f us, sd %6.1f us, %5llu..%5llu us;"
+           " ADC %4.1f%% of the CPU, idle %4.1f%%",
+           path, s->meanUs, s->sdUs, (unsigned long long)s->minUs,
+           (unsigned long long)s->maxUs, 100.0 * s->adcUs / SIM_US,
+           100.0 * s->idleUs / SIM_US);
+    if (s->pairsUsed)
+        printf(", %ld pairs used, %ld skipped", s->pairsUsed, s->pairsSkipped);
+    printf("\n");
+}
+
+static void runLoad(const load_t *ld)
+{
+    uint32_t isrEnd;
+    stats_t polled = runPolled(ld);
+    stats_t autoTrig = runAuto(ld, &isrEnd);
+
+    printf("%s load\n", ld->name);
+    report("polled", &polled);
+    report("auto", &autoTrig);
+
+    CHECK(autoTrig.minUs == 2 * TRIGGER_US && autoTrig.maxUs == 2 * TRIGGER_US);
+    CHECK(autoTrig.sdUs < 1e-6);
+    CHECK(polled.sdUs > autoTrig.sdUs);
+    CHECK(polled.maxUs > polled.minUs);
+    CHECK(autoTrig.adcUs < polled.adcUs);
+    CHECK(isrEnd < TRIGGER_US);         // ADPCH is set before the next trigger
+}
+
+int main(void)
+{
+    static const load_t loads[] = {
+        { "quiet", 150, 1500, 2000, 10000 },
+        { "busy", 20, 200, 300, 2000 },
+    };
+
+    printf("model: polled read %d us of busy-wait per axis, triggered burst %d us + "
+           "%d-cycle ISR\n", POLL_WAIT_US, AUTO_BURST_US, ISR_CYCLES);
+    for (unsigned i = 0; i < sizeof loads / sizeof loads[0]; i++)
+        runLoad(&loads[i]);
+    return check_done("model_adc_trigger");
+}
@@ -0,0 +1,265 @@
+// Model (not a measurement) of the /events stream in ESP8266_WiFi.cpp:
+// the load against the old 100 ms polling of /joystick and /button, and
+// the delay loop() adds between a line or frame arriving and events.send().
+//
+// A mock serial source plays a minute of PIC traffic at 9600 baud, ASCII
+// lines and bursts of binary frames, through the real line parser and
+// frame decoder. Everything else is a stated assumption, not something
+// measured on the ESP8266:
+//
+//   HTTP_REQ_BYTES, HTTP_RESP_BYTES, HTTP_ALLOCS  typical browser GET and
+//       AsyncWebServer reply; the SSE messages are sized the way
+//       AsyncEventSource formats them
+//   REDRAW_US  an SSD1306 frame, 1 KB over 400 kHz I2C
+//   SEND_US    one events.send() per client
+//
+// loop() is run in virtual time twice: as it was, with a "Received:" echo
+// and a full OLED redraw for every event inside the serial drain loop, and
+// as it is, sending every pending event first and redrawing once the input
+// is drained, at most every OLED_MIN_MS. A change that arrives while a
+// redraw is in progress still waits for it, so the worst case is one
+// redraw; the checks hold the current loop to that.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "serial_parser.h"
+#include "joy_protocol.h"
+#include "check.h"
+
+#define SIM_MS          60000
+#define POLL_MS         100         // game.js used to poll both routes at this
+#define BYTE_US         1042        // one byte at 9600 baud, 8N1
+#define HTTP_REQ_BYTES  330         // assumed: GET line and browser headers
+#define HTTP_RESP_BYTES 110         // assumed: status line and headers, plus the label
+#define HTTP_ALLOCS     3           // assumed: request, response, header list
+#define REDRAW_US       23000       // assumed: 1024 bytes x 9 bits at 400 kHz
+#define SEND_US         150         // assumed: per client
+#define READ_US         5           // one Serial.read() and parse step
+#define TX_FIFO         128         // ESP8266 UART TX FIFO, for the old echo
+#define OLED_MIN_MS     200         // as in ESP8266_WiFi.cpp
+
+static uint32_t seed = 12345;
+
+static uint32_t rnd(void) {
+  seed = seed * 1103515245u + 12345u;
+  return seed >> 8;
+}
+
+static const char *const lines[] = {
+  "LEFT\r\n", "RIGHT\r\n", "UP\r\n", "DOWN\r\n", "CENTER\r\n",
+  "LEFT (button)\r\n", "RIGHT (button)\r\n", "UP (button)\r\n", "DOWN (button)\r\n",
+};
+
+struct RxByte {
+  uint32_t at_us;               // last bit received
+  uint8_t c;
+};
+
+static RxByte rx[SIM_MS * 1000 / BYTE_US + 1];
+static SerialEvent parsed[SIM_MS * 1000 / BYTE_US + 1];
+static int rxCount = 0;
+static int sentCount = 0;
+
+static void putByte(uint32_t *t, uint8_t c) {
+  *t += BYTE_US;
+  rx[rxCount].at_us = *t;
+  rx[rxCount].c = c;
+  rxCount++;
+}
+
+// ASCII lines every 20..220 ms, mostly joystick moves, and every so often
+// a burst of 2..6 binary frames back to back (a sweep across the stick)
+static void playSource(void) {
+  uint32_t t = 0;
+
+  while (t < (uint32_t)(SIM_MS - 500) * 1000) {
+    if (rnd() % 4 == 0) {
+      int n = 2 + rnd() % 5;
+      for (int i = 0; i < n; i++) {
+        uint8_t frame[JP_FRAME_MAX];
+        uint8_t len = jp_encode(frame, (uint8_t)(JP_EV_JOY_LEFT + rnd() % JP_EV_MAX));
+        for (uint8_t k = 0; k < len; k++)
+          putByte(&t, frame[k]);
+        sentCount++;
+      }
+    } else {
+      const char *line = lines[rnd() % 9 < 6 ? rnd() % 5 : 5 + rnd() % 4];
+      for (const char *c = line; *c; c++)
+        putByte(&t, (uint8_t)*c);
+      sentCount++;
+    }
+    t += (20 + rnd() % 200) * 1000;
+  }
+}
+
+struct LoopStats {
+  int events;
+  double avgMs, p99Ms, worstMs;
+  double within10;              // fraction of events sent within 10 ms
+  double busy;                  // fraction of the minute loop() is not idle
+};
+
+static int cmpDouble(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return x < y ? -1 : x > y;
+}
+
+// loop() in virtual microseconds. perEvent: the old loop (echo and redraw
+// for every event); otherwise the current one.
+static LoopStats runLoop(bool perEvent, int clients) {
+  static double lat[SIM_MS * 1000 / BYTE_US + 1];
+  LineParser parser;
+  jp_decoder_t frames;
+  LoopStats s = {};
+  uint64_t t = 0, busy = 0, lastDraw = 0, txFreeAt = 0;
+  bool dirty = false;
+  int next = 0;
+
+  parserInit(&parser);
+  jp_decoder_init(&frames);
+  while (next < rxCount || dirty) {
+    uint64_t start = t;
+
+    while (next < rxCount && rx[next].at_us <= t) {
+      uint8_t c = rx[next].c;
+      uint32_t at = rx[next].at_us;
+      next++;
+      t += READ_US;
+
+      SerialEvent ev;
+      if (jp_decoder_busy(&frames) || c == JP_SYNC) {
+        uint8_t code = jp_decode(&frames, c);
+        if (code == JP_NONE || code == JP_EV_HELLO) continue;
+        ev = (SerialEvent)code;
+      } else {
+        ev = parserFeed(&parser, (char)c);
+      }
+      if (ev == EV_NONE || ev == EV_UNKNOWN) continue;
+
+      if (perEvent) {
+        // "Received: LABEL\r\n" blocks once the TX FIFO is full
+        int len = 12 + (int)strlen(eventLabel(ev));
+        uint64_t backlog = txFreeAt > t ? (txFreeAt - t + BYTE_US - 1) / BYTE_US : 0;
+        if (backlog + len > TX_FIFO)
+          t += (backlog + len - TX_FIFO) * BYTE_US;
+        txFreeAt = (txFreeAt > t ? txFreeAt : t) + (uint64_t)len * BYTE_US;
+      }
+      parsed[s.events] = ev;
+      lat[s.events++] = (double)(t - at) / 1000.0;
+      t += (uint64_t)SEND_US * clients;
+      if (perEvent)
+        t += REDRAW_US;
+      else
+        dirty = true;
+    }
+
+    bool pending = next < rxCount && rx[next].at_us <= t;
+    if (dirty && !pending && t - lastDraw >= OLED_MIN_MS * 1000ull) {
+      t += REDRAW_US;
+      dirty = false;
+      lastDraw = t;
+    }
+    busy += t - start;
+
+    // Idle: the next pass that has anything to do
+    if (t == start) {
+      uint64_t wake = next < rxCount ? rx[next].at_us : UINT64_MAX;
+      if (dirty && lastDraw + OLED_MIN_MS * 1000ull < wake)
+        wake = lastDraw + OLED_MIN_MS * 1000ull;
+      t = wake > t ? wake : t + 1;
+    }
+  }
+
+  double sum = 0;
+  int fast = 0;
+  for (int i = 0; i < s.events; i++) {
+    sum += lat[i];
+    fast += lat[i] <= 10.0;
+  }
+  qsort(lat, s.events, sizeof lat[0], cmpDouble);
+  s.avgMs = sum / s.events;
+  s.p99Ms = lat[s.events * 99 / 100];
+  s.worstMs = lat[s.events - 1];
+  s.within10 = (double)fast / s.events;
+  s.busy = (double)busy / t;
+  return s;
+}
+
+static int sseBytes(uint32_t id, SerialEvent ev) {
+  char msg[96];
+
+  return snprintf(msg, sizeof msg, "id: %lu\r\nevent: %s\r\ndata: %s\r\n\r\n",
+                  (unsigned long)id, eventIsButton(ev) ? "button" : "joystick",
+                  eventLabel(ev));
+}
+
+static void runClients(int clients) {
+  double seconds = SIM_MS / 1000.0;
+  LoopStats old = runLoop(true, clients);
+  LoopStats now = runLoop(false, clients);
+
+  // Polling: every client asks both routes every POLL_MS; a change waits
+  // for the next poll, half a period on average and a whole one at worst
+  long requests = 2L * clients * (SIM_MS / POLL_MS);
+  long pollBytes = requests * (HTTP_REQ_BYTES + HTTP_RESP_BYTES);
+  double pollWorst = POLL_MS;
+
+  // Stream: every event goes to every client
+  long sseSent = 0;
+  for (int i = 0; i < now.events; i++)
+    sseSent += (long)clients * sseBytes(i + 1, parsed[i]);
+
+  printf("%d client%s  polling: %5.0f req/s %7.0f B/s %5.0f allocs/s  "
+         "delay avg %4.1f ms, worst %5.1f ms\n",
+         clients, clients > 1 ? "s" : " ", requests / seconds, pollBytes / seconds,
+         requests * HTTP_ALLOCS / seconds, POLL_MS / 2.0, pollWorst);
+  printf("           stream:  %5.0f req/s %7.0f B/s %5.0f allocs/s\n",
+         0.0, sseSent / seconds, (double)now.events * clients / seconds);
+  printf("           loop, redraw per event: delay avg %5.1f ms, 99%% %5.1f ms, "
+         "worst %5.1f ms, %3.0f%% within 10 ms, busy %2.0f%%\n",
+         old.avgMs, old.p99Ms, old.worstMs, old.within10 * 100, old.busy * 100);
+  printf("           loop, send then redraw: delay avg %5.1f ms, 99%% %5.1f ms, "
+         "worst %5.1f ms, %3.0f%% within 10 ms, busy %2.0f%%\n",
+         now.avgMs, now.p99Ms, now.worstMs, now.within10 * 100, now.busy * 100);
+
+  CHECK(old.events == sentCount && now.events == sentCount);
+  CHECK(sseSent < pollBytes);
+  CHECK((long)now.events * clients < requests * HTTP_ALLOCS);
+  // At most one redraw (plus the sends queued ahead) between a change
+  // and its send, and most changes see none
+  CHECK(now.worstMs <= (REDRAW_US + 8 * SEND_US * clients) / 1000.0);
+  CHECK(now.avgMs < 10.0);
+  CHECK(now.within10 >= 0.9);
+  CHECK(now.worstMs < old.worstMs && now.avgMs < old.avgMs);
+  CHECK(now.busy < old.busy);
+}
+
+// Host time to parse one line, for scale against the ESP8266's loop.
+static void timeParser(void) {
+  LineParser p;
+  const int rounds = 200000;
+  int seen = 0;
+  clock_t start = clock();
+
+  parserInit(&p);
+  for (int r = 0; r < rounds; r++)
+    for (const char *c = lines[r % 9]; *c; c++)
+      if (parserFeed(&p, *c) != EV_NONE) seen++;
+  double ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / rounds;
+
+  printf("parser: %.0f ns per line on this host\n", ns);
+  CHECK(seen == rounds);
+}
+
+int main(void) {
+  playSource();
+  printf("model, mock source: %d lines and frames in %d s\n", sentCount, SIM_MS / 1000);
+
+  runClients(1);
+  runClients(4);
+  runClients(8);
+  timeParser();
+  return check_done("model_event_stream");
+}
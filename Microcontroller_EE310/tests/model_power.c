@@ -0,0 +1,120 @@
+// Model (not a measurement) of the CPU duty cycle and average MCU current
+// of each C program, with the power.h waits against the spinning loops
+// they replaced.
+//
+// Each program is described by what wakes the CPU, how often, and how long
+// it then runs. Rates come from the code (timer periods, sleep times, task
+// periods); cycle counts are estimates, one cycle per us at FOSC 4 MHz.
+// Between wake-ups the CPU rests in the mode the program uses, idle or
+// sleep; before, it spun at the run current instead. The ADC adds its own
+// current while it converts, in both cases.
+//
+// The currents are assumed round figures of the order the PIC18F47K42
+// data sheet gives at 3.3 V and 25 C, for the MCU alone; the LCD, LEDs,
+// relay and buzzer come on top and are not modelled:
+//
+//   I_RUN_UA    HFINTOSC 4 MHz, CPU running
+//   I_IDLE_UA   HFINTOSC 4 MHz, CPU stopped (IDLEN = 1)
+//   I_SLEEP_UA  sleep on the low-power regulator, LFINTOSC and TMR1 on
+//   I_ADC_UA    the ADCC converting on ADCRC
+//
+// Checked: every program draws less than it did spinning, and the two
+// that sleep between readings are awake less than 1% of the time.
+
+#include <stdio.h>
+#include "check.h"
+
+#define I_RUN_UA        700.0       // assumed
+#define I_IDLE_UA       350.0       // assumed
+#define I_SLEEP_UA      1.0         // assumed
+#define I_ADC_UA        250.0       // assumed
+
+#define CONV_US         30          // one conversion, 15 TAD at 2 us (assumed)
+
+enum { REST_IDLE, REST_SLEEP };
+
+typedef struct {
+    const char *what;
+    double perSecond;
+    double runUs;               // CPU time per occurrence
+} wake_t;
+
+typedef struct {
+    const char *name;
+    int rest;
+    double adcUs;               // ADC converting, us per second
+    wake_t wakes[6];
+} program_t;
+
+static const program_t programs[] = {
+    // power_sleep_ms(500) between readings; the 16-sample read and
+    // LCD_Wait_Idle() both spin
+    { "Lab_12", REST_SLEEP, 2 * 16 * CONV_US, {
+        { "16-sample read", 2, 16 * CONV_US + 30 },
+        { "fmt_mv and frame", 2, 3000 },
+        { "LCD flush, waited out", 2, 8 * 100 },
+    } },
+    { "ADC_Voltage_Reader", REST_SLEEP, 2 * 16 * CONV_US, {
+        { "16-sample read", 2, 16 * CONV_US + 30 },
+        { "fmt_mv and frame", 2, 3000 },
+        { "LCD flush, waited out", 2, 8 * 100 },
+    } },
+    // power_idle(); the display refresh wakes it every ms
+    { "Assigment7_Calculator", REST_IDLE, 0, {
+        { "display refresh ISR", 1000, 47 },            // test_display_mux
+        { "key IOC and debounce ticks", 1, 8 * 40 },
+        { "calc_fsm step and display", 1, 2000 },
+    } },
+    // TMR2 at 977 Hz: the LED toggle and a 4-sample burst per period,
+    // whose ADT interrupt runs the PI update
+    { "Assignment_ADC_LCD", REST_IDLE, 977.0 * 4 * (8 * 2 + CONV_US), {
+        { "TMR2 LED toggle ISR", 977, 15 },
+        { "ADT ISR, PI update", 977, 300 },
+        { "main loop pass", 977, 10 },
+    } },
+    // sched_run() then power_idle(); the 1 ms tick wakes it
+    { "Assignment_8", REST_IDLE, 0, {
+        { "TMR0 tick ISR", 1000, 40 },
+        { "sched_run() scan", 1000, 60 },
+        { "task releases (5/10/10/20 ms)", 450, 100 },
+    } },
+    // Binary mode, idling between ADC pairs (model_adc_trigger)
+    { "MCC_UART", REST_IDLE, 2000 * 8 * (8 * 2 + CONV_US), {
+        { "ADC ISR", 2000, 40 },
+        { "main loop pass", 1000, 250 },
+        { "LCD update", 1, 4000 },
+    } },
+};
+
+#define PROGRAM_COUNT (sizeof programs / sizeof programs[0])
+
+int main(void)
+{
+    printf("%-22s %7s %6s %10s %10s %7s\n", "program", "awake", "rest",
+           "spinning", "now", "saving");
+    for (unsigned p = 0; p < PROGRAM_COUNT; p++) {
+        const program_t *pg = &programs[p];
+        double runUs = 0;
+
+        for (const wake_t *w = pg->wakes; w->what; w++)
+            runUs += w->perSecond * w->runUs;
+
+        double duty = runUs / 1e6;
+        double adc = pg->adcUs / 1e6 * I_ADC_UA;
+        double rest = pg->rest == REST_SLEEP ? I_SLEEP_UA : I_IDLE_UA;
+        double before = I_RUN_UA + adc;
+        double now = duty * I_RUN_UA + (1 - duty) * rest + adc;
+
+        printf("%-22s %6.2f%% %6s %7.0f uA %7.1f uA %6.1fx\n", pg->name, duty * 100,
+               pg->rest == REST_SLEEP ? "sleep" : "idle", before, now, before / now);
+        for (const wake_t *w = pg->wakes; w->what; w++)
+            printf("    %-30s %6.0f/s x %5.0f us = %5.2f%%\n", w->what, w->perSecond,
+                   w->runUs, w->perSecond * w->runUs / 1e4);
+
+        CHECK(duty > 0 && duty < 1);
+        CHECK(now < before);
+        if (pg->rest == REST_SLEEP)
+            CHECK(duty < 0.01);
+    }
+    return check_done("model_power");
+}
@@ -0,0 +1,118 @@
+// Model (not a measurement) of serving / and /game.js in ESP8266_WiFi.cpp:
+// the old handlers, which built a String from a raw literal per request,
+// against sendAsset(), which streams the gzipped PROGMEM copy and answers
+// a matching If-None-Match with 304.
+//
+// The asset sizes are exact: the arrays come from the real web_assets.h,
+// the plain sources from web/, and the old literals are the ones removed
+// from ESP8266_WiFi.cpp. The gzip trailer of each array is checked against
+// its source, so a stale web_assets.h fails here.
+//
+// Heap and latency use stated assumptions, not figures from the board:
+//
+//   RESPONSE_BYTES  an AsyncWebServerResponse object and its bookkeeping
+//   HEADER_NODE     per added header, besides its two strings
+//   MSS, WINDOW     lwIP's low-memory build: 536-byte segments, two in flight
+//   RTT_MS          one round trip to a phone on the soft AP
+//
+// Old heap per request: the String copy of the literal, and the second
+// copy AsyncBasicResponse keeps. Latency: one round trip for the request,
+// then one per window of segments. The literals also sat in DRAM for good,
+// since ESP8266 keeps const data in RAM unless it is PROGMEM.
+
+#include <stdio.h>
+#include <string.h>
+#include "web_assets.h"
+#include "check.h"
+
+#define OLD_INDEX_LITERAL   1113    // raw literal removed from the / handler
+#define OLD_GAME_LITERAL    2575    // raw literal removed from the /game.js handler
+#define RESPONSE_BYTES      120     // assumed
+#define HEADER_NODE         16      // assumed
+#define MSS                 536     // assumed
+#define WINDOW              2       // assumed
+#define RTT_MS              4.0     // assumed
+
+struct Asset {
+  const char *file, *type, *etag;
+  const uint8_t *gz;
+  size_t gzLen, gzSize;
+  long literal;
+};
+
+static const Asset assets[] = {
+  { "index.html", "text/html", INDEX_HTML_ETAG, INDEX_HTML_GZ, INDEX_HTML_GZ_LEN,
+    sizeof INDEX_HTML_GZ, OLD_INDEX_LITERAL },
+  { "game.js", "application/javascript", GAME_JS_ETAG, GAME_JS_GZ, GAME_JS_GZ_LEN,
+    sizeof GAME_JS_GZ, OLD_GAME_LITERAL },
+};
+
+static long fileSize(const char *name) {
+  char path[96];
+  snprintf(path, sizeof path, "../Project2/web/%s", name);
+  FILE *f = fopen(path, "rb");
+  if (!f) return -1;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fclose(f);
+  return n;
+}
+
+// Status line and headers as AsyncWebServer writes them
+static long headerBytes(int code, const char *type, long length, const char *etag) {
+  char h[512];
+  int n = snprintf(h, sizeof h, "HTTP/1.1 %d %s\r\nConnection: close\r\n"
+                   "Accept-Ranges: none\r\nContent-Length: %ld\r\n",
+                   code, code == 200 ? "OK" : "Not Modified", length);
+  if (code == 200)
+    n += snprintf(h + n, sizeof h - n, "Content-Type: %s\r\n", type);
+  if (etag)
+    n += snprintf(h + n, sizeof h - n, "Content-Encoding: gzip\r\n"
+                  "Cache-Control: no-cache\r\nETag: %s\r\n", etag);
+  return n + 2;
+}
+
+static double latencyMs(long bytes) {
+  long segments = (bytes + MSS - 1) / MSS;
+  return RTT_MS * (1 + (segments + WINDOW - 1) / WINDOW);
+}
+
+int main() {
+  long oldHeapPage = 0, newHeapPage = 0, oldStatic = 0;
+
+  printf("%-11s %6s %7s %6s | %-17s | %-23s | %s\n", "asset", "plain", "literal",
+         "gzip", "heap/request", "wire bytes", "latency");
+  for (const Asset &a : assets) {
+    long plain = fileSize(a.file);
+    const uint8_t *t = a.gz + a.gzLen - 4;      // gzip ISIZE, little-endian
+    long isize = t[0] | t[1] << 8 | t[2] << 16 | (long)t[3] << 24;
+
+    CHECK(plain > 0);
+    CHECK(a.gzLen == a.gzSize && a.gz[0] == 0x1f && a.gz[1] == 0x8b);
+    CHECK(isize == plain);
+
+    long oldHeap = 2 * (a.literal + 1) + RESPONSE_BYTES;
+    long newHeap = RESPONSE_BYTES + 3 * HEADER_NODE + (long)strlen("Content-Encoding") +
+                   4 + (long)strlen("Cache-Control") + 8 + 4 + (long)strlen(a.etag);
+    long oldWire = headerBytes(200, a.type, a.literal, nullptr) + a.literal;
+    long newWire = headerBytes(200, a.type, (long)a.gzLen, a.etag) + (long)a.gzLen;
+    long notModified = headerBytes(304, a.type, 0, nullptr);
+
+    printf("%-11s %6ld %7ld %6zu | %6ld -> %4ld B | %5ld -> %4ld, 304 %3ld | "
+           "%4.0f -> %2.0f ms, 304 %2.0f ms\n", a.file, plain, a.literal, a.gzLen,
+           oldHeap, newHeap, oldWire, newWire, notModified,
+           latencyMs(oldWire), latencyMs(newWire), latencyMs(notModified));
+
+    CHECK(newHeap < oldHeap);
+    CHECK(newWire < oldWire && notModified < newWire);
+    CHECK(latencyMs(newWire) <= latencyMs(oldWire));
+    oldHeapPage += oldHeap;
+    newHeapPage += newHeap;
+    oldStatic += a.literal + 1;
+  }
+
+  // A page load fetches both at once, so both responses are live together
+  printf("page load: heap at the peak %ld -> %ld B; literals held in DRAM %ld -> 0 B\n",
+         oldHeapPage, newHeapPage, oldStatic);
+  return check_done("model_web_assets");
+}
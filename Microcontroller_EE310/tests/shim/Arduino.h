@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for <Arduino.h>, for ESP8266 sources that only need the
+ * basic types and PROGMEM (web_assets.h). On the host flash is ordinary
+ * memory, so PROGMEM drops out.
+ */
+
+#ifndef ARDUINO_SHIM_H
+#define	ARDUINO_SHIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROGMEM
+
+#endif	/* ARDUINO_SHIM_H */
@@ -0,0 +1,64 @@
+/*
+ * Host stand-in for <xc.h>, so driver sources that touch PIC18F47K42
+ * registers build into the tests. Each register is a plain variable
+ * defined in xc_shim.c; a test sets inputs and reads outputs directly.
+ * __interrupt() drops the vector attributes, so an ISR becomes an
+ * ordinary function the test calls to play an interrupt. NOP() calls
+ * xc_shim_on_nop if a test sets it, so a mock device can look at the
+ * pins in the middle of a strobe (the LCD's EN pulse). PORTC is read
+ * through xc_shim_read_portc, so a mock (the keypad matrix) can answer
+ * from what the code is driving at that moment. Every access to
+ * ADCON0bits or ADCON2bits first calls xc_shim_on_adc if set, so a mock
+ * ADCC can finish a GO burst or an ACLR the code is waiting on.
+ *
+ * Only the registers the tested sources use are declared. Add more here
+ * and in xc_shim.c as needed.
+ */
+
+#ifndef XC_SHIM_H
+#define	XC_SHIM_H
+
+#include <stdint.h>
+
+#define __interrupt(...)
+#define NOP()           do { if (xc_shim_on_nop) xc_shim_on_nop(); } while (0)
+#define __delay_ms(x)   ((void)0)
+#define __delay_us(x)   ((void)0)
+
+#define XC_SHIM_REGS(X) \
+    X(LATB) X(TRISB) X(ANSELB) \
+    X(LATD) X(TRISD) X(ANSELD) \
+    X(T3CLK) X(T3GCON) X(T3CON) X(TMR3H) X(TMR3L) X(TMR3IF) X(TMR3IE) \
+    X(T0CON0) X(T0CON1) X(TMR0H) X(TMR0L) \
+    X(LATD0) X(LATD1) X(LATD2) \
+    X(T4CLKCON) X(T4HLT) X(T4RST) X(T4PR) X(T4TMR) X(T4CON) X(TMR4IF) X(TMR4IE) \
+    X(LATA) X(TRISA) X(ANSELA) X(ODCONA) X(TRISC) X(ANSELC) X(WPUC) \
+    X(IOCCF) X(IOCCN) X(IOCCP) \
+    X(T6CLKCON) X(T6HLT) X(T6RST) X(T6PR) X(T6TMR) X(T6CON) X(TMR6IF) X(TMR6IE) \
+    X(ADPCH) X(ADRPT) X(ADFLTRH) X(ADFLTRL)
+
+#define XC_SHIM_DECLARE(r) extern volatile uint8_t r;
+XC_SHIM_REGS(XC_SHIM_DECLARE)
+
+extern struct xc_shim_intcon0 { uint8_t GIE; } INTCON0bits;
+extern struct xc_shim_pir3 { uint8_t TMR0IF; } PIR3bits;
+extern struct xc_shim_pie3 { uint8_t TMR0IE; } PIE3bits;
+extern struct xc_shim_trisb { uint8_t TRISB7; } TRISBbits;
+extern struct xc_shim_trisd { uint8_t TRISD0, TRISD1; } TRISDbits;
+extern struct xc_shim_portb { uint8_t RB7; } PORTBbits;
+extern struct xc_shim_t6con { uint8_t ON; } T6CONbits;
+extern struct xc_shim_pie0 { uint8_t IOCIE; } PIE0bits;
+
+extern struct xc_shim_adcon0 { uint8_t ON, FM, CS, CONT, GO; } xc_shim_adcon0;
+extern struct xc_shim_adcon2 { uint8_t MD, CRS, ACLR; } xc_shim_adcon2;
+extern struct xc_shim_adcon3 { uint8_t TMD; } ADCON3bits;
+#define ADCON0bits      (*(struct xc_shim_adcon0 *)xc_shim_adc(&xc_shim_adcon0))
+#define ADCON2bits      (*(struct xc_shim_adcon2 *)xc_shim_adc(&xc_shim_adcon2))
+
+extern void (*xc_shim_on_nop)(void);
+extern void (*xc_shim_on_adc)(void);
+void *xc_shim_adc(void *reg);
+extern uint8_t (*xc_shim_read_portc)(void);
+#define PORTC           (xc_shim_read_portc())
+
+#endif	/* XC_SHIM_H */
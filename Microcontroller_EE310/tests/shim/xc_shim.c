@@ -0,0 +1,33 @@
+#include <xc.h>
+
+#define XC_SHIM_DEFINE(r) volatile uint8_t r;
+XC_SHIM_REGS(XC_SHIM_DEFINE)
+
+struct xc_shim_intcon0 INTCON0bits;
+struct xc_shim_pir3 PIR3bits;
+struct xc_shim_pie3 PIE3bits;
+struct xc_shim_trisb TRISBbits;
+struct xc_shim_trisd TRISDbits;
+struct xc_shim_portb PORTBbits;
+struct xc_shim_t6con T6CONbits;
+struct xc_shim_pie0 PIE0bits;
+struct xc_shim_adcon0 xc_shim_adcon0;
+struct xc_shim_adcon2 xc_shim_adcon2;
+struct xc_shim_adcon3 ADCON3bits;
+
+// Nothing pressed, nothing pulled low
+static uint8_t PortcIdle(void)
+{
+    return 0xFF;
+}
+
+void (*xc_shim_on_nop)(void);
+void (*xc_shim_on_adc)(void);
+uint8_t (*xc_shim_read_portc)(void) = PortcIdle;
+
+void *xc_shim_adc(void *reg)
+{
+    if (xc_shim_on_adc)
+        xc_shim_on_adc();
+    return reg;
+}
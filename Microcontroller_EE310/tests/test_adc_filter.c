@@ -0,0 +1,206 @@
+// Replay benchmark for the burst-average reads (adc_filter.c, behind the
+// register shim) on the joystick.
+//
+// The real adc_filter_init() and adc_filtered_read() run against a mock
+// ADCC on the shim's xc_shim_on_adc hook: GO runs ADRPT conversions of
+// the level on ADPCH, sums them and leaves ADACC >> CRS in ADFLTR, as the
+// hardware does in burst-average mode. Noisy joystick traces are replayed
+// through the original window classifier from MCC_UART.c, once with
+// adc_filter_init(0) (one conversion per read, the old code) and once with
+// adc_filter_init(3), the 8-sample bursts MCC_UART.c now uses, and the
+// direction events are scored against the position the stick was really
+// held at. Events on the way between two positions (the stick crosses the
+// CENTER window going from LEFT to RIGHT, for instance) are counted apart:
+// they come from the window layout, not from noise.
+//
+// There are no recorded traces in the repo, so the traces are generated:
+// a stick held at a rest position for 150..1500 ms, moved over 30 ms,
+// with Gaussian noise, occasional spikes, and glitches where a conversion
+// reads anywhere on the scale (the wiper lifting off the track). A glitch
+// can land one single-sample read in another direction's window; an
+// 8-sample average moves at most 1/8 of the way and never gets there.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <xc.h>
+#include "adc_filter.h"
+#include "check.h"
+
+#define SAMPLE_MS       1           // one X/Y pair per ms, as in MCC_UART.c
+#define TRACE_MS        600000      // 10 minutes per trace
+#define BURST_SHIFT     3           // MCC_UART.c: adc_filter_init(3)
+
+enum { DIR_NONE, DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN, DIR_CENTER };
+
+// Rest positions, from the windows in the original MCC_UART.c
+static const struct { uint16_t x, y; } rest[] = {
+    { 0, 0 },
+    { 3250, 1660 },     // LEFT
+    { 33, 1600 },       // RIGHT
+    { 1600, 33 },       // UP
+    { 1670, 3250 },     // DOWN
+    { 1640, 1640 },     // CENTER
+};
+
+// Separate generators for the stick path and the conversion noise, so
+// both kinds of read replay exactly the same path.
+static uint32_t pathSeed, noiseSeed;
+
+static double uniform(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return ((*seed >> 8) + 0.5) / 16777216.0;
+}
+
+static double gauss(void)
+{
+    return sqrt(-2.0 * log(uniform(&noiseSeed))) * cos(6.283185307179586 * uniform(&noiseSeed));
+}
+
+// Noise on every conversion
+static double sigma, spikeRate, glitchRate;
+
+// One 12-bit conversion of a true level.
+static uint16_t convert(double level)
+{
+    double v = level + sigma * gauss();
+    if (uniform(&noiseSeed) < spikeRate)
+        v += (uniform(&noiseSeed) < 0.5 ? -1 : 1) * (150 + 300 * uniform(&noiseSeed));
+    if (uniform(&noiseSeed) < glitchRate)
+        v = 4095 * uniform(&noiseSeed);
+    if (v < 0) v = 0;
+    if (v > 4095) v = 4095;
+    return (uint16_t)(v + 0.5);
+}
+
+// === Mock ADCC ===
+static double level[2];             // RA0 = X, RA1 = Y
+
+static void Adcc(void)
+{
+    if (xc_shim_adcon2.ACLR)
+        xc_shim_adcon2.ACLR = 0;
+    if (xc_shim_adcon0.GO) {
+        uint32_t acc = 0;
+
+        CHECK(xc_shim_adcon2.MD == 0b011 && ADRPT == 1u << xc_shim_adcon2.CRS);
+        for (uint8_t i = 0; i < ADRPT; i++)
+            acc += convert(level[ADPCH & 1]);
+        acc >>= xc_shim_adcon2.CRS;
+        ADFLTRH = (uint8_t)(acc >> 8);
+        ADFLTRL = (uint8_t)acc;
+        xc_shim_adcon0.GO = 0;
+    }
+}
+
+// The window chain from the original MCC_UART.c main loop.
+typedef struct { uint8_t lastX, lastY; } windows_t;
+
+static uint8_t classify(windows_t *w, uint16_t x, uint16_t y)
+{
+    if (x >= 3200 && x <= 3300 && y >= 1640 && y <= 1680 && w->lastX != 1) {
+        w->lastX = 1; w->lastY = 0; return DIR_LEFT;
+    } else if (x >= 6 && x <= 60 && y >= 1400 && y <= 1800 && w->lastX != 2) {
+        w->lastX = 2; w->lastY = 0; return DIR_RIGHT;
+    } else if (y >= 6 && y <= 60 && x >= 1400 && x <= 1800 && w->lastY != 2) {
+        w->lastY = 2; w->lastX = 0; return DIR_UP;
+    } else if (y >= 3200 && y <= 3300 && x >= 1640 && x <= 1700 && w->lastY != 1) {
+        w->lastY = 1; w->lastX = 0; return DIR_DOWN;
+    } else if (x >= 1630 && x <= 1650 && y >= 1630 && y <= 1650 &&
+               (w->lastX != 0 || w->lastY != 0)) {
+        w->lastX = 0; w->lastY = 0; return DIR_CENTER;
+    }
+    return DIR_NONE;
+}
+
+typedef struct {
+    long holds;         // rest periods replayed
+    long falseEvents;   // events while held, for another direction
+    long transit;       // events on the way, for another direction
+    long missed;        // holds that produced no event for their direction
+    long delaySum;      // ms from reaching the position to its event
+    long delayWorst;
+} score_t;
+
+static void replay(uint8_t shift, score_t *s)
+{
+    windows_t w = { 0, 0 };
+    uint8_t dir = DIR_CENTER, prev = DIR_CENTER;
+    double x = rest[dir].x, y = rest[dir].y;
+    long t = 0;
+
+    pathSeed = 2024;
+    noiseSeed = 77;
+    adc_filter_init(shift);
+    while (t < TRACE_MS) {
+        // Pick the next rest position and move to it
+        do
+            dir = (uint8_t)(1 + (uniform(&pathSeed) * 5));
+        while (dir == prev || dir > DIR_CENTER);
+        long hold = 150 + (long)(uniform(&pathSeed) * 1350);
+        double x0 = x, y0 = y;
+        int seen = 0;
+
+        for (long ms = 0; ms < 30 + hold; ms += SAMPLE_MS, t += SAMPLE_MS) {
+            double f = ms < 30 ? ms / 30.0 : 1.0;
+            x = x0 + (rest[dir].x - x0) * f;
+            y = y0 + (rest[dir].y - y0) * f;
+
+            level[0] = x;
+            level[1] = y;
+            uint16_t rx = adc_filtered_read(0);
+            uint8_t ev = classify(&w, rx, adc_filtered_read(1));
+            if (ev == DIR_NONE)
+                continue;
+            if (ev != dir) {
+                if (ms < 30) s->transit++;
+                else s->falseEvents++;
+            } else if (!seen++) {
+                long delay = ms < 30 ? 0 : ms - 30;
+                s->delaySum += delay;
+                if (delay > s->delayWorst) s->delayWorst = delay;
+            }
+        }
+        s->holds++;
+        if (!seen) s->missed++;
+        prev = dir;
+    }
+}
+
+int main(void)
+{
+    static const struct { double sigma, spikes, glitches; } noise[] = {
+        { 4, 0.0, 0.0 }, { 8, 0.001, 0.0005 }, { 15, 0.005, 0.002 }, { 25, 0.01, 0.005 },
+    };
+
+    xc_shim_on_adc = Adcc;
+    printf("%-32s %-9s %6s %6s %7s %8s %9s %8s\n", "noise", "reads", "holds",
+           "false", "missed", "transit", "delay avg", "worst");
+    for (int n = 0; n < 4; n++) {
+        score_t single = { 0 }, avg = { 0 };
+
+        sigma = noise[n].sigma;
+        spikeRate = noise[n].spikes;
+        glitchRate = noise[n].glitches;
+        replay(0, &single);
+        replay(BURST_SHIFT, &avg);
+
+        printf("sigma %2.0f spikes %.1f%% glitches %.2f%% %-9s %6ld %6ld %7ld %8ld %6.1f ms %5ld ms\n",
+               sigma, spikeRate * 100, glitchRate * 100, "1 sample", single.holds,
+               single.falseEvents, single.missed, single.transit,
+               (double)single.delaySum / (single.holds - single.missed), single.delayWorst);
+        printf("%-32s %-9s %6ld %6ld %7ld %8ld %6.1f ms %5ld ms\n", "", "8-sample",
+               avg.holds, avg.falseEvents, avg.missed, avg.transit,
+               (double)avg.delaySum / (avg.holds - avg.missed), avg.delayWorst);
+
+        if (glitchRate > 0) {
+            CHECK(single.falseEvents > 0);      // the glitches do reach a window
+            CHECK(avg.falseEvents == 0);        // and the average removes them
+        }
+        CHECK(avg.falseEvents <= single.falseEvents);
+        CHECK(avg.missed <= single.missed);
+        CHECK(avg.delaySum <= single.delaySum);
+    }
+    return check_done("test_adc_filter");
+}
@@ -0,0 +1,244 @@
+// Differential test for calc_engine.c against an int64_t reference.
+//
+// calc_apply() is run on random operands, weighted towards the int32
+// limits and the rounding boundaries. Key sequences go through
+// calc_digit()/calc_operator()/calc_equals() and a reference calculator
+// that evaluates left to right. The Makefile builds this twice: with the
+// compiler's overflow builtins and with CALC_NO_BUILTINS for the range
+// tests XC8 uses.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "calc_engine.h"
+#include "check.h"
+
+#define OPS     20000000L
+#define SEQS    2000000L
+
+static uint32_t seed = 16;
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static int32_t rnd32(void)
+{
+    return (int32_t)(rnd() << 16 ^ rnd());
+}
+
+static int32_t operand(void)
+{
+    switch (rnd() % 6) {
+    case 0: return (int32_t)(rnd() % 2001) - 1000;              // small
+    case 1: return ((int32_t)(rnd() % 20001) - 10000) * 100;    // whole numbers
+    case 2: return INT32_MAX - (int32_t)(rnd() % 1000);
+    case 3: return INT32_MIN + (int32_t)(rnd() % 1000);
+    case 4: return (int32_t)(rnd() % 200001) - 100000;
+    default: return rnd32();
+    }
+}
+
+// Divide rounding half away from zero
+static int64_t divRound(int64_t n, int64_t d)
+{
+    int64_t q = n / d, r = n % d;
+    int64_t ar = r < 0 ? -r : r, ad = d < 0 ? -d : d;
+
+    if (2 * ar >= ad)
+        q += ((n < 0) != (d < 0)) ? -1 : 1;
+    return q;
+}
+
+static int fits(int64_t v)
+{
+    return v >= INT32_MIN && v <= INT32_MAX;
+}
+
+// Reference result; returns the status the engine should report. *early
+// is set where the engine may report overflow although the result fits,
+// because an intermediate it forms does not: (a % 100) * b for a product,
+// (a % b) * 100 for a quotient.
+static uint8_t reference(char op, int32_t a, int32_t b, int64_t *r, int *early)
+{
+    *early = 0;
+    switch (op) {
+    case '+': *r = (int64_t)a + b; break;
+    case '-': *r = (int64_t)a - b; break;
+    case '*':
+        *r = divRound((int64_t)a * b, CALC_SCALE);
+        *early = !fits((int64_t)(a % CALC_SCALE) * b);
+        break;
+    case '/':
+        if (b == 0)
+            return CALC_DIV_ZERO;
+        *r = divRound((int64_t)a * CALC_SCALE, b);
+        *early = !fits((int64_t)(a % b) * CALC_SCALE);
+        break;
+    default:
+        *r = b;
+        break;
+    }
+    return fits(*r) ? CALC_OK : CALC_OVERFLOW;
+}
+
+static void testApply(void)
+{
+    static const char ops[] = "+-*/";
+    long wrong = 0, missed = 0, early = 0, overflows = 0;
+
+    for (long i = 0; i < OPS; i++) {
+        char op = ops[rnd() % 4];
+        int32_t a = operand(), b = rnd() % 50 ? operand() : 0, got = 0x5A5A5A5A;
+        int64_t want;
+        int mayBeEarly;
+        uint8_t st = calc_apply(op, a, b, &got);
+        uint8_t wantSt = reference(op, a, b, &want, &mayBeEarly);
+
+        if (wantSt == CALC_OK && st == CALC_OK) {
+            if (got != want) {
+                if (wrong < 5)
+                    printf("  %ld %c %ld: got %ld, want %lld\n", (long)a, op, (long)b,
+                           (long)got, (long long)want);
+                wrong++;
+            }
+        } else if (wantSt == CALC_OK) {
+            CHECK(st == CALC_OVERFLOW);
+            early++;
+            if (!mayBeEarly && early < 5)
+                printf("  %ld %c %ld: early overflow\n", (long)a, op, (long)b);
+            CHECK(mayBeEarly);
+        } else {
+            if (st != wantSt) missed++;
+            if (wantSt == CALC_OVERFLOW) overflows++;
+        }
+    }
+    printf("%ld random operations: %ld wrong, %ld overflows missed of %ld, "
+           "%ld reported early\n", OPS, wrong, missed, overflows, early);
+    CHECK(wrong == 0 && missed == 0);
+}
+
+// Hand-picked cases: rounding halves, signs, limits
+static void testCases(void)
+{
+    static const struct { char op; int32_t a, b, want; uint8_t st; } cases[] = {
+        { '*', 150, 150, 225, CALC_OK },            // 1.50 * 1.50 = 2.25
+        { '*', 5, 10, 1, CALC_OK },                 // 0.05 * 0.10 = 0.005 -> 0.01
+        { '*', -5, 10, -1, CALC_OK },               // halves away from zero
+        { '*', 4, 10, 0, CALC_OK },
+        { '/', 100, 300, 33, CALC_OK },             // 1 / 3
+        { '/', 200, 300, 67, CALC_OK },             // 2 / 3
+        { '/', -200, 300, -67, CALC_OK },
+        { '/', 100, 800, 13, CALC_OK },             // 0.125 -> 0.13
+        { '/', 100, 0, 0, CALC_DIV_ZERO },
+        { '/', INT32_MIN, -100, 0, CALC_OVERFLOW },
+        { '+', INT32_MAX, 1, 0, CALC_OVERFLOW },
+        { '-', INT32_MIN, 1, 0, CALC_OVERFLOW },
+        { '*', INT32_MAX, 100, INT32_MAX, CALC_OK },
+        { '*', INT32_MAX, 101, 0, CALC_OVERFLOW },
+        { 0, 123, 456, 456, CALC_OK },
+    };
+
+    for (unsigned i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+        int32_t r = 0;
+        uint8_t st = calc_apply(cases[i].op, cases[i].a, cases[i].b, &r);
+        CHECK(st == cases[i].st);
+        if (st == CALC_OK)
+            CHECK(r == cases[i].want);
+    }
+}
+
+// Random key sequences: numbers of 1..5 digits joined by operators, then
+// '='. The reference applies each operator as the next one arrives, the
+// way the calculator chains.
+static void testSequences(void)
+{
+    static const char ops[] = "+-*/";
+    long errors = 0, early = 0;
+
+    for (long s = 0; s < SEQS; s++) {
+        calc_t c;
+        int64_t acc = 0;
+        char pending = 0;
+        uint8_t refSt = CALC_OK;
+        int mayBeEarly = 0;
+        int terms = 1 + (int)(rnd() % 5);
+
+        calc_init(&c);
+        for (int t = 0; t < terms; t++) {
+            int digits = 1 + (int)(rnd() % 5);
+            int64_t entry = 0;
+
+            for (int d = 0; d < digits; d++) {
+                uint8_t digit = (uint8_t)(rnd() % 10);
+                if (calc_digit(&c, digit) == CALC_OK && refSt == CALC_OK)
+                    entry = entry * 10 + digit;
+            }
+            entry *= CALC_SCALE;
+            if (refSt == CALC_OK) {
+                int64_t r;
+                int e;
+                refSt = reference(pending, (int32_t)acc, (int32_t)entry, &r, &e);
+                mayBeEarly |= e;
+                acc = r;
+            }
+            pending = ops[rnd() % 4];
+            if (t + 1 < terms)
+                calc_operator(&c, pending);
+        }
+        calc_equals(&c);
+
+        if (refSt == CALC_OK && c.status == CALC_OVERFLOW && mayBeEarly) {
+            early++;
+        } else if (c.status != refSt || (refSt == CALC_OK && c.acc != acc)) {
+            if (errors < 5)
+                printf("  sequence %ld: status %u acc %ld, want %u %lld\n", s,
+                       c.status, (long)c.acc, refSt, (long long)acc);
+            errors++;
+        }
+        CHECK(c.op == 0 || c.status != CALC_OK);
+
+        // Errors stick: nothing changes until calc_init()
+        if (c.status != CALC_OK) {
+            calc_t before = c;
+            calc_digit(&c, 1);
+            calc_operator(&c, '+');
+            calc_equals(&c);
+            CHECK(c.status == before.status && c.acc == before.acc);
+        }
+    }
+    printf("%ld key sequences: %ld wrong, %ld overflows reported early\n",
+           SEQS, errors, early);
+    CHECK(errors == 0);
+}
+
+// A digit that would overflow the entry is refused without an error
+static void testEntryOverflow(void)
+{
+    calc_t c;
+    int accepted = 0;
+
+    calc_init(&c);
+    for (int i = 0; i < 12; i++)
+        if (calc_digit(&c, 9) == CALC_OK)
+            accepted++;
+    printf("entry accepts %d nines\n", accepted);
+    CHECK(accepted == 7);                   // 9999999.00 fits, 99999999.00 does not
+    CHECK(c.status == CALC_OK && c.entry == 999999900);
+    CHECK(calc_equals(&c) == CALC_OK && c.acc == 999999900);
+}
+
+int main(void)
+{
+#ifdef CALC_NO_BUILTINS
+    printf("range-test overflow checks (CALC_NO_BUILTINS)\n");
+#else
+    printf("compiler overflow builtins\n");
+#endif
+    testCases();
+    testEntryOverflow();
+    testApply();
+    testSequences();
+    return check_done("test_calc_engine");
+}
@@ -0,0 +1,182 @@
+// Harness for the calculator state machine (calc_fsm.c) with the real
+// display_mux.c behind the register shim (shim/xc.h).
+//
+// Keys are fed to calc_fsm_step() as the main loop does; the display is
+// read back the way the board shows it, by running the TMR3 refresh ISR
+// over every digit and decoding the segment lines on LATB.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <xc.h>
+#include "calc_fsm.h"
+#include "display_mux.h"
+#include "seg_glyphs.h"
+#include "check.h"
+
+void DISPLAY_ISR(void);
+
+// One refresh pass: the text shown, '.' after a digit with the DP lit,
+// '?' for a pattern that is no glyph. All blanks while blinked dark.
+static void readDisplay(char *text)
+{
+    static const char names[] = "0123456789ABCDEF*#- ";
+    char *p = text;
+
+    for (int i = 0; i < DISPLAY_DIGITS; i++) {
+        DISPLAY_ISR();
+        uint8_t pattern = LATB & (uint8_t)~SEG_DP;
+        char ch = '?';
+        for (int g = 0; g < SEG_GLYPH_COUNT; g++)
+            if (seg_glyphs[g] == pattern) { ch = names[g]; break; }
+        int digit = 0;
+        while (digit < DISPLAY_DIGITS && !(LATD & (1u << digit)))
+            digit++;
+        CHECK(digit < DISPLAY_DIGITS && (LATD & 0x0F) == (1u << digit));
+        p[digit * 2] = ch;
+        p[digit * 2 + 1] = (LATB & SEG_DP) ? '.' : 0;
+    }
+    // Squeeze out the unused DP slots
+    char out[2 * DISPLAY_DIGITS + 1];
+    int n = 0;
+    for (int i = 0; i < 2 * DISPLAY_DIGITS; i++)
+        if (text[i])
+            out[n++] = text[i];
+    out[n] = '\0';
+    strcpy(text, out);
+}
+
+// True if the display goes dark and comes back within two blink periods
+static int blinking(void)
+{
+    char text[2 * DISPLAY_DIGITS + 1];
+    int dark = 0, lit = 0;
+
+    for (int ms = 0; ms < 2 * 2 * DISPLAY_BLINK_MS; ms += DISPLAY_DIGITS) {
+        readDisplay(text);
+        if (strcmp(text, "    ") == 0) dark++;
+        else lit++;
+    }
+    return dark && lit;
+}
+
+static void reset(void)
+{
+    display_init();
+    display_set_blink(0);
+    calc_fsm_init();
+}
+
+// Runs keys and checks the display and state afterwards
+static void run(const char *keys, const char *want, uint8_t wantState, int wantBlink)
+{
+    char text[2 * DISPLAY_DIGITS + 1];
+
+    reset();
+    for (const char *k = keys; *k; k++)
+        calc_fsm_step(*k);
+    readDisplay(text);
+    if (wantBlink) {
+        // The first read may land in the dark half
+        for (int i = 0; i < DISPLAY_BLINK_MS && strcmp(text, want); i++)
+            readDisplay(text);
+    }
+    if (strcmp(text, want) != 0 || calc_fsm_state() != wantState)
+        printf("  \"%s\": shows \"%s\" in state %u, want \"%s\" in state %u\n",
+               keys, text, calc_fsm_state(), want, wantState);
+    CHECK(strcmp(text, want) == 0);
+    CHECK(calc_fsm_state() == wantState);
+    CHECK(blinking() == wantBlink);
+}
+
+static void testPaths(void)
+{
+    // Entry and results
+    run("", "    ", CALC_ST_FIRST, 0);
+    run("7", "   7", CALC_ST_FIRST, 0);
+    run("12A3#", "  15", CALC_ST_RESULT, 0);
+    run("7D2#", "  3.5", CALC_ST_RESULT, 0);
+    run("1D3#", " 0.33", CALC_ST_RESULT, 0);
+    run("3B5#", "  -2", CALC_ST_RESULT, 0);
+    run("12C12#", " 144", CALC_ST_RESULT, 0);
+    run("2D3#", " 0.67", CALC_ST_RESULT, 0);
+
+    // Chaining: another operation applies the pending one
+    run("1A2A3#", "   6", CALC_ST_RESULT, 0);
+    run("1A2A", "   3", CALC_ST_NEXT, 0);
+    run("9B4C3#", "  15", CALC_ST_RESULT, 0);
+    run("8AB2#", "   6", CALC_ST_RESULT, 0);          // B replaces A
+
+    // Errors blink EEEE until '*'
+    run("5D0#", "EEEE", CALC_ST_RESULT, 1);
+    run("9999C9999#", "EEEE", CALC_ST_RESULT, 1);      // too wide for 4 digits
+    run("9999C9999C9999C9999C", "EEEE", CALC_ST_RESULT, 1);
+    run("5D0A", "EEEE", CALC_ST_RESULT, 1);            // chained divide by zero
+    run("0B9999B9999#", "EEEE", CALC_ST_RESULT, 1);
+
+    // Ignored keys
+    run("#", "    ", CALC_ST_FIRST, 0);
+    run("A", "    ", CALC_ST_FIRST, 0);
+    run("1A#", "   1", CALC_ST_NEXT, 0);               // '#' before the next number
+    run("12345", "1234", CALC_ST_FIRST, 0);            // fifth digit dropped
+    run("1A2#3", "   3", CALC_ST_RESULT, 0);           // digits after a result
+    run("1A2#A#", "   3", CALC_ST_RESULT, 0);
+    run("5D0#7A#", "EEEE", CALC_ST_RESULT, 1);
+
+    // '*' from every state clears the display and starts over
+    run("12*", "    ", CALC_ST_FIRST, 0);
+    run("12A3*", "    ", CALC_ST_FIRST, 0);
+    run("12A3#*", "    ", CALC_ST_FIRST, 0);
+    run("5D0#*", "    ", CALC_ST_FIRST, 0);
+    run("5D0#*4A4#", "   8", CALC_ST_RESULT, 0);
+}
+
+// Random keys: every table cell is reached, states stay in range, and in
+// CALC_ST_RESULT nothing but '*' changes what is shown.
+static void testRandom(void)
+{
+    static const char keys[] = "0123456789ABCD#*";
+    uint32_t seed = 17;
+    long visits[CALC_ST_COUNT][CALC_KEY_CLASSES];
+    char before[2 * DISPLAY_DIGITS + 1], after[2 * DISPLAY_DIGITS + 1];
+
+    memset(visits, 0, sizeof visits);
+    reset();
+    for (long i = 0; i < 500000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        // '*' rarely, so long chains happen
+        char key = (seed >> 8) % 40 == 0 ? '*' : keys[(seed >> 12) % 15];
+        uint8_t st = calc_fsm_state();
+
+        // Blinking is switched off before each read to see the frame
+        // itself; the state machine never reads it back
+        visits[st][calc_fsm_key_class(key)]++;
+        display_set_blink(0);
+        readDisplay(before);
+        calc_fsm_step(key);
+        uint8_t now = calc_fsm_state();
+        CHECK(now < CALC_ST_COUNT);
+
+        display_set_blink(0);
+        readDisplay(after);
+        if (st == CALC_ST_RESULT && key != '*') {
+            CHECK(now == CALC_ST_RESULT);
+            CHECK(strcmp(before, after) == 0);
+        }
+        if (key == '*') {
+            CHECK(now == CALC_ST_FIRST);
+            CHECK(strcmp(after, "    ") == 0);
+        }
+        CHECK(strchr(after, '?') == NULL);
+    }
+    for (int s = 0; s < CALC_ST_COUNT; s++)
+        for (int k = 0; k < CALC_KEY_CLASSES; k++)
+            CHECK(visits[s][k] > 0);
+}
+
+int main(void)
+{
+    testPaths();
+    testRandom();
+    return check_done("test_calc_fsm");
+}
@@ -0,0 +1,177 @@
+// Refresh model for display_mux.c behind the register shim (shim/xc.h).
+//
+// TMR3 is played from what display_init() leaves in the registers: the
+// reload in TMR3H:TMR3L and the prescale in T3CON give the period, and
+// DISPLAY_ISR() runs once per period for ten seconds of virtual time. After
+// every interrupt the digit enables on LATD and the segments on LATB are
+// read back, so each digit's on-time and refresh count come from what the
+// driver really drives.
+//
+// Checked: one digit on at a time, showing its framebuffer pattern; every
+// digit refreshed at 1000 / DISPLAY_DIGITS Hz (no less than 100 Hz) with a
+// 1 / DISPLAY_DIGITS duty; blinking dark for DISPLAY_BLINK_MS of each
+// second. Built for 4 and 8 digits.
+//
+// The ISR cost cannot be timed on the host. It is an estimate, not a
+// measurement: the instruction counts below are a hand count of what XC8
+// makes of each line (banked SFR access, K42 hardware context save), and
+// the branches and the 1 << scanDigit shift loop are weighed by the paths
+// the run actually took.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <xc.h>
+#include "display_mux.h"
+#include "seg_glyphs.h"
+#include "check.h"
+
+void DISPLAY_ISR(void);
+
+#define SIM_MS          10000
+
+// Estimated instruction cycles (1 us each at FOSC 4 MHz)
+#define CY_ENTRY        5       // vectored latency 3 + RETFIE 2
+#define CY_RELOAD       6       // TMR3H, TMR3L, TMR3IF
+#define CY_BLINK_OFF    8       // blinkOn test, clear blinkDark and blinkMs
+#define CY_BLINK_ON     14      // 16-bit increment and compare with 500
+#define CY_BLINK_FLIP   4       // clear blinkMs, toggle blinkDark
+#define CY_OUTPUT       16      // LATD &=, frame[scanDigit] to LATB, LATD |=
+#define CY_SHIFT        4       // per step of the 1 << scanDigit loop
+#define CY_NEXT         6       // ++scanDigit and wrap
+
+static uint32_t period;                 // us between interrupts
+static uint32_t onUs[DISPLAY_DIGITS], lit[DISPLAY_DIGITS];
+static uint32_t isrCycles, isrWorst, isrs, darkMs;
+
+static int litDigit(void)
+{
+    uint8_t enables = LATD & (uint8_t)((1u << DISPLAY_DIGITS) - 1);
+    int digit = 0;
+
+    while (digit < DISPLAY_DIGITS && enables != (1u << digit))
+        digit++;
+    return digit;           // DISPLAY_DIGITS if none or more than one is on
+}
+
+// Runs the ISR for ms of virtual time and checks every digit it lights
+// against the pattern expected for it (or dark while blinking).
+static void run(uint32_t ms, const uint8_t *expect, uint8_t blink)
+{
+    static uint16_t blinkMs;
+    static uint8_t dark;
+
+    for (uint32_t t = 0; t < ms * 1000; t += period) {
+        int digit;
+
+        DISPLAY_ISR();
+        digit = litDigit();
+        CHECK(digit < DISPLAY_DIGITS);
+        if (digit == DISPLAY_DIGITS)
+            continue;
+        onUs[digit] += period;
+        lit[digit]++;
+
+        // Cost of the path just taken
+        uint32_t cycles = CY_ENTRY + CY_RELOAD + CY_OUTPUT + CY_NEXT + CY_SHIFT * digit;
+        if (!blink) {
+            cycles += CY_BLINK_OFF;
+            blinkMs = 0;
+            dark = 0;
+        } else {
+            cycles += CY_BLINK_ON;
+            if (++blinkMs >= DISPLAY_BLINK_MS) {
+                cycles += CY_BLINK_FLIP;
+                blinkMs = 0;
+                dark ^= 1;
+            }
+        }
+        isrCycles += cycles;
+        if (cycles > isrWorst)
+            isrWorst = cycles;
+        isrs++;
+
+        CHECK(LATB == (dark ? 0x00 : expect[digit]));
+        darkMs += LATB == 0x00 && expect[digit] != 0x00;
+    }
+}
+
+static void clearStats(void)
+{
+    for (int i = 0; i < DISPLAY_DIGITS; i++)
+        onUs[i] = lit[i] = 0;
+    isrCycles = isrWorst = isrs = darkMs = 0;
+}
+
+static void testRefresh(void)
+{
+    uint8_t expect[DISPLAY_DIGITS];
+
+    // "-123" right-aligned, blanks to the left
+    for (int i = 0; i < DISPLAY_DIGITS; i++)
+        expect[i] = seg_glyphs[SEG_GLYPH_BLANK];
+    expect[DISPLAY_DIGITS - 4] = seg_glyphs[SEG_GLYPH_MINUS];
+    expect[DISPLAY_DIGITS - 3] = seg_glyphs[1];
+    expect[DISPLAY_DIGITS - 2] = seg_glyphs[2];
+    expect[DISPLAY_DIGITS - 1] = seg_glyphs[3];
+    CHECK(display_set_number(-123));
+
+    clearStats();
+    run(SIM_MS, expect, 0);
+
+    double seconds = SIM_MS / 1000.0;
+    for (int i = 0; i < DISPLAY_DIGITS; i++) {
+        CHECK(lit[i] == (uint32_t)(SIM_MS / DISPLAY_DIGITS));
+        CHECK(onUs[i] * DISPLAY_DIGITS == SIM_MS * 1000u);
+    }
+    CHECK(lit[0] / seconds >= 100.0);   // no visible flicker
+
+    double avg = (double)isrCycles / isrs;
+    printf("  %d digits: interrupt every %lu us, each digit %.0f Hz at %.1f%% duty\n",
+           DISPLAY_DIGITS, (unsigned long)period, lit[0] / seconds,
+           100.0 * onUs[0] / (SIM_MS * 1000.0));
+    printf("  ISR about %.1f cycles on average, %lu at worst: %.1f%% of the CPU\n",
+           avg, (unsigned long)isrWorst, 100.0 * avg / period);
+    CHECK(avg / period < 0.10);
+}
+
+static void testBlink(void)
+{
+    uint8_t expect[DISPLAY_DIGITS];
+
+    for (int i = 0; i < DISPLAY_DIGITS; i++)
+        expect[i] = seg_glyphs[8];
+    for (int i = 0; i < DISPLAY_DIGITS; i++)
+        display_set_raw((uint8_t)i, seg_glyphs[8]);
+
+    display_set_blink(1);
+    clearStats();
+    run(SIM_MS, expect, 1);
+    display_set_blink(0);
+
+    double avg = (double)isrCycles / isrs;
+    printf("  blinking: dark %lu of %d ms, ISR about %.1f cycles, %lu at worst\n",
+           (unsigned long)darkMs, SIM_MS, avg, (unsigned long)isrWorst);
+    CHECK(darkMs == SIM_MS / 2);
+    CHECK(isrWorst < period / 10);
+
+    // Back to steady on the next interrupt
+    clearStats();
+    run(DISPLAY_DIGITS, expect, 0);
+    CHECK(darkMs == 0);
+}
+
+int main(void)
+{
+    display_init();
+    CHECK(TMR3IE && (T3CON & 0x01) && INTCON0bits.GIE);
+
+    // TMR3 counts FOSC/4 (1 MHz) through the T3CON prescale up to overflow
+    uint16_t reload = (uint16_t)(TMR3H << 8 | TMR3L);
+    period = (65536u - reload) << ((T3CON >> 4) & 3);
+    CHECK(period == 1000);
+
+    testRefresh();
+    testBlink();
+    return check_done(DISPLAY_DIGITS == 4 ? "test_display_mux (4 digits)"
+                                          : "test_display_mux (8 digits)");
+}
@@ -0,0 +1,220 @@
+// Emergency-button simulation for estop.c with the real melody.c.
+//
+// Time runs in microseconds. The 1 ms tick interrupt calls melody_tick()
+// and estop_tick() on each millisecond boundary; the stop button can be
+// pressed at any microsecond and its interrupt runs up to one keypad scan
+// (60 us) later. The main loop grants access (a 5 s relay hold) and keeps
+// trying to switch the relay on during the emergency, as a stuck mode 1
+// button or a repeated password would.
+//
+// Checked for every press: the relay is off within 1 ms, stays off for
+// the whole emergency whatever the main loop asks, and the hold does not
+// come back afterwards; the siren runs until the emergency ends; the
+// started/ended flags fire once each. Without a press the hold ends on
+// time.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "estop.h"
+#include "melody.h"
+#include "tone.h"
+#include "check.h"
+
+#define EMERGENCY_MS 10000
+#define GRANTED_MS   5000
+#define ISR_LATENCY_US 60       // one keypad scan
+#define RELAY_DROP_US  1000
+
+static const melody_step_t siren[] = {
+    { NOTE_A6, 250 }, { NOTE_E6, 250 },
+    MELODY_END
+};
+
+static long nowUs;
+static uint8_t relayPin;
+static long relayWrittenUs;
+static uint8_t toneOn;
+
+void estop_relay_write(uint8_t on)
+{
+    relayPin = on;
+    relayWrittenUs = nowUs;
+}
+
+void tone_start(uint8_t ckps, uint8_t pr)
+{
+    (void)ckps;
+    (void)pr;
+    toneOn = 1;
+}
+
+void tone_stop(void)
+{
+    toneOn = 0;
+}
+
+static uint32_t seed = 19;
+
+static long rnd(long n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (long)((seed >> 8) % (uint32_t)n);
+}
+
+static void tick(void)
+{
+    melody_tick();
+    estop_tick();
+}
+
+static long dropUs;             // when the press interrupt cleared the relay
+
+static void pressIsr(long isrUs, long pressUs)
+{
+    nowUs = isrUs;
+    estop_trigger();
+    CHECK(!relayPin);
+    dropUs = relayWrittenUs;
+    CHECK(dropUs - pressUs <= RELAY_DROP_US);
+    CHECK(estop_active() && melody_busy() && toneOn);
+}
+
+// One run: access granted at holdMs, stop pressed at pressUs (-1 for none),
+// the main loop pestering the relay every pesterMs during the emergency.
+static void run(long holdMs, long pressUs, long pesterMs)
+{
+    long isrUs = pressUs < 0 ? -1 : pressUs + rnd(ISR_LATENCY_US + 1);
+    long endMs = (pressUs < 0 ? holdMs + GRANTED_MS : pressUs / 1000 + EMERGENCY_MS) + 20;
+    long holdOnUs = -1, holdOffUs = -1, endedUs = -1;
+    int starts = 0, ends = 0;
+
+    nowUs = 0;
+    melody_stop();
+    estop_init(siren, EMERGENCY_MS);
+    CHECK(!relayPin && !estop_active());
+
+    for (long ms = 0; ms < endMs; ms++) {
+        long mainUs = ms * 1000 + 200;  // main loop pass this millisecond
+        int isrThisMs = isrUs >= 0 && ms == isrUs / 1000;
+
+        if (isrThisMs && isrUs < mainUs)
+            pressIsr(isrUs, pressUs);
+
+        nowUs = mainUs;
+        if (ms == holdMs) {
+            estop_relay_hold(GRANTED_MS);
+            if (!estop_active())
+                holdOnUs = nowUs;
+        } else if (estop_active() && ms % pesterMs == 0) {
+            if (rnd(2))
+                estop_relay_set(1);
+            else
+                estop_relay_hold(GRANTED_MS);
+        }
+        starts += estop_take_started();
+        if (estop_take_ended()) {
+            ends++;
+            endedUs = nowUs;
+        }
+
+        if (isrThisMs && isrUs >= mainUs)
+            pressIsr(isrUs, pressUs);
+
+        nowUs = (ms + 1) * 1000;
+        uint8_t wasOn = relayPin;
+        tick();
+        if (wasOn && !relayPin)
+            holdOffUs = nowUs;
+
+        CHECK(relayPin == estop_relay_on());
+        if (isrUs >= 0 && nowUs > isrUs) {
+            CHECK(!relayPin);
+            if (estop_active())
+                CHECK(toneOn && melody_busy());
+        }
+    }
+
+    if (holdOnUs >= 0 && (pressUs < 0 || isrUs >= holdOnUs + GRANTED_MS * 1000L)) {
+        // The hold ran out on its own, 5 s after it started
+        long held = holdOffUs - holdOnUs;
+        CHECK(held > (GRANTED_MS - 1) * 1000L && held <= GRANTED_MS * 1000L);
+    } else if (holdOnUs >= 0) {
+        // The press cut the hold short and the tick found nothing to drop
+        CHECK(holdOffUs < 0);
+    }
+    if (pressUs >= 0) {
+        CHECK(starts == 1 && ends == 1);
+        // Seen by the next main loop pass after the 10 s ran out
+        long lasted = endedUs - isrUs;
+        CHECK(lasted > (EMERGENCY_MS - 1) * 1000L && lasted <= (EMERGENCY_MS + 1) * 1000L);
+        CHECK(!estop_active() && !melody_busy() && !toneOn);
+        CHECK(!relayPin);
+    } else {
+        CHECK(starts == 0 && ends == 0);
+    }
+}
+
+// Two presses: the second restarts the 10 s, and the flags still come
+// once per emergency end
+static void testRepress(void)
+{
+    estop_init(siren, EMERGENCY_MS);
+    estop_trigger();
+    for (int ms = 0; ms < EMERGENCY_MS / 2; ms++)
+        tick();
+    estop_trigger();
+    for (int ms = 0; ms < EMERGENCY_MS - 1; ms++)
+        tick();
+    CHECK(estop_active() && toneOn);
+    tick();
+    CHECK(!estop_active() && !toneOn);
+    CHECK(estop_take_started() && !estop_take_started());
+    CHECK(estop_take_ended() && !estop_take_ended());
+}
+
+// Set and hold outside an emergency
+static void testRelay(void)
+{
+    estop_init(siren, EMERGENCY_MS);
+    estop_relay_set(1);
+    for (int ms = 0; ms < 3 * GRANTED_MS; ms++)
+        tick();
+    CHECK(relayPin);                    // set stays on
+    estop_relay_hold(GRANTED_MS);
+    estop_relay_set(0);                 // cancels the hold
+    CHECK(!relayPin);
+    for (int ms = 0; ms < 3 * GRANTED_MS; ms++)
+        tick();
+    CHECK(!relayPin);
+    estop_relay_hold(0);                // no hold at all
+    CHECK(!relayPin);
+    estop_relay_hold(GRANTED_MS);
+    estop_relay_hold(GRANTED_MS);       // a new hold restarts the time
+    for (int ms = 0; ms < GRANTED_MS - 1; ms++)
+        tick();
+    CHECK(relayPin);
+    tick();
+    CHECK(!relayPin);
+}
+
+int main(void)
+{
+    long worstUs = 0;
+
+    testRepress();
+    testRelay();
+
+    run(100, -1, 1);
+    for (int i = 0; i < 3000; i++) {
+        long holdMs = rnd(1000);
+        // Mostly during the hold, sometimes before or after it
+        long pressUs = holdMs * 1000 + rnd((GRANTED_MS + 2000) * 1000L) - 1000000;
+        if (pressUs < 0)
+            pressUs = rnd(1000000);
+        run(holdMs, pressUs, 1 + rnd(50));
+        if (dropUs - pressUs > worstUs)
+            worstUs = dropUs - pressUs;
+    }
+    printf("  relay off within %ld us of the press (worst of 3000)\n", worstUs);
+    return check_done("test_estop");
+}
@@ -0,0 +1,111 @@
+// Exhaustive test for fmt_mv.c: every 12-bit code at the 3.3 V reference
+// of ADC_Voltage_Reader.c and the 5 V reference of Lab_12.c, against the
+// float math and sprintf("%.2f") those files used before, and against
+// exact rounding of code * vref / 4096 done in integers.
+//
+// fmt_mv() rounds the exact value half up. The old output differs on two
+// codes per reference, the exact ties, which it printed one hundredth
+// lower: 0.625 and 3.125 V at 5 V are exact floats and printf rounds ties
+// to even; 3.3f is just below 3.3, so 0.825 and 2.475 V came out below
+// the tie. The test checks that these four codes are the only ones.
+//
+// Host time per reading, for scale only: the PIC18 cost depends on XC8's
+// float and printf libraries, which are not available here.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "fmt_mv.h"
+#include "check.h"
+
+// Exact value in volts, rounded half up to hundredths, as integer text
+static void exactText(char *buf, uint16_t code, uint16_t vref_mv)
+{
+    // hundredths = round(code * vref_mv / 4096 / 10)
+    uint32_t num = (uint32_t)code * vref_mv;
+    uint32_t cv = (num + 5u * 4096u) / (10u * 4096u);
+    sprintf(buf, "%lu.%02lu", (unsigned long)(cv / 100), (unsigned long)(cv % 100));
+}
+
+static void sweep(uint16_t vref_mv, float vref, const uint16_t ties[2])
+{
+    int differ = 0;
+
+    for (uint16_t code = 0; code < 4096; code++) {
+        char got[8], old[16], exact[16];
+        uint16_t mv = adc_to_mv(code, vref_mv);
+
+        CHECK(mv == (uint16_t)((uint32_t)code * vref_mv / 4096));
+        CHECK(fmt_mv(got, mv) == got + strlen(got));
+        CHECK(strlen(got) == 4);
+
+        exactText(exact, code, vref_mv);
+        CHECK(strcmp(got, exact) == 0);
+
+        // The old code: float math, then printf rounding of the float
+        sprintf(old, "%.2f", ((float)code * vref) / 4096.0f);
+        if (strcmp(got, old) != 0) {
+            // Only where the exact value sits half-way between hundredths
+            uint32_t num = (uint32_t)code * vref_mv;
+            CHECK(num % (10u * 4096u) == 5u * 4096u);
+            CHECK(differ < 2 && code == ties[differ]);
+            CHECK(got[3] == old[3] + 1);
+            printf("  %u mV ref, code %4u: %s, old printf %s\n", vref_mv, code, got, old);
+            differ++;
+        }
+    }
+    printf("%u mV reference: %d of 4096 codes differ from the old output\n", vref_mv, differ);
+    CHECK(differ == 2);
+}
+
+// Host ns per reading: the integer path against float math and "%.2f"
+static void timeFormat(void)
+{
+    const int rounds = 2000000;
+    char buf[16];
+    unsigned sum = 0;
+    volatile float vref = 3.3f;
+
+    clock_t start = clock();
+    for (int i = 0; i < rounds; i++) {
+        fmt_mv(buf, adc_to_mv((uint16_t)(i & 0xFFF), 3300));
+        sum += (unsigned)buf[3];
+    }
+    double fixedNs = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / rounds;
+
+    start = clock();
+    for (int i = 0; i < rounds; i++) {
+        sprintf(buf, "%.2f", ((float)(i & 0xFFF) * vref) / 4096.0f);
+        sum += (unsigned)buf[3];
+    }
+    double floatNs = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / rounds;
+
+    printf("host: %.0f ns per reading, float and sprintf %.0f ns (%.0fx)\n",
+           fixedNs, floatNs, floatNs / fixedNs);
+    CHECK(sum != 0);
+    CHECK(fixedNs < floatNs);
+}
+
+int main(void)
+{
+    char buf[8];
+
+    static const uint16_t ties33[2] = { 1024, 3072 }, ties50[2] = { 512, 2560 };
+
+    sweep(3300, 3.3f, ties33);
+    sweep(5000, 5.0f, ties50);
+
+    // Every millivolt value the formatter can be given
+    for (uint32_t mv = 0; mv <= 65535; mv++) {
+        char want[16];
+        uint32_t cv = (mv + 5) / 10;
+        sprintf(want, "%lu.%02lu", (unsigned long)(cv / 100), (unsigned long)(cv % 100));
+        if (cv < 10000) {               // two-digit volts at most
+            fmt_mv(buf, (uint16_t)mv);
+            CHECK(strcmp(buf, want) == 0);
+        }
+    }
+    timeFormat();
+    return check_done("test_fmt_mv");
+}
@@ -0,0 +1,248 @@
+// Sweep tests for joy_classify.c, and the calibration record in data
+// EEPROM behind a small shim.
+//
+// calSave()/calLoad() are MCC_UART.c's Cal_Save()/Cal_Load() with
+// EEPROM_Read()/EEPROM_Write() swapped for an array.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "joy_classify.h"
+#include "joy_protocol.h"
+#include "check.h"
+
+static const char *const dirName[] = { "CENTER", "LEFT", "RIGHT", "UP", "DOWN" };
+
+static uint32_t seed = 31;
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// Position at (fx, fy) of the half-axis travel, -1..+1; +x is LEFT, -y is UP.
+static void place(const joy_cal_t *cal, double fx, double fy, uint16_t *x, uint16_t *y)
+{
+    *x = (uint16_t)lround(cal->cx + fx * (fx > 0 ? cal->xMax - cal->cx : cal->cx - cal->xMin));
+    *y = (uint16_t)lround(cal->cy + fy * (fy > 0 ? cal->yMax - cal->cy : cal->cy - cal->yMin));
+}
+
+// Walk out from the rest point along one axis and back, one count at a
+// time, and report where the direction is entered and where CENTER returns.
+static void sweepAxis(const joy_cal_t *cal, uint8_t want, int axis, int sign,
+                      const char *oldWindow)
+{
+    joy_classifier_t c;
+    uint16_t rest = axis ? cal->cy : cal->cx;
+    uint16_t end = sign > 0 ? (axis ? cal->yMax : cal->xMax) : (axis ? cal->yMin : cal->xMin);
+    uint16_t travel = sign > 0 ? end - rest : rest - end;
+    long enter = -1, leave = -1;
+    int changes = 0;
+    uint8_t last = JOY_DIR_CENTER;
+
+    joy_classifier_init(&c, cal);
+    for (long v = rest; v != end + sign; v += sign) {
+        uint8_t d = axis ? joy_classify(&c, cal->cx, (uint16_t)v) : joy_classify(&c, (uint16_t)v, cal->cy);
+        if (d != last) { changes++; last = d; }
+        if (d == want && enter < 0) enter = v;
+    }
+    for (long v = end; v != rest - sign; v -= sign) {
+        uint8_t d = axis ? joy_classify(&c, cal->cx, (uint16_t)v) : joy_classify(&c, (uint16_t)v, cal->cy);
+        if (d != last) { changes++; last = d; }
+        if (d == JOY_DIR_CENTER && leave < 0) leave = v;
+    }
+
+    double enterPct = 100.0 * labs(enter - rest) / travel;
+    double leavePct = 100.0 * labs(leave - rest) / travel;
+    printf("%-6s enters at %4ld (%4.1f%%), CENTER again at %4ld (%4.1f%%); old window %s\n",
+           dirName[want], enter, enterPct, leave, leavePct, oldWindow);
+    CHECK(changes == 2);            // out and back, no chatter
+    CHECK(fabs(enterPct - (cal->deadZone + cal->hysteresis)) < 1.0);
+    CHECK(fabs(leavePct - cal->deadZone) < 1.0);
+}
+
+// Full deflection at every angle, each time from CENTER: the dominant axis
+// wins. Within a degree of a diagonal either neighbour is fine.
+static void testCircle(const joy_cal_t *cal)
+{
+    for (int tenth = 0; tenth < 3600; tenth++) {
+        double a = tenth * 3.141592653589793 / 1800;
+        double fx = 0.95 * cos(a), fy = -0.95 * sin(a);
+        uint16_t x, y;
+        joy_classifier_t c;
+        uint8_t want;
+
+        if (fabs(fabs(fx) - fabs(fy)) < 0.95 * sin(3.141592653589793 / 180))
+            continue;
+        want = fabs(fx) > fabs(fy) ? (fx > 0 ? JOY_DIR_LEFT : JOY_DIR_RIGHT)
+                                   : (fy < 0 ? JOY_DIR_UP : JOY_DIR_DOWN);
+        place(cal, fx, fy, &x, &y);
+        joy_classifier_init(&c, cal);
+        CHECK(joy_classify(&c, x, y) == want);
+    }
+}
+
+// Slow circles at the edge with noise on every reading: exactly four
+// direction changes per turn, however long it lingers on a diagonal.
+static void testNoisyCircle(const joy_cal_t *cal)
+{
+    joy_classifier_t c;
+    int changes = 0;
+    uint8_t last;
+    uint16_t x, y;
+
+    joy_classifier_init(&c, cal);
+    place(cal, 0.9, 0, &x, &y);
+    last = joy_classify(&c, x, y);
+    for (long step = 0; step < 10 * 20000; step++) {
+        double a = step * 2 * 3.141592653589793 / 20000;
+        int noise = (int)(rnd() % 41) - 20;
+        place(cal, 0.9 * cos(a), -0.9 * sin(a), &x, &y);
+        uint8_t d = joy_classify(&c, (uint16_t)(x + noise), (uint16_t)(y - noise));
+        if (d != last) { changes++; last = d; }
+        CHECK(d != JOY_DIR_CENTER);
+    }
+    printf("noisy circles: %d direction changes in 10 turns\n", changes);
+    CHECK(changes == 40);
+}
+
+// Every 12-bit X/Y, from CENTER: always one of the five directions, and
+// each direction covers part of the plane.
+static void testAllCodes(const joy_cal_t *cal)
+{
+    long count[5] = { 0, 0, 0, 0, 0 };
+
+    for (uint16_t x = 0; x < 4096; x++) {
+        for (uint16_t y = 0; y < 4096; y++) {
+            joy_classifier_t c;
+            joy_classifier_init(&c, cal);
+            uint8_t d = joy_classify(&c, x, y);
+            CHECK(d <= JOY_DIR_DOWN);
+            count[d <= JOY_DIR_DOWN ? d : 0]++;
+        }
+    }
+    printf("all 4096 x 4096 codes:");
+    for (int d = 0; d < 5; d++)
+        printf(" %s %.1f%%", dirName[d], 100.0 * count[d] / (4096.0 * 4096));
+    printf("\n");
+    CHECK(count[JOY_DIR_LEFT] > 0 && count[JOY_DIR_RIGHT] > 0);
+    CHECK(count[JOY_DIR_UP] > 0 && count[JOY_DIR_DOWN] > 0);
+}
+
+static void testValid(void)
+{
+    joy_cal_t cal, bad;
+    long accepted = 0;
+
+    joy_cal_default(&cal);
+    CHECK(joy_cal_valid(&cal));
+
+    bad = cal; bad.xMin = bad.cx;           CHECK(!joy_cal_valid(&bad));
+    bad = cal; bad.xMax = bad.cx + 99;      CHECK(!joy_cal_valid(&bad));
+    bad = cal; bad.yMin = 0xFFFF;           CHECK(!joy_cal_valid(&bad));
+    bad = cal; bad.yMax = 5000;             CHECK(!joy_cal_valid(&bad));
+    bad = cal; bad.deadZone = 95;           CHECK(!joy_cal_valid(&bad));
+
+    // Random 12-bit records: whatever passes keeps the rest point inside
+    for (int i = 0; i < 200000; i++) {
+        uint8_t *p = (uint8_t *)&bad;
+        for (size_t k = 0; k < sizeof bad; k++)
+            p[k] = (uint8_t)rnd();
+        bad.cx &= 0x0FFF; bad.xMin &= 0x0FFF; bad.xMax &= 0x0FFF;
+        bad.cy &= 0x0FFF; bad.yMin &= 0x0FFF; bad.yMax &= 0x0FFF;
+        bad.deadZone %= 100; bad.hysteresis %= 100;
+        if (!joy_cal_valid(&bad))
+            continue;
+        accepted++;
+        CHECK(bad.xMin < bad.cx && bad.cx < bad.xMax);
+        CHECK(bad.yMin < bad.cy && bad.cy < bad.yMax);
+    }
+    CHECK(accepted > 0);
+}
+
+// === Data EEPROM shim ===
+#define CAL_EE_ADDR 0x00
+#define CAL_MAGIC   0xC5
+
+static uint8_t eeprom[256];
+
+static void calSave(const joy_cal_t *cal)
+{
+    const uint8_t *p = (const uint8_t *)cal;
+
+    eeprom[CAL_EE_ADDR] = 0xFF;
+    for (uint8_t i = 0; i < sizeof(joy_cal_t); i++)
+        eeprom[CAL_EE_ADDR + 1 + i] = p[i];
+    eeprom[CAL_EE_ADDR + 1 + sizeof(joy_cal_t)] = jp_crc8(p, sizeof(joy_cal_t));
+    eeprom[CAL_EE_ADDR] = CAL_MAGIC;
+}
+
+static uint8_t calLoad(joy_cal_t *cal)
+{
+    uint8_t *p = (uint8_t *)cal;
+
+    if (eeprom[CAL_EE_ADDR] == CAL_MAGIC) {
+        for (uint8_t i = 0; i < sizeof(joy_cal_t); i++)
+            p[i] = eeprom[CAL_EE_ADDR + 1 + i];
+        if (eeprom[CAL_EE_ADDR + 1 + sizeof(joy_cal_t)] == jp_crc8(p, sizeof(joy_cal_t)) &&
+            joy_cal_valid(cal))
+            return 1;
+    }
+    joy_cal_default(cal);
+    return 0;
+}
+
+static void testRecord(void)
+{
+    joy_cal_t saved = { 1700, 1580, 40, 3900, 90, 3700, 30, 8 }, loaded, def;
+    uint8_t n = sizeof(joy_cal_t) + 2;
+
+    joy_cal_default(&def);
+
+    memset(eeprom, 0xFF, sizeof eeprom);            // erased part
+    CHECK(!calLoad(&loaded) && memcmp(&loaded, &def, sizeof def) == 0);
+
+    calSave(&saved);
+    CHECK(calLoad(&loaded) && memcmp(&loaded, &saved, sizeof saved) == 0);
+
+    // Any single-bit error in the record falls back to the defaults
+    for (int bit = 0; bit < n * 8; bit++) {
+        eeprom[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        CHECK(!calLoad(&loaded) && memcmp(&loaded, &def, sizeof def) == 0);
+        eeprom[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    }
+
+    // A good CRC over out-of-range values is still rejected
+    saved.cx = 4000;
+    calSave(&saved);
+    CHECK(!calLoad(&loaded) && memcmp(&loaded, &def, sizeof def) == 0);
+}
+
+int main(void)
+{
+    joy_cal_t cal;
+
+    joy_cal_default(&cal);
+    sweepAxis(&cal, JOY_DIR_LEFT, 0, +1, "X 3200..3300");
+    sweepAxis(&cal, JOY_DIR_RIGHT, 0, -1, "X 6..60");
+    sweepAxis(&cal, JOY_DIR_UP, 1, -1, "Y 6..60");
+    sweepAxis(&cal, JOY_DIR_DOWN, 1, +1, "Y 3200..3300");
+    testCircle(&cal);
+    testNoisyCircle(&cal);
+    testAllCodes(&cal);
+
+    // An off-centre stick with uneven travel
+    cal.cx = 1900; cal.xMin = 300; cal.xMax = 3600;
+    cal.cy = 1400; cal.yMin = 150; cal.yMax = 4000;
+    sweepAxis(&cal, JOY_DIR_LEFT, 0, +1, "-");
+    sweepAxis(&cal, JOY_DIR_UP, 1, -1, "-");
+    testCircle(&cal);
+    testNoisyCircle(&cal);
+
+    testValid();
+    testRecord();
+    return check_done("test_joy_classify");
+}
@@ -0,0 +1,217 @@
+// Round-trip and corruption tests for joy_protocol.c, plus the wire-time
+// table from joy_protocol.h worked out from the frame sizes and checked
+// against the header, so the two cannot drift apart.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "joy_protocol.h"
+#include "check.h"
+
+#define HEADER_PATH "../Project2/joy_protocol.h"
+
+static uint32_t seed = 7;
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// Feeds n bytes and returns the last event decoded (JP_NONE if none); the
+// number of events is left in *events.
+static uint8_t feed(jp_decoder_t *d, const uint8_t *b, uint8_t n, int *events)
+{
+    uint8_t last = JP_NONE;
+
+    *events = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t ev = jp_decode(d, b[i]);
+        if (ev != JP_NONE) {
+            last = ev;
+            (*events)++;
+        }
+    }
+    return last;
+}
+
+static void testCrc(void)
+{
+    // CRC-8 (poly 0x07, init 0) check value
+    CHECK(jp_crc8((const uint8_t *)"123456789", 9) == 0xF4);
+    CHECK(jp_crc8((const uint8_t *)"", 0) == 0x00);
+}
+
+static void testRoundTrip(void)
+{
+    jp_decoder_t d;
+    uint8_t f[JP_FRAME_MAX];
+    int events;
+
+    jp_decoder_init(&d);
+    for (uint8_t ev = 0; ev <= JP_EV_MAX; ev++) {
+        CHECK(jp_encode(f, ev) == 3);
+        CHECK(f[0] == JP_SYNC);
+        CHECK(feed(&d, f, 3, &events) == ev && events == 1);
+        CHECK(!jp_decoder_busy(&d));
+    }
+
+    // Every X with a few Y, every Y with a few X
+    for (uint16_t a = 0; a < 4096; a++) {
+        static const uint16_t others[] = { 0, 1, 0x800, 0xFFF };
+        for (int k = 0; k < 4; k++) {
+            uint8_t ev = (uint8_t)(1 + (a + k) % JP_EV_MAX);
+            CHECK(jp_encode_xy(f, ev, a, others[k]) == 6);
+            CHECK(feed(&d, f, 6, &events) == ev && events == 1);
+            CHECK(d.x == a && d.y == others[k]);
+            jp_encode_xy(f, ev, others[k], a);
+            CHECK(feed(&d, f, 6, &events) == ev);
+            CHECK(d.x == others[k] && d.y == a);
+        }
+    }
+    CHECK(d.crcErrors == 0);
+}
+
+// CRC-8 with this polynomial catches every 1- and 2-bit error in a frame
+// this short, so a corrupted frame is never taken for another event, and
+// the good frame after it always decodes.
+static void testBitErrors(void)
+{
+    uint8_t f[JP_FRAME_MAX], good[JP_FRAME_MAX];
+    int events;
+
+    for (int xy = 0; xy < 2; xy++) {
+        uint8_t n = xy ? jp_encode_xy(good, JP_EV_BTN_UP, 0x123, 0xABC)
+                       : jp_encode(good, JP_EV_JOY_DOWN);
+        for (int b1 = 8; b1 < n * 8; b1++) {            // not the SYNC byte
+            for (int b2 = b1; b2 < n * 8; b2++) {
+                jp_decoder_t d;
+                jp_decoder_init(&d);
+                memcpy(f, good, n);
+                f[b1 / 8] ^= (uint8_t)(0x80 >> (b1 % 8));
+                if (b2 != b1)
+                    f[b2 / 8] ^= (uint8_t)(0x80 >> (b2 % 8));
+
+                feed(&d, f, n, &events);
+                CHECK(events == 0);
+
+                // The next frame gets through, however the bad one ended
+                jp_encode(f, JP_EV_JOY_LEFT);
+                for (int pad = 0; pad < JP_FRAME_MAX && jp_decoder_busy(&d); pad++) {
+                    uint8_t idle = 0x00;
+                    feed(&d, &idle, 1, &events);
+                }
+                CHECK(feed(&d, f, 3, &events) == JP_EV_JOY_LEFT);
+            }
+        }
+    }
+}
+
+// Frames mixed with ASCII lines and random bytes, the way the ESP8266 sees
+// the link while the PIC switches modes: every frame that is not broken
+// must come out, in order.
+static void testNoisyStream(void)
+{
+    jp_decoder_t d;
+    int sent = 0, got = 0, wrong = 0;
+    uint8_t expect[16];
+    int expectHead = 0, expectTail = 0;
+
+    jp_decoder_init(&d);
+    for (int round = 0; round < 200000; round++) {
+        uint8_t f[JP_FRAME_MAX + 8];
+        uint8_t n = 0;
+
+        switch (rnd() % 3) {
+        case 0: {                                       // a frame
+            uint8_t ev = (uint8_t)(1 + rnd() % JP_EV_MAX);
+            n = rnd() & 1 ? jp_encode(f, ev)
+                          : jp_encode_xy(f, ev, (uint16_t)(rnd() & 0xFFF), (uint16_t)(rnd() & 0xFFF));
+            expect[expectHead++ & 15] = ev;
+            sent++;
+            break;
+        }
+        case 1:                                         // ASCII text
+            memcpy(f, "CENTER\r\n", 8);
+            n = 8;
+            break;
+        default:                                        // line noise, no SYNC
+            n = (uint8_t)(1 + rnd() % 8);
+            for (uint8_t i = 0; i < n; i++) {
+                f[i] = (uint8_t)rnd();
+                if (f[i] == JP_SYNC) f[i] = 0;
+            }
+            break;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            uint8_t ev = jp_decode(&d, f[i]);
+            if (ev == JP_NONE) continue;
+            got++;
+            // Noise that starts a frame can swallow the start of the next
+            // one, so skip expected events until this one
+            while (expectTail != expectHead && expect[expectTail & 15] != ev)
+                expectTail++;
+            if (expectTail == expectHead) wrong++;
+            else expectTail++;
+        }
+    }
+    printf("noisy stream: %d frames sent, %d decoded, %d not matched\n", sent, got, wrong);
+    CHECK(wrong == 0);
+    CHECK(got >= sent * 99 / 100);
+}
+
+static void printWireTimes(void)
+{
+    static const struct { const char *what; int bytes; } rows[] = {
+        { "\"RIGHT (button)\\r\\n\"", 16 },
+        { "\"CENTER\\r\\n\"", 8 },
+        { "binary frame", 3 },
+        { "binary frame + X/Y", JP_FRAME_MAX },
+    };
+    uint8_t f[JP_FRAME_MAX];
+
+    CHECK(jp_encode(f, JP_EV_JOY_UP) == rows[2].bytes);
+    CHECK(jp_encode_xy(f, JP_EV_JOY_UP, 1, 2) == rows[3].bytes);
+    CHECK(strlen("RIGHT (button)\r\n") == 16);
+
+    printf("%-24s %5s %12s %13s\n", "message", "bytes", "9600 baud", "115200 baud");
+    for (int i = 0; i < 4; i++) {
+        double slow = rows[i].bytes * 10 * 1000.0 / 9600;
+        double fast = rows[i].bytes * 10 * 1000.0 / 115200;
+        printf("%-24s %5d %9.3f ms %10.3f ms\n", rows[i].what, rows[i].bytes, slow, fast);
+
+        // The table in joy_protocol.h must show the same figures
+        FILE *f = fopen(HEADER_PATH, "r");
+        char line[128];
+        int found = 0;
+
+        CHECK(f != NULL);
+        while (f && fgets(line, sizeof line, f)) {
+            const char *at = strstr(line, rows[i].what);
+            int bytes;
+            double hSlow, hFast;
+
+            if (at && sscanf(at + strlen(rows[i].what), "%d %lf ms %lf ms",
+                             &bytes, &hSlow, &hFast) == 3) {
+                CHECK(bytes == rows[i].bytes);
+                CHECK(fabs(hSlow - slow) < 0.0005 && fabs(hFast - fast) < 0.0005);
+                found++;
+            }
+        }
+        if (f)
+            fclose(f);
+        CHECK(found == 1);
+    }
+}
+
+int main(void)
+{
+    testCrc();
+    testRoundTrip();
+    testBitErrors();
+    testNoisyStream();
+    printWireTimes();
+    return check_done("test_joy_protocol");
+}
@@ -0,0 +1,135 @@
+// Chord tests for keymatrix.c against a model of the 4x4 matrix without
+// diodes.
+//
+// Closed keys join their row and column wires. Driving one row low pulls
+// down every column wired to it through any chain of closed keys, so the
+// scan reads a key at each such column even if that key is open. The
+// model computes that scan for a set of pressed keys, and the tests check
+// that keymatrix_ghosted() throws away exactly the scans that cannot be
+// trusted.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "keymatrix.h"
+#include "check.h"
+
+static int bits(uint16_t m)
+{
+    int n = 0;
+    for (; m; m &= (uint16_t)(m - 1))
+        n++;
+    return n;
+}
+
+// What Scan() in keypad.c reads with these keys held
+static uint16_t scanMatrix(uint16_t pressed)
+{
+    uint16_t map = 0;
+
+    for (uint8_t row = 0; row < 4; row++) {
+        uint8_t rows = (uint8_t)(1u << row), cols = 0, grew = 1;
+
+        // Grow the set of wires pulled low until nothing more joins
+        while (grew) {
+            grew = 0;
+            for (uint8_t r = 0; r < 4; r++) {
+                if (!(rows & (1u << r)))
+                    continue;
+                uint8_t c = KEYMATRIX_ROW(pressed, r);
+                if (c & ~cols) { cols |= c; grew = 1; }
+            }
+            for (uint8_t r = 0; r < 4; r++) {
+                if (!(rows & (1u << r)) && (KEYMATRIX_ROW(pressed, r) & cols)) {
+                    rows |= (uint8_t)(1u << r);
+                    grew = 1;
+                }
+            }
+        }
+        map |= (uint16_t)cols << (row * 4);
+    }
+    return map;
+}
+
+// Three corners of a rectangle: two keys in one row, one in another row
+// under one of them.
+static int isThreeCorner(uint16_t pressed)
+{
+    for (uint8_t a = 0; a < 4; a++)
+        for (uint8_t b = 0; b < 4; b++) {
+            uint8_t ra = KEYMATRIX_ROW(pressed, a), rb = KEYMATRIX_ROW(pressed, b);
+            if (a != b && bits(ra) == 2 && bits(rb) == 1 && (rb & ra))
+                return 1;
+        }
+    return 0;
+}
+
+static void testChords(void)
+{
+    int pairs = 0, triples = 0, flagged2 = 0, flagged3 = 0;
+
+    for (int i = 0; i < 16; i++) {
+        for (int j = i + 1; j < 16; j++) {
+            uint16_t p = (uint16_t)(1u << i | 1u << j);
+            uint16_t scan = scanMatrix(p);
+            pairs++;
+            CHECK(scan == p);                   // two keys never ghost
+            if (keymatrix_ghosted(scan)) flagged2++;
+
+            for (int k = j + 1; k < 16; k++) {
+                uint16_t p3 = (uint16_t)(p | 1u << k);
+                uint16_t scan3 = scanMatrix(p3);
+                triples++;
+                if (keymatrix_ghosted(scan3)) {
+                    flagged3++;
+                    CHECK(isThreeCorner(p3));
+                    CHECK(bits(scan3) == 4);    // the phantom fourth corner
+                } else {
+                    CHECK(!isThreeCorner(p3));
+                    CHECK(scan3 == p3);
+                }
+            }
+        }
+    }
+    printf("%d two-key chords, %d flagged; %d three-key chords, %d flagged\n",
+           pairs, flagged2, triples, flagged3);
+    CHECK(pairs == 120 && flagged2 == 0);
+    CHECK(triples == 560 && flagged3 == 144);
+}
+
+// Every set of held keys: a scan that is not thrown away reads exactly the
+// keys that are down, so no phantom key is ever reported.
+static void testAllSets(void)
+{
+    long accepted = 0;
+
+    for (uint32_t p = 0; p < 0x10000; p++) {
+        uint16_t scan = scanMatrix((uint16_t)p);
+        CHECK((scan & p) == p);
+        if (!keymatrix_ghosted(scan)) {
+            accepted++;
+            CHECK(scan == p);
+        }
+    }
+    printf("all 65536 key sets: %ld read exactly, the rest discarded\n", accepted);
+}
+
+static void testHelpers(void)
+{
+    CHECK(keymatrix_first(0) == 16);
+    for (uint8_t i = 0; i < 16; i++) {
+        CHECK(keymatrix_first((uint16_t)(1u << i)) == i);
+        CHECK(keymatrix_first((uint16_t)(0x8000u | 1u << i)) == i);
+    }
+    CHECK(KEYMATRIX_BIT(2, 3) == 0x0800);
+    CHECK(KEYMATRIX_ROW(0x0A50, 1) == 0x5);
+    CHECK(KEYMATRIX_PRESSED(0x0011, 0x0110) == 0x0100);
+    CHECK(KEYMATRIX_RELEASED(0x0011, 0x0110) == 0x0001);
+}
+
+int main(void)
+{
+    testChords();
+    testAllSets();
+    testHelpers();
+    return check_done("test_keymatrix");
+}
@@ -0,0 +1,264 @@
+// Key-script replay for keypad.c (with keymatrix.c) behind the register
+// shim (shim/xc.h).
+//
+// A script of presses, single keys and two-key rollovers, is played in
+// 100 us steps against a model of the 4x4 matrix: the columns read on
+// PORTC are pulled low by closed keys on the rows LATA drives low, and
+// every key chatters at random for 3 ms after it moves. A falling column
+// with IOC armed runs keypad_ioc_isr(); TMR6 runs the scan ISR on the
+// period read back from T6CON/T6PR while it is on. The main loop drains
+// the event queue every 1..20 ms.
+//
+// Checked: at 15..55 ms between key transitions (holds, gaps and the
+// overlap of a rollover) every press and release comes out exactly once
+// and in order, and the tick is off with IOC armed again once the keypad
+// is idle. keypad_held() leaves GIE as it found it. Shorter spacings are swept to show where the debounce starts
+// losing keys.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <xc.h>
+#include "keypad.h"
+#include "keymatrix.h"
+#include "check.h"
+
+#define STEP_US    100
+#define BOUNCE_US  3000
+
+void KEYPAD_ISR(void);
+
+static const char keymap[16] = "123A456B789C*0#D";
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(uint32_t n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % n;
+}
+
+// === Matrix model ===
+static uint16_t pressed;            // what the script holds down
+static uint16_t contact;            // what the contacts do this step
+static uint64_t bounceUntil[16];
+static uint64_t nowUs;
+
+// Columns (bits 0-3) pulled low with the rows LATA drives low. Two keys
+// cannot make a phantom path, so no chains are needed here.
+static uint8_t ColsLow(void)
+{
+    uint8_t cols = 0;
+
+    for (uint8_t row = 0; row < 4; row++)
+        if (!(LATA & (1u << row)))
+            cols |= KEYMATRIX_ROW(contact, row);
+    return cols;
+}
+
+static uint8_t ReadPortc(void)
+{
+    return (uint8_t)~(ColsLow() << 4);
+}
+
+static void setKey(int key, int down)
+{
+    if (down)
+        pressed |= (uint16_t)(1u << key);
+    else
+        pressed &= (uint16_t)~(1u << key);
+    bounceUntil[key] = nowUs + BOUNCE_US;
+}
+
+// === Hardware ===
+static uint8_t prevCols;
+static uint32_t t6Us;
+
+static void step(void)
+{
+    nowUs += STEP_US;
+    contact = pressed;
+    for (int k = 0; k < 16; k++)
+        if (nowUs < bounceUntil[k] && rnd(2))
+            contact ^= (uint16_t)(1u << k);
+
+    // Interrupt-on-change: falling edges on armed columns
+    uint8_t cols = ColsLow();
+    uint8_t falling = (uint8_t)((cols & ~prevCols) << 4) & IOCCN;
+    prevCols = cols;
+    if (falling) {
+        IOCCF |= falling;
+        if (PIE0bits.IOCIE && INTCON0bits.GIE) {
+            T6TMR = 1;
+            keypad_ioc_isr();
+            if (T6TMR == 0)
+                t6Us = 0;
+        }
+    }
+
+    // TMR6: FOSC/4 at 1 MHz through the prescale in T6CON, period T6PR
+    if (T6CONbits.ON) {
+        uint32_t period = (T6PR + 1u) << ((T6CON >> 4) & 7);
+        t6Us += STEP_US;
+        if (t6Us >= period) {
+            t6Us -= period;
+            if (TMR6IE && INTCON0bits.GIE) {
+                TMR6IF = 1;
+                KEYPAD_ISR();
+            }
+        }
+    }
+}
+
+// === Script ===
+typedef struct {
+    uint64_t at;
+    uint8_t key;
+    uint8_t down;
+} move_t;
+
+#define MAX_MOVES 80000
+static move_t script[MAX_MOVES];
+static uint8_t got[MAX_MOVES * 2];
+static int moveCount, gotCount;
+
+// Presses with every transition minMs..maxMs after the one before; a
+// third of them roll over into the next key
+static void makeScript(int presses, int minMs, int maxMs)
+{
+    uint64_t t = nowUs + 50000;
+
+    moveCount = 0;
+    for (int i = 0; i < presses && moveCount + 4 <= MAX_MOVES; i++) {
+        int a = (int)rnd(16);
+        uint64_t gap = (uint64_t)(minMs + (int)rnd((uint32_t)(maxMs - minMs + 1))) * 1000;
+
+        script[moveCount++] = (move_t){ t, (uint8_t)a, 1 };
+        if (rnd(3) == 0) {
+            int b = (int)rnd(15);
+            if (b >= a) b++;
+            t += gap;
+            script[moveCount++] = (move_t){ t, (uint8_t)b, 1 };
+            t += (uint64_t)(minMs + (int)rnd((uint32_t)(maxMs - minMs + 1))) * 1000;
+            script[moveCount++] = (move_t){ t, (uint8_t)a, 0 };
+            t += (uint64_t)(minMs + (int)rnd((uint32_t)(maxMs - minMs + 1))) * 1000;
+            script[moveCount++] = (move_t){ t, (uint8_t)b, 0 };
+        } else {
+            t += gap;
+            script[moveCount++] = (move_t){ t, (uint8_t)a, 0 };
+        }
+        t += (uint64_t)(minMs + (int)rnd((uint32_t)(maxMs - minMs + 1))) * 1000;
+    }
+}
+
+static void drainQueue(void)
+{
+    uint8_t ev;
+
+    while ((ev = keypad_get_event()) != KEYPAD_NONE && gotCount < (int)sizeof got)
+        got[gotCount++] = ev;
+}
+
+static uint8_t wantEvent(int j)
+{
+    return (uint8_t)((uint8_t)keymap[script[j].key] | (script[j].down ? 0 : KEYPAD_EV_UP));
+}
+
+typedef struct {
+    int missed, extra;          // in sequence: out of order counts as both
+    int lost, dup;              // by count per key and direction
+} result_t;
+
+// Plays the script and compares the events with it. After a mismatch the
+// next few transitions are searched so one miss is counted once.
+static result_t play(void)
+{
+    uint64_t nextRead = nowUs;
+    int m = 0;
+
+    gotCount = 0;
+    while (m < moveCount || nowUs < script[moveCount - 1].at + 100000) {
+        while (m < moveCount && script[m].at <= nowUs) {
+            setKey(script[m].key, script[m].down);
+            m++;
+        }
+        step();
+        if (nowUs >= nextRead) {
+            drainQueue();
+            nextRead = nowUs + 1000 + rnd(19000);
+        }
+    }
+    drainQueue();
+
+    result_t r = { 0, 0, 0, 0 };
+    int j = 0;
+    for (int i = 0; i < gotCount; i++) {
+        int d = 0;
+        while (d < 8 && j + d < moveCount && got[i] != wantEvent(j + d))
+            d++;
+        if (d < 8 && j + d < moveCount) {
+            r.missed += d;
+            j += d + 1;
+        } else {
+            r.extra++;
+        }
+    }
+    r.missed += moveCount - j;
+
+    int count[256] = { 0 };
+    for (int i = 0; i < moveCount; i++)
+        count[wantEvent(i)]++;
+    for (int i = 0; i < gotCount; i++)
+        count[got[i]]--;
+    for (int e = 0; e < 256; e++) {
+        if (count[e] > 0) r.lost += count[e];
+        if (count[e] < 0) r.dup -= count[e];
+    }
+    return r;
+}
+
+static void testNominal(void)
+{
+    makeScript(20000, 15, 55);
+    result_t r = play();
+    CHECK(r.missed == 0 && r.extra == 0);
+    CHECK(r.lost == 0 && r.dup == 0);
+    CHECK(pressed == 0 && keypad_held() == 0);
+    CHECK(!T6CONbits.ON && !TMR6IE);            // tick off when idle
+    CHECK((IOCCN & 0xF0) == 0xF0);              // waiting on IOC again
+    printf("  15-55 ms: %d transitions, %d missed, %d duplicated\n",
+           moveCount, r.lost, r.dup);
+}
+
+static void testSweep(void)
+{
+    for (int ms = 20; ms >= 6; ms -= 2) {
+        makeScript(3000, ms, ms);
+        result_t r = play();
+        if (ms >= 15) {
+            CHECK(r.missed == 0 && r.extra == 0);
+            CHECK(r.lost == 0 && r.dup == 0);
+        }
+        printf("  every %2d ms: %5d transitions, %4d missed, %4d duplicated, "
+               "%4d out of order\n", ms, moveCount, r.lost, r.dup, r.missed - r.lost);
+    }
+}
+
+int main(void)
+{
+    xc_shim_read_portc = ReadPortc;
+    LATA = 0xFF;
+    keypad_init(keymap);
+    INTCON0bits.GIE = 1;
+    CHECK(PIE0bits.IOCIE && (IOCCN & 0xF0) == 0xF0 && !T6CONbits.ON);
+
+    testNominal();
+    testSweep();
+
+    INTCON0bits.GIE = 0;
+    keypad_held();
+    CHECK(!INTCON0bits.GIE);
+    INTCON0bits.GIE = 1;
+    keypad_held();
+    CHECK(INTCON0bits.GIE);
+    return check_done("test_keypad");
+}
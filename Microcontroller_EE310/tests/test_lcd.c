@@ -0,0 +1,385 @@
+// The queued HD44780 driver (lcd.c) against a mock controller behind the
+// register shim (shim/xc.h). Built twice: with the fixed 100 us timing and
+// with LCD_RW, where the ISR polls the busy flag.
+//
+// The mock latches RS and the data bus in the middle of each EN pulse
+// (the shim's NOP() hook), keeps its own DDRAM and address counter, and
+// is busy for 37 us after a write and 1.52 ms after clear/home, as on the
+// datasheet. In the LCD_RW build it answers busy-flag reads on RB7. Time
+// moves 100 us per TMR4 interrupt, and the ISR only runs while TMR4IE is
+// set.
+//
+// Checked: the bytes reach the glass in the order they were queued, none
+// while the controller is busy, the screen ends up as drawn, the calls
+// return before a single byte is written, and LCD_Wait_Idle() returns
+// after a clear in both builds (it runs against a real periodic signal
+// standing in for TMR4). The main-loop time freed per frame is reported
+// against the old MSdelay() driver, which blocked 2 ms per command and
+// 1 ms per character; the new figure is counted interrupts, not cycles.
+//
+// Frame API: lcd_flush() is run over a stream of voltmeter frames and the
+// bus writes per frame are counted against the old way of redrawing
+// (ADC_Voltage_Reader.c rewrote the title, blanked line 2 and rewrote it
+// every update). Each flush must write exactly the cells that changed,
+// move the cursor only where the changes are not contiguous, leave the
+// glass equal to the frame, and carry on after a full FIFO.
+
+#define _XOPEN_SOURCE 700
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <xc.h>
+#include "lcd.h"
+#include "check.h"
+
+#ifdef LCD_RW
+#define BUILD "busy flag"
+#else
+#define BUILD "fixed timing"
+#endif
+
+#define TICK_US      100
+#define BUSY_US      37
+#define SLOW_US      1520
+
+void LCD_ISR(void);
+
+// === Mock HD44780 ===
+static struct {
+    char ddram[0x80];
+    uint8_t ac;
+    unsigned long busyUntil;
+    uint8_t log[512];           // bytes latched, in order
+    uint8_t logRS[512];         // RS with each
+    int logLen;
+    int early;                  // writes while busy
+    int reads;                  // busy-flag reads
+} lcd;
+
+static volatile unsigned long nowUs;
+static int timingChecked;
+
+static void mockNop(void)
+{
+    if (!LATD1)                 // not inside an EN pulse
+        return;
+    if (LATD2) {                // R/W high: busy-flag read
+        lcd.reads++;
+        PORTBbits.RB7 = nowUs < lcd.busyUntil;
+        return;
+    }
+    if (timingChecked && nowUs < lcd.busyUntil)
+        lcd.early++;
+    if (lcd.logLen < (int)sizeof lcd.log) {
+        lcd.log[lcd.logLen] = LATB;
+        lcd.logRS[lcd.logLen++] = LATD0;
+    }
+
+    uint8_t v = LATB;
+    unsigned long busy = BUSY_US;
+    if (LATD0) {
+        lcd.ddram[lcd.ac & 0x7F] = (char)v;
+        lcd.ac = (uint8_t)((lcd.ac + 1) & 0x7F);
+    } else if (v & 0x80) {
+        lcd.ac = v & 0x7F;
+    } else if (v == 0x01) {
+        memset(lcd.ddram, ' ', sizeof lcd.ddram);
+        lcd.ac = 0;
+        busy = SLOW_US;
+    } else if (v == 0x02 || v == 0x03) {
+        lcd.ac = 0;
+        busy = SLOW_US;
+    }
+    lcd.busyUntil = nowUs + busy;
+}
+
+static void row(int r, char *out)
+{
+    memcpy(out, &lcd.ddram[r ? 0x40 : 0x00], LCD_COLS);
+    out[LCD_COLS] = 0;
+}
+
+// === Interrupt ===
+static void tick(void)
+{
+    nowUs += TICK_US;
+    if (TMR4IE) {
+        TMR4IF = 1;
+        LCD_ISR();
+    }
+}
+
+// Ticks until the FIFO is empty and the ISR has switched itself off;
+// returns how many ISR entries that took
+static int drain(void)
+{
+    int n = 0;
+
+    while (TMR4IE && n < 100000) {
+        tick();
+        n++;
+    }
+    CHECK(!TMR4IE);
+    return n;
+}
+
+static void setup(void)
+{
+    memset(&lcd, 0, sizeof lcd);
+    xc_shim_on_nop = mockNop;
+    timingChecked = 0;          // LCD_Init() writes directly with __delay_ms()
+    LCD_Init();
+    lcd.busyUntil = nowUs;
+    lcd.logLen = 0;
+    timingChecked = 1;
+}
+
+// Commands and characters arrive in queue order, never while busy
+static void testOrder(void)
+{
+    static const uint8_t want[] = {
+        0x80, 'V', 'o', 'l', 't', 'a', 'g', 'e', ' ', 'R', 'e', 'a', 'd', 'i', 'n', 'g', ':',
+        0x01,
+        0xC3, '1', '.', '2', '3', '4', ' ', 'V',
+        0x02,
+        0x8E, 'o', 'k',
+    };
+    static const uint8_t wantRS[] = {
+        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        0,
+        0, 1, 1, 1, 1, 1, 1, 1,
+        0,
+        0, 1, 1,
+    };
+    char text[LCD_COLS + 1];
+
+    setup();
+    LCD_String_xy(1, 0, "Voltage Reading:");
+    LCD_Clear();
+    LCD_String_xy(2, 3, "1.234 V");
+    LCD_Command(0x02);
+    LCD_String_xy(1, 14, "ok");
+    CHECK(lcd.logLen == 0);     // nothing written yet: the calls only queue
+    drain();
+
+    CHECK(lcd.early == 0);
+    CHECK(lcd.logLen == (int)sizeof want);
+    for (int i = 0; i < lcd.logLen && i < (int)sizeof want; i++)
+        CHECK(lcd.log[i] == want[i] && lcd.logRS[i] == wantRS[i]);
+    row(0, text);
+    CHECK(strcmp(text, "              ok") == 0);
+    row(1, text);
+    CHECK(strcmp(text, "   1.234 V      ") == 0);
+    CHECK(lcd_dropped == 0);
+#ifdef LCD_RW
+    CHECK(lcd.reads > 0);
+#endif
+}
+
+// A full FIFO drops and counts instead of waiting
+static void testOverflow(void)
+{
+    setup();
+    uint16_t before = lcd_dropped;
+    for (int i = 0; i < LCD_FIFO_SIZE + 10; i++)
+        LCD_Char('x');
+    CHECK(lcd_dropped == before + 10);
+    drain();
+    CHECK(lcd.logLen == LCD_FIFO_SIZE && lcd.early == 0);
+}
+
+// The frame ADC_Voltage_Reader.c used to send every 500 ms: clear, then
+// both lines through LCD_String_xy
+static void testFrameCost(void)
+{
+    setup();
+    LCD_Clear();
+    LCD_String_xy(1, 0, "Voltage Reading:");
+    LCD_String_xy(2, 0, "Volt: 1.234 V");
+    int bytes = 0, cmds = 0;
+    int isr = drain();
+    for (int i = 0; i < lcd.logLen; i++) {
+        bytes++;
+        cmds += !lcd.logRS[i];
+    }
+    int oldMs = 2 * cmds + (bytes - cmds);
+    CHECK(lcd.early == 0 && bytes == 3 + 16 + 13);
+    printf("  %s: %d bytes per frame; MSdelay() driver blocked main %d ms,\n"
+           "  now queued at once and written by %d TMR4 interrupts over %.1f ms\n",
+           BUILD, bytes, oldMs, isr, isr * TICK_US / 1000.0);
+}
+
+// LCD_Wait_Idle() with the ISR running from a real periodic signal, as
+// TMR4 would interrupt it. A watchdog in the handler fails the test if it
+// never returns.
+static volatile int watchdog;
+
+static void onAlarm(int sig)
+{
+    (void)sig;
+    tick();
+    if (++watchdog > 5000) {
+        static const char msg[] = "test_lcd: LCD_Wait_Idle() never returned\n";
+        write(1, msg, sizeof msg - 1);
+        _exit(1);
+    }
+}
+
+static void testWaitIdle(void)
+{
+    struct sigaction sa;
+    struct itimerval it = { { 0, 200 }, { 0, 200 } };
+    struct itimerval off = { { 0, 0 }, { 0, 0 } };
+
+    setup();
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = onAlarm;
+    sigaction(SIGALRM, &sa, NULL);
+    watchdog = 0;
+    LCD_Clear();
+    LCD_String_xy(1, 0, "after clear");
+    setitimer(ITIMER_REAL, &it, NULL);
+    LCD_Wait_Idle();
+    setitimer(ITIMER_REAL, &off, NULL);
+
+    char text[LCD_COLS + 1];
+    row(0, text);
+    CHECK(strcmp(text, "after clear     ") == 0);
+    CHECK(lcd.early == 0);
+}
+
+// Counts the characters in the frame that differ from the glass
+static int changedCells(char want[2][LCD_COLS + 1])
+{
+    int n = 0;
+    char text[LCD_COLS + 1];
+
+    for (int r = 0; r < 2; r++) {
+        row(r, text);
+        for (int c = 0; c < LCD_COLS; c++)
+            n += text[c] != want[r][c];
+    }
+    return n;
+}
+
+static void drawVolts(char want[2][LCD_COLS + 1], unsigned mv)
+{
+    lcd_frame_clear();
+    lcd_puts_at(1, 0, "Voltage Reading:");
+    lcd_printf_at(2, 0, "Volt: %u.%03u V", mv / 1000 % 10, mv % 1000);
+    snprintf(want[0], LCD_COLS + 1, "%-16s", "Voltage Reading:");
+    snprintf(want[1], LCD_COLS + 1, "Volt: %u.%03u V   ", mv / 1000 % 10, mv % 1000);
+}
+
+static void testFlush(void)
+{
+    static const unsigned readings[] = {
+        1234, 1234, 1235, 1240, 1299, 2000, 2000, 3300, 0, 999, 1000, 1001
+    };
+    char want[2][LCD_COLS + 1];
+    char text[LCD_COLS + 1];
+    long oldBytes = 0, newBytes = 0;
+
+    setup();
+    LCD_Clear();
+    drain();
+    for (unsigned i = 0; i < sizeof readings / sizeof readings[0]; i++) {
+        // Before: title, blank line 2, value, as the old loop did
+        lcd.logLen = 0;
+        LCD_String_xy(1, 0, "Voltage Reading:");
+        LCD_String_xy(2, 0, "                ");
+        char line[LCD_COLS + 1];
+        snprintf(line, sizeof line, "Volt: %u.%03u V", readings[i] / 1000 % 10, readings[i] % 1000);
+        LCD_String_xy(2, 0, line);
+        drain();
+        oldBytes += lcd.logLen;
+
+        // After: the same screen through the frame, from a glass that
+        // still shows the previous reading
+        drawVolts(want, i ? readings[i - 1] : 0);
+        lcd_flush();
+        drain();
+        drawVolts(want, readings[i]);
+        int changed = changedCells(want);
+        lcd.logLen = 0;
+        lcd_flush();
+        drain();
+        newBytes += lcd.logLen;
+
+        int chars = 0, moves = 0;
+        for (int k = 0; k < lcd.logLen; k++) {
+            if (lcd.logRS[k])
+                chars++;
+            else
+                moves++;
+        }
+        CHECK(chars == changed);        // every changed cell, nothing else
+        CHECK(moves <= chars);
+        CHECK(lcd.early == 0);
+        for (int r = 0; r < 2; r++) {
+            row(r, text);
+            CHECK(strcmp(text, want[r]) == 0);
+        }
+    }
+
+    // Unchanged frame: nothing on the bus
+    lcd.logLen = 0;
+    lcd_flush();
+    drain();
+    CHECK(lcd.logLen == 0);
+
+    // One run of changed cells needs one cursor move: 1.001 -> 1.876
+    lcd_frame_clear();
+    lcd_puts_at(1, 0, "Voltage Reading:");
+    lcd_puts_at(2, 0, "Volt: 1.876 V");
+    lcd.logLen = 0;
+    lcd_flush();
+    drain();
+    CHECK(lcd.logLen == 1 + 3 && lcd.log[0] == 0xC8);
+
+    printf("  %.1f bus writes per frame redrawn in full, %.1f through lcd_flush()\n",
+           (double)oldBytes / (sizeof readings / sizeof readings[0]),
+           (double)newBytes / (sizeof readings / sizeof readings[0]));
+}
+
+// A whole screen change is more than the FIFO holds; flush sends what
+// fits and the rest on the next calls
+static void testFlushFull(void)
+{
+    char text[LCD_COLS + 1];
+
+    setup();
+    LCD_Clear();
+    drain();
+    lcd_frame_clear();
+    lcd_puts_at(1, 0, "0123456789abcdef");
+    lcd_puts_at(2, 0, "ABCDEFGHIJKLMNOP");
+    for (int i = 0; i < LCD_FIFO_SIZE + 8; i++)   // fill the FIFO first
+        LCD_Command(0x06);
+    uint16_t dropped = lcd_dropped;
+    lcd_flush();                        // no room: nothing queued, nothing lost
+    CHECK(lcd_dropped == dropped);
+    for (int pass = 0; pass < 4; pass++) {
+        drain();
+        lcd_flush();
+    }
+    drain();
+    row(0, text);
+    CHECK(strcmp(text, "0123456789abcdef") == 0);
+    row(1, text);
+    CHECK(strcmp(text, "ABCDEFGHIJKLMNOP") == 0);
+}
+
+int main(void)
+{
+    testOrder();
+    testOverflow();
+    testFrameCost();
+    testFlush();
+    testFlushFull();
+    testWaitIdle();
+    return check_done("test_lcd (" BUILD ")");
+}
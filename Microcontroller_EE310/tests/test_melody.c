@@ -0,0 +1,137 @@
+// Note table and sequencer of melody.c, with tone_start()/tone_stop()
+// recorded instead of driving CCP2.
+//
+// Every note's frequency, FOSC/4 / ((pr + 1) << ckps), is checked against
+// equal temperament from A4 = 440 Hz to the 0.35% melody.h promises, with
+// the smallest prescale that fits and the period the nearest one. The
+// sequencer is run on a counted tick: each step lasts exactly its ms, a
+// loop starts over, and the tone is off once a melody ends or is stopped.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "melody.h"
+#include "tone.h"
+#include "check.h"
+
+static int toneOn;
+static uint8_t toneCkps, tonePr;
+static long starts, stops;
+
+void tone_start(uint8_t ckps, uint8_t pr)
+{
+    toneOn = 1;
+    toneCkps = ckps;
+    tonePr = pr;
+    starts++;
+}
+
+void tone_stop(void)
+{
+    toneOn = 0;
+    stops++;
+}
+
+static double noteHz(int note)
+{
+    return 440.0 * pow(2.0, (note - NOTE_A4) / 12.0);
+}
+
+static double periodHz(uint8_t ckps, uint8_t pr)
+{
+    return (double)MELODY_FCY / ((double)(pr + 1) * (1 << ckps));
+}
+
+static void testTable(void)
+{
+    double worst = 0;
+    int worstNote = 0;
+
+    for (int n = 0; n < NOTE_COUNT; n++) {
+        const melody_period_t *p = &melody_periods[n];
+        double want = noteHz(n);
+        double err = fabs(periodHz(p->ckps, p->pr) / want - 1.0);
+
+        CHECK(p->ckps <= 7);                    // T2CON.CKPS is 3 bits
+        CHECK(err < 0.0035);
+        if (err > worst) {
+            worst = err;
+            worstNote = n;
+        }
+
+        // Smallest prescale that fits 8 bits
+        double counts = MELODY_FCY / want;
+        CHECK(counts / (1 << p->ckps) <= 256.5);
+        if (p->ckps)
+            CHECK(counts / (1 << (p->ckps - 1)) > 255.5);
+
+        // No other period at this prescale is closer
+        for (int d = -1; d <= 1; d += 2) {
+            int pr = p->pr + d;
+            if (pr >= 0 && pr <= 255)
+                CHECK(fabs(periodHz(p->ckps, (uint8_t)pr) - want) >=
+                      fabs(periodHz(p->ckps, p->pr) - want) - 1e-9);
+        }
+    }
+    printf("  worst note %d: %.3f%% off pitch\n", worstNote, worst * 100);
+}
+
+static void tick(int ms)
+{
+    while (ms--)
+        melody_tick();
+}
+
+static void testSequencer(void)
+{
+    static const melody_step_t tune[] = {
+        { NOTE_A5, 125 }, { NOTE_REST, 40 }, { NOTE_C4, 1 }, { NOTE_B7, 300 },
+        MELODY_END
+    };
+    static const melody_step_t empty[] = { MELODY_END };
+
+    // Each step starts after exactly the previous one's ms
+    melody_play(tune, 0);
+    CHECK(toneOn && toneCkps == melody_periods[NOTE_A5].ckps &&
+          tonePr == melody_periods[NOTE_A5].pr);
+    tick(124);
+    CHECK(toneOn && tonePr == melody_periods[NOTE_A5].pr);
+    tick(1);
+    CHECK(!toneOn);                             // the rest
+    tick(39);
+    CHECK(!toneOn);
+    tick(1);
+    CHECK(toneOn && tonePr == melody_periods[NOTE_C4].pr);
+    tick(1);
+    CHECK(toneOn && tonePr == melody_periods[NOTE_B7].pr);
+    tick(299);
+    CHECK(toneOn && melody_busy());
+    tick(1);
+    CHECK(!toneOn && !melody_busy());
+    long s = starts;
+    tick(1000);                                 // idle ticks do nothing
+    CHECK(starts == s && !toneOn);
+
+    // Looping: the first step again after the last, for many rounds
+    melody_play(tune, 1);
+    for (int round = 0; round < 50; round++) {
+        CHECK(toneOn && tonePr == melody_periods[NOTE_A5].pr);
+        tick(125 + 40 + 1 + 300);
+    }
+    CHECK(melody_busy());
+    melody_stop();
+    CHECK(!toneOn && !melody_busy());
+
+    // Nothing to play, looping or not
+    melody_play(empty, 0);
+    CHECK(!toneOn && !melody_busy());
+    melody_play(empty, 1);
+    CHECK(!toneOn && !melody_busy());
+}
+
+int main(void)
+{
+    testTable();
+    testSequencer();
+    return check_done("test_melody");
+}
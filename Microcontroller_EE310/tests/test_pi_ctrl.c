@@ -0,0 +1,216 @@
+// PI controller (Assignment_ADC_LCD/pi_ctrl.c) closing the loop around a
+// simulated plant: the RB3 PWM through the 10 k / 1 uF filter into RA0,
+// with and without a resistive load on RA0.
+//
+// The plant runs exactly, period by period: the filter charges towards
+// the loaded high level for the duty time and discharges for the rest.
+// As in Assignment_ADC_LCD/main.c, RA0 is sampled (a 4-sample average
+// with a little noise) at the start of each 977 Hz period, the PI runs
+// at the end of that burst, and the duty it returns takes effect the
+// period after. The gains and start-up are the ones in main.c.
+//
+// Checked: start-up and steps settle to 2% within the periods main.c
+// states with the overshoot it states, the steady state sits within an ADC count or two of the
+// setpoint under every load, the duty stays within 0..out_max, and after
+// an unreachable setpoint (the load caps RA0 below it) the loop comes
+// back without the windup overshoot. The output is also checked against
+// the Q8 formula for every error from every limit state.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pi_ctrl.h"
+#include "check.h"
+
+#define PI_KP 192               // as in main.c
+#define PI_KI 32
+#define STEPS 1024              // 10-bit duty at 977 Hz: TMR2 1:4, PR 255
+#define PERIOD_S (1024e-6)
+#define R_FILTER 10e3
+#define C_FILTER 1e-6
+
+typedef struct {
+    double rLoad;               // 0 = no load
+    double v;                   // RA0, fraction of VDD
+    uint32_t seed;
+} plant_t;
+
+// One PWM period at duty d (of STEPS)
+static void plantPeriod(plant_t *p, uint16_t d)
+{
+    double high = 1.0, r = R_FILTER;
+    if (p->rLoad > 0) {
+        high = p->rLoad / (R_FILTER + p->rLoad);
+        r = R_FILTER * p->rLoad / (R_FILTER + p->rLoad);
+    }
+    double tau = r * C_FILTER;
+    double tHigh = PERIOD_S * d / STEPS;
+
+    // High: towards the divider level through R || RL; low: towards 0
+    p->v = high + (p->v - high) * exp(-tHigh / tau);
+    p->v *= exp(-(PERIOD_S - tHigh) / tau);
+}
+
+// 4-sample burst at the start of the period, +-2 counts of noise each
+static uint16_t plantSample(plant_t *p)
+{
+    long sum = 0;
+    for (int i = 0; i < 4; i++) {
+        p->seed = p->seed * 1103515245u + 12345u;
+        long code = lround(p->v * 4095) + (long)((p->seed >> 8) % 5) - 2;
+        if (code < 0) code = 0;
+        if (code > 4095) code = 4095;
+        sum += code;
+    }
+    return (uint16_t)((sum + 2) >> 2);
+}
+
+typedef struct {
+    int settle;                 // periods until within 2% for good (-1 = never)
+    int overshoot;              // counts past the setpoint
+    double meanErr;             // over the last 200 periods
+    int dutyOk;
+} run_t;
+
+// Runs the loop for n periods towards setpoint (ADC counts), with the
+// duty register starting at duty; returns the final duty
+static uint16_t runLoop(plant_t *p, pi_ctrl_t *pi, uint16_t setpoint, uint16_t duty,
+                        int n, run_t *r)
+{
+    int rising = lround(p->v * 4095) < setpoint;
+    double sumErr = 0;
+
+    r->settle = -1;
+    r->overshoot = 0;
+    r->dutyOk = 1;
+    for (int k = 0; k < n; k++) {
+        uint16_t adc = plantSample(p);
+        int16_t err = (int16_t)setpoint - (int16_t)adc;
+        uint16_t next = pi_update(pi, err);
+
+        if (next > pi->out_max)
+            r->dutyOk = 0;
+        plantPeriod(p, duty);   // this period runs the duty already latched
+        duty = next;
+
+        int past = rising ? adc - setpoint : setpoint - adc;
+        if (past > r->overshoot)
+            r->overshoot = past;
+        if (abs(err) > 4095 / 50)
+            r->settle = -1;
+        else if (r->settle < 0)
+            r->settle = k;
+        if (k >= n - 200)
+            sumErr += err;
+    }
+    r->meanErr = sumErr / 200;
+    return duty;
+}
+
+static uint16_t percentCounts(int pct)
+{
+    return (uint16_t)(((uint32_t)pct * 4095 + 50) / 100);
+}
+
+// From power-up as main.c does it: RA0 at 0 V, duty and integral at the
+// open-loop value for the setpoint. The proportional kick from the whole
+// setpoint as error overshoots a little on the way up.
+static void testStartup(void)
+{
+    static const double loads[] = { 0, 100e3, 47e3, 22e3 };
+    static const int pcts[] = { 10, 25, 50, 60 };
+    int worstSettle = 0, worstOver = 0;
+
+    for (unsigned l = 0; l < sizeof loads / sizeof loads[0]; l++)
+        for (unsigned s = 0; s < sizeof pcts / sizeof pcts[0]; s++) {
+            plant_t p = { loads[l], 0, 7 };
+            pi_ctrl_t pi;
+            run_t r;
+            uint16_t duty = (uint16_t)(((uint32_t)pcts[s] * STEPS + 50) / 100);
+
+            pi_init(&pi, PI_KP, PI_KI, STEPS - 1);
+            pi.integ = (int32_t)duty << 8;
+            runLoop(&p, &pi, percentCounts(pcts[s]), duty, 2000, &r);
+
+            if (r.settle > worstSettle) worstSettle = r.settle;
+            if (r.overshoot > worstOver) worstOver = r.overshoot;
+            CHECK(r.dutyOk);
+            CHECK(r.settle >= 0 && r.settle <= 20);
+            CHECK(r.overshoot <= 4095 * 4 / 100);
+            CHECK(fabs(r.meanErr) <= 2.0);
+        }
+    printf("  from power-up: 2%% in %d periods at worst, overshoot %d counts\n",
+           worstSettle, worstOver);
+}
+
+// Setpoint steps, including one a 22 k load puts out of reach (RA0 tops
+// out at 69% of VDD through the 10 k)
+static void testSteps(double rLoad)
+{
+    static const int pcts[] = { 10, 50, 90, 30, 60, 10 };
+    double top = rLoad > 0 ? rLoad / (R_FILTER + rLoad) : 1.0;
+    plant_t p = { rLoad, 0, 11 };
+    pi_ctrl_t pi;
+    run_t r;
+    uint16_t duty = 0;
+    int worstSettle = 0, worstOver = 0;
+
+    pi_init(&pi, PI_KP, PI_KI, STEPS - 1);
+    for (unsigned i = 0; i < sizeof pcts / sizeof pcts[0]; i++) {
+        duty = runLoop(&p, &pi, percentCounts(pcts[i]), duty, 2000, &r);
+        CHECK(r.dutyOk);
+        if (pcts[i] / 100.0 > top) {
+            // Out of reach: flat out, the integral held where it was
+            // when the output hit the limit
+            CHECK(duty == STEPS - 1);
+            CHECK(pi.integ <= (int32_t)(STEPS - 1) << 8);
+            continue;
+        }
+        // Includes the step back down from a saturated 90%: anti-windup
+        // means no wait for a wound-up integral to unwind
+        if (r.settle > worstSettle) worstSettle = r.settle;
+        if (r.overshoot > worstOver) worstOver = r.overshoot;
+        CHECK(r.settle >= 0 && r.settle <= 30);
+        CHECK(r.overshoot <= 4095 * 4 / 100);
+        CHECK(fabs(r.meanErr) <= 2.0);
+    }
+    printf("  steps, load %s: 2%% in %d periods at worst, overshoot %d counts\n",
+           rLoad > 0 ? "22 k" : "none", worstSettle, worstOver);
+}
+
+// pi_update() against the Q8 formula from every kind of starting integral
+static void testFormula(void)
+{
+    static const int32_t integs[] = { 0, 1, 128, 255 << 8, 511 << 8, 1023 << 8, (1023 << 8) - 1 };
+
+    for (unsigned i = 0; i < sizeof integs / sizeof integs[0]; i++)
+        for (int e = -4095; e <= 4095; e++) {
+            pi_ctrl_t pi;
+            pi_init(&pi, PI_KP, PI_KI, STEPS - 1);
+            pi.integ = integs[i];
+
+            int32_t integ = integs[i] + (int32_t)PI_KI * e;
+            int32_t out = (int32_t)PI_KP * e + integ;
+            int32_t limit = (int32_t)(STEPS - 1) << 8;
+            int32_t clamped = out > limit ? limit : out < 0 ? 0 : out;
+            uint16_t want = (uint16_t)((clamped + 128) >> 8);
+
+            CHECK(pi_update(&pi, (int16_t)e) == want);
+            CHECK(pi.integ >= 0 && pi.integ <= limit);
+            // The integral never grows further into a limit it is on
+            if (out > limit && e > 0)
+                CHECK(pi.integ <= integs[i]);
+            if (out < 0 && e < 0)
+                CHECK(pi.integ >= integs[i] || pi.integ == 0);
+        }
+}
+
+int main(void)
+{
+    testFormula();
+    testStartup();
+    testSteps(0);
+    testSteps(22e3);
+    return check_done("test_pi_ctrl");
+}
@@ -0,0 +1,120 @@
+// Period solver (Assignment_ADC_LCD/pwm_period.c), checked exhaustively.
+//
+// For the 1 MHz and 4 MHz timer clocks, every whole frequency from 1 Hz
+// to past the fastest PWM is solved at every duty resolution and compared
+// with a brute-force search over all 2048 prescale/period pairs: the
+// closest period wins, the smaller prescale on a tie, and the frequency is
+// refused exactly when that pair has too few duty steps or none reaches
+// it. Every pair is also solved back from its own frequency.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "pwm_period.h"
+#include "check.h"
+
+// Closest pair by period in timer clocks; only the two periods around the
+// ideal at each prescale can be closest. Reachable from half a count (it
+// rounds to one) up to 256.5 counts at 1:128.
+static int bruteForce(uint32_t fcy, uint32_t hz, pwm_period_t *best, double *bestErr)
+{
+    double ideal = (double)fcy / hz;
+    int found = 0;
+
+    if (ideal < 0.5 || ideal >= 256.5 * 128)
+        return 0;
+    for (int ckps = 0; ckps < 8; ckps++) {
+        double c = ideal / (1 << ckps);
+        for (int k = 0; k < 2; k++) {
+            long counts = (long)floor(c) + k;
+            if (counts < 1 || counts > 256)
+                continue;
+            double err = fabs((double)(counts << ckps) - ideal);
+            if (!found || err < *bestErr - 1e-9) {
+                found = 1;
+                *bestErr = err;
+                best->ckps = (uint8_t)ckps;
+                best->pr = (uint8_t)(counts - 1);
+            }
+        }
+    }
+    return found;
+}
+
+static void testEveryFrequency(uint32_t fcy)
+{
+    double worst = 0;
+    uint32_t worstHz = 0;
+    long solved = 0;
+
+    for (uint32_t hz = 1; hz <= 2 * fcy + 2; hz++) {
+        pwm_period_t want, got;
+        double err = 0;
+        int reach = bruteForce(fcy, hz, &want, &err);
+
+        for (uint8_t bits = 0; bits <= 10; bits++) {
+            uint8_t ok = pwm_period_solve(fcy, hz, bits, &got);
+            int expect = reach && pwm_period_steps(&want) >= (1u << bits);
+
+            CHECK(ok == expect);
+            if (ok && expect) {
+                // Same period; the same pair unless a tie went the other way
+                double gotErr = fabs((double)pwm_period_counts(&got) - (double)fcy / hz);
+                CHECK(fabs(gotErr - err) < 1e-9);
+                CHECK(got.ckps == want.ckps);
+                CHECK(pwm_period_steps(&got) >= (1u << bits));
+            }
+        }
+        if (reach) {
+            solved++;
+            double rel = err / ((double)fcy / hz);
+            if (pwm_period_steps(&want) == 1024 && rel > worst) {
+                worst = rel;
+                worstHz = hz;
+            }
+        }
+    }
+    printf("  fcy %lu: %ld frequencies reachable, worst at 10 bits %.3f%% (%lu Hz)\n",
+           (unsigned long)fcy, solved, worst * 100, (unsigned long)worstHz);
+}
+
+// Each pair's own frequency, where it is a whole number, solves to a pair
+// with the same period and no larger prescale
+static void testEveryPair(uint32_t fcy)
+{
+    for (uint8_t ckps = 0; ckps < 8; ckps++)
+        for (int pr = 0; pr < 256; pr++) {
+            uint32_t counts = (uint32_t)(pr + 1) << ckps;
+            pwm_period_t got;
+
+            if (fcy % counts)
+                continue;
+            CHECK(pwm_period_solve(fcy, fcy / counts, 0, &got));
+            CHECK(pwm_period_counts(&got) == counts);
+            CHECK(got.ckps <= ckps);
+        }
+}
+
+static void testEdges(void)
+{
+    pwm_period_t p;
+
+    CHECK(!pwm_period_solve(1000000, 0, 0, &p));
+    CHECK(!pwm_period_solve(1000000, 1000, 11, &p));
+    CHECK(!pwm_period_solve(1000000, 0xFFFFFFFFu, 0, &p));
+    CHECK(pwm_period_solve(1000000, 1000000, 2, &p) && p.ckps == 0 && p.pr == 0);
+    CHECK(!pwm_period_solve(1000000, 1000000, 3, &p));
+    CHECK(pwm_period_solve(1000000, 3906, 10, &p) && p.ckps == 0 && p.pr == 255);
+    CHECK(pwm_period_solve(1000000, 977, 10, &p) && p.ckps == 2 && p.pr == 255);
+    CHECK(pwm_period_counts(&p) == 1024 && pwm_period_steps(&p) == 1024);
+}
+
+int main(void)
+{
+    testEdges();
+    testEveryPair(1000000);
+    testEveryPair(4000000);
+    testEveryFrequency(1000000);
+    testEveryFrequency(4000000);
+    return check_done("test_pwm_period");
+}
@@ -0,0 +1,189 @@
+// Scheduler (sched.c) on a simulated tick.
+//
+// Time runs in microseconds. sched_tick() is called on every millisecond
+// boundary, also while a task runs, as the TMR0 interrupt would; a task
+// "runs" by advancing the time by its cost. The clock handed to
+// sched_init() reads the same time, like systick_us() on the board.
+//
+// Checked: periodic tasks are released on their cadence and run in
+// priority order; event-driven tasks run only when made ready; the run
+// time measured is the cost given; a task that cannot keep up counts its
+// missed releases and late finishes; none of it changes across the
+// 16-bit millisecond wrap; and the overrun count stops at 65535.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "sched.h"
+#include "check.h"
+
+static unsigned long nowUs;
+
+static void advance(unsigned long us)
+{
+    unsigned long end = nowUs + us;
+
+    while (nowUs / 1000 < end / 1000) {
+        nowUs = (nowUs / 1000 + 1) * 1000;
+        sched_tick();
+    }
+    nowUs = end;
+}
+
+static uint16_t clockUs(void)
+{
+    return (uint16_t)nowUs;
+}
+
+// Per task: cost in us and the number of runs
+#define MAX_TASKS 4
+
+static sched_task_t tasks[MAX_TASKS];
+static unsigned long cost[MAX_TASKS];
+static long runs[MAX_TASKS];
+static int ranOutOfOrder;
+
+static void runTask(int i)
+{
+    // Nothing of higher priority may be left ready behind this one
+    for (int j = 0; j < i; j++)
+        if (tasks[j].ready)
+            ranOutOfOrder = 1;
+    runs[i]++;
+    advance(cost[i]);
+}
+
+static void task0(void) { runTask(0); }
+static void task1(void) { runTask(1); }
+static void task2(void) { runTask(2); }
+static void task3(void) { runTask(3); }
+
+static void (*const fns[MAX_TASKS])(void) = { task0, task1, task2, task3 };
+
+static void setup(int count, const uint16_t *periods, const uint16_t *deadlines,
+                  const unsigned long *costs)
+{
+    nowUs = 0;
+    memset(tasks, 0, sizeof tasks);
+    memset(runs, 0, sizeof runs);
+    ranOutOfOrder = 0;
+    for (int i = 0; i < count; i++) {
+        sched_task_t t = SCHED_TASK(fns[i], periods[i], deadlines[i]);
+        tasks[i] = t;
+        cost[i] = costs[i];
+    }
+    sched_init(tasks, (uint8_t)count, clockUs);
+}
+
+// Main loop until ms have gone by: run, or idle to the next tick
+static void loop(unsigned long ms)
+{
+    unsigned long end = nowUs + ms * 1000;
+
+    while (nowUs < end)
+        if (!sched_run())
+            advance(1000 - nowUs % 1000);
+}
+
+// Light load: every release runs, on time, in order, with no overruns
+static void testCadence(void)
+{
+    static const uint16_t periods[] = { 5, 10, 20, 0 };
+    static const uint16_t deadlines[] = { 0, 0, 0, 0 };
+    static const unsigned long costs[] = { 300, 700, 1500, 200 };
+    const unsigned long ms = 100000;    // past the 65.5 s wrap
+
+    setup(4, periods, deadlines, costs);
+    for (unsigned long m = 0; m < ms; m += 1000) {
+        sched_ready(&tasks[3]);
+        loop(1000);
+    }
+    CHECK(!ranOutOfOrder);
+    for (int i = 0; i < 3; i++) {
+        CHECK(runs[i] == (long)(ms / periods[i]));
+        CHECK(tasks[i].overruns == 0);
+        CHECK(tasks[i].wcet == costs[i]);
+    }
+    CHECK(runs[3] == (long)(ms / 1000));        // once per sched_ready()
+    CHECK(tasks[3].overruns == 0);
+    CHECK(sched_now() == (uint16_t)(ms - 1));   // as of the last run
+}
+
+// Event-driven: never released by time, and a second sched_ready() before
+// it runs is the same release
+static void testEvent(void)
+{
+    static const uint16_t periods[] = { 0 };
+    static const uint16_t deadlines[] = { 0 };
+    static const unsigned long costs[] = { 100 };
+
+    setup(1, periods, deadlines, costs);
+    loop(1000);
+    CHECK(runs[0] == 0);
+    sched_ready(&tasks[0]);
+    sched_ready(&tasks[0]);
+    loop(10);
+    CHECK(runs[0] == 1);
+    CHECK(tasks[0].overruns == 0);
+}
+
+// Overload: a 10 ms task that takes 25 ms misses two releases per run and
+// finishes late each time. Run-to-completion means the 1 ms task above it
+// only gets in between those runs (twice if its own run crosses a tick)
+// and misses the rest of its releases.
+static void testOverload(void)
+{
+    static const uint16_t periods[] = { 1, 10 };
+    static const uint16_t deadlines[] = { 0, 0 };
+    static const unsigned long costs[] = { 100, 25000 };
+
+    setup(2, periods, deadlines, costs);
+    loop(3000);
+    long n = runs[1];
+    CHECK(n >= 3000 / 26 - 1 && n <= 3000 / 25 + 1);
+    // Each run: one late finish and the releases skipped while it ran
+    CHECK(tasks[1].overruns >= 2 * (n - 1) && tasks[1].overruns <= 3 * n + 1);
+    CHECK(tasks[1].wcet == 25000);
+    CHECK(runs[0] >= n && runs[0] <= 2 * n + 1);
+    CHECK(tasks[0].overruns >= 24 * (n - 1));
+    CHECK(!ranOutOfOrder);
+}
+
+// A deadline shorter than the period: late by a tick when it waits behind
+// a 3 ms task released at the same time
+static void testDeadline(void)
+{
+    static const uint16_t periods[] = { 20, 20 };
+    static const uint16_t deadlines[] = { 0, 2 };
+    static const unsigned long costs[] = { 3000, 100 };
+
+    setup(2, periods, deadlines, costs);
+    loop(2000);
+    CHECK(runs[0] == 100 && runs[1] == 100);
+    CHECK(tasks[0].overruns == 0);
+    CHECK(tasks[1].overruns == 100);
+}
+
+// A task that always misses: the count stops at 65535
+static void testSaturate(void)
+{
+    static const uint16_t periods[] = { 1 };
+    static const uint16_t deadlines[] = { 0 };
+    static const unsigned long costs[] = { 5000 };
+
+    setup(1, periods, deadlines, costs);
+    loop(100000);
+    CHECK(tasks[0].overruns == 0xFFFF);
+    loop(10000);
+    CHECK(tasks[0].overruns == 0xFFFF);
+}
+
+int main(void)
+{
+    testCadence();
+    testEvent();
+    testOverload();
+    testDeadline();
+    testSaturate();
+    return check_done("test_sched");
+}
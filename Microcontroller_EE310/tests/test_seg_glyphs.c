@@ -0,0 +1,185 @@
+// Checks the generated glyph table (seg_glyphs.c, seg_glyphs.inc) against
+// the patterns the programs hard-coded before the table: the SEGMENT_*
+// defines of the calculator and 7 _Segment_keypad_Cprogram.c and the
+// digitTable DB lines of the four asm programs, which all agreed.
+//
+// Also estimates the cycles saved per display update on the PIC18. This
+// is not a measurement: the old lookups were switches on sparse values,
+// which XC8 compiles to a compare chain, and the new ones are a table
+// read (TBLRD) after a few range tests. The per-instruction figures
+// below are a hand count of those code shapes, applied to the exact path
+// each input takes through the old switch and the new code.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "seg_glyphs.h"
+#include "check.h"
+
+#define INC_PATH "../Assignments/seg_glyphs.inc"
+
+static const uint8_t legacy[] = {
+    0b11011110, 0b00000110, 0b11101100, 0b01101110,     // 0-3
+    0b00110110, 0b01111010, 0b11111010, 0b00001110,     // 4-7
+    0b11111110, 0b00111110, 0b10111110, 0b11110010,     // 8-B
+    0b11011000, 0b11100110, 0b11111000, 0b10111000,     // C-F
+    0b01101000, 0b10010110,                             // *, #
+};
+
+// Board wiring, MSB to LSB: E D G F A B C DP
+enum { SEG_E = 0x80, SEG_D = 0x40, SEG_G = 0x20, SEG_F = 0x10,
+       SEG_A = 0x08, SEG_B = 0x04, SEG_C = 0x02 };
+
+// Estimated instruction cycles (1 us each at FOSC 4 MHz)
+#define CY_CALL         4       // CALL and RETURN
+#define CY_CASE_MISS    3       // XORLW, BTFSC skipping the GOTO
+#define CY_CASE_HIT     4       // XORLW, BTFSC, GOTO
+#define CY_RETURN_K     3       // MOVLW pattern, GOTO the common exit
+#define CY_COMPARE      3       // one relational test and its branch
+#define CY_TABLE        10      // TBLPTR from the index, TBLRD*, MOVF TABLAT
+
+// Case order of the old switches: getSegment() in the calculator and the
+// key switch in 7 _Segment_keypad_Cprogram.c
+static const char calcCases[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 'E' };
+static const char keypadCases[] = "0123456789ABCD*#";
+
+static unsigned oldCycles(const char *cases, int n, char key)
+{
+    unsigned cy = CY_CALL + CY_RETURN_K;
+
+    for (int i = 0; i < n; i++) {
+        if (cases[i] == key)
+            return cy + CY_CASE_HIT;
+        cy += CY_CASE_MISS;
+    }
+    return cy;                  // default: SEGMENT_OFF
+}
+
+// seg_glyph_char(), following its chain of tests to the one that matches
+static unsigned charCycles(char c)
+{
+    unsigned cy = CY_CALL + CY_TABLE;
+
+    if (cy += CY_COMPARE, c >= '0' && (cy += CY_COMPARE, c <= '9')) return cy;
+    if (cy += CY_COMPARE, c >= 'A' && (cy += CY_COMPARE, c <= 'F')) return cy;
+    if (cy += CY_COMPARE, c >= 'a' && (cy += CY_COMPARE, c <= 'f')) return cy;
+    if (cy += CY_COMPARE, c == '*') return cy;
+    if (cy += CY_COMPARE, c == '#') return cy;
+    cy += CY_COMPARE;
+    return cy;
+}
+
+// The calculator's digits now come from display_mux.c, which indexes the
+// table with the digit value
+static unsigned calcNewCycles(char key)
+{
+    (void)key;
+    return CY_TABLE;
+}
+
+static void timeLookups(void)
+{
+    unsigned oldSum = 0, newSum = 0, oldWorst = 0, newWorst = 0;
+
+    // Keypad program: one lookup per key press, every key alike
+    for (int i = 0; i < 16; i++) {
+        unsigned o = oldCycles(keypadCases, 16, keypadCases[i]);
+        unsigned n = charCycles(keypadCases[i]);
+        oldSum += o;
+        newSum += n;
+        if (o > oldWorst) oldWorst = o;
+        if (n > newWorst) newWorst = n;
+    }
+    printf("keypad program, per key: %.1f -> %.1f cycles on average, worst %u -> %u\n",
+           oldSum / 16.0, newSum / 16.0, oldWorst, newWorst);
+    CHECK(newSum < oldSum && newWorst < oldWorst);
+
+    // Calculator: two digits per update, every result 0..99 alike
+    oldSum = newSum = oldWorst = newWorst = 0;
+    for (int v = 0; v < 100; v++) {
+        unsigned o = oldCycles(calcCases, 11, (char)(v / 10)) +
+                     oldCycles(calcCases, 11, (char)(v % 10));
+        unsigned n = calcNewCycles((char)(v / 10)) + calcNewCycles((char)(v % 10));
+        oldSum += o;
+        newSum += n;
+        if (o > oldWorst) oldWorst = o;
+        if (n > newWorst) newWorst = n;
+    }
+    printf("calculator, per 2-digit update: %.1f -> %.1f cycles on average, "
+           "worst %u -> %u\n", oldSum / 100.0, newSum / 100.0, oldWorst, newWorst);
+    CHECK(newSum < oldSum && newWorst < oldWorst);
+}
+
+static void testTable(void)
+{
+    for (int i = 0; i < (int)sizeof legacy; i++)
+        CHECK(seg_glyphs[i] == legacy[i]);
+    CHECK(seg_glyphs[SEG_GLYPH_MINUS] == SEG_G);
+    CHECK(seg_glyphs[SEG_GLYPH_BLANK] == 0);
+    CHECK(seg_glyphs[8] == (SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G));
+    CHECK(seg_glyphs[1] == (SEG_B | SEG_C));
+    for (int i = 0; i < SEG_GLYPH_COUNT; i++)
+        CHECK(!(seg_glyphs[i] & SEG_DP));           // DP is the caller's
+}
+
+static void testChars(void)
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    for (int c = -128; c < 128; c++) {
+        const char *at = c > 0 ? strchr(digits, c) : NULL;
+        uint8_t want;
+
+        if (at) want = seg_glyphs[at - digits];
+        else if (c >= 'a' && c <= 'f') want = seg_glyphs[c - 'a' + 10];
+        else if (c == '*') want = seg_glyphs[SEG_GLYPH_STAR];
+        else if (c == '#') want = seg_glyphs[SEG_GLYPH_HASH];
+        else if (c == '-') want = seg_glyphs[SEG_GLYPH_MINUS];
+        else want = 0;
+        CHECK(seg_glyph_char((char)c) == want);
+    }
+}
+
+// The asm include must carry the same bytes, in the same order
+static void testInclude(void)
+{
+    FILE *f = fopen(INC_PATH, "r");
+    char line[128];
+    int n = 0, equs = 0;
+
+    CHECK(f != NULL);
+    if (!f)
+        return;
+    while (fgets(line, sizeof line, f)) {
+        char bitsText[9];
+        char name[16];
+        int value;
+
+        if (sscanf(line, " DB 0b%8[01]", bitsText) == 1) {
+            uint8_t v = 0;
+            for (int i = 0; i < 8; i++)
+                v = (uint8_t)(v << 1 | (bitsText[i] == '1'));
+            CHECK(n < SEG_GLYPH_COUNT && v == seg_glyphs[n]);
+            n++;
+        } else if (sscanf(line, "SEG_GLYPH_%15s EQU %d", name, &value) == 2) {
+            equs++;
+            if (!strcmp(name, "STAR")) CHECK(value == SEG_GLYPH_STAR);
+            if (!strcmp(name, "HASH")) CHECK(value == SEG_GLYPH_HASH);
+            if (!strcmp(name, "MINUS")) CHECK(value == SEG_GLYPH_MINUS);
+            if (!strcmp(name, "BLANK")) CHECK(value == SEG_GLYPH_BLANK);
+        }
+    }
+    fclose(f);
+    printf("%s: %d DB lines, %d EQUs\n", INC_PATH, n, equs);
+    CHECK(n == SEG_GLYPH_COUNT);
+    CHECK(equs == SEG_GLYPH_COUNT - 16);
+}
+
+int main(void)
+{
+    testTable();
+    testChars();
+    testInclude();
+    timeLookups();
+    return check_done("test_seg_glyphs");
+}
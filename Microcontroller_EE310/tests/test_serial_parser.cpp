@@ -0,0 +1,164 @@
+// Unit tests and a throughput benchmark for serial_parser.cpp.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "serial_parser.h"
+#include "check.h"
+
+static SerialEvent feedLine(LineParser *p, const char *s) {
+  SerialEvent ev = EV_NONE;
+
+  for (; *s; s++) {
+    SerialEvent r = parserFeed(p, *s);
+    if (*s != '\n') CHECK(r == EV_NONE);
+    else ev = r;
+  }
+  return ev;
+}
+
+static void testMessages(void) {
+  static const struct { const char *line; SerialEvent ev; } cases[] = {
+    { "LEFT\r\n", EV_JOY_LEFT },
+    { "RIGHT\r\n", EV_JOY_RIGHT },
+    { "UP\r\n", EV_JOY_UP },
+    { "DOWN\r\n", EV_JOY_DOWN },
+    { "CENTER\r\n", EV_JOY_CENTER },
+    { "LEFT (button)\r\n", EV_BTN_LEFT },
+    { "RIGHT (button)\r\n", EV_BTN_RIGHT },
+    { "UP (button)\r\n", EV_BTN_UP },
+    { "DOWN (button)\r\n", EV_BTN_DOWN },
+    { "CENTER (button)\r\n", EV_BTN_CENTER },
+    { "LEFT\n", EV_JOY_LEFT },                  // no '\r'
+    { "  UP  \r\n", EV_JOY_UP },                // padding
+    { "\r\r DOWN (button)\r\n", EV_BTN_DOWN },
+    { "left\r\n", EV_UNKNOWN },                 // case matters
+    { "LEF\r\n", EV_UNKNOWN },
+    { "LEFTT\r\n", EV_UNKNOWN },
+    { "(button)\r\n", EV_UNKNOWN },
+    { " (button)\r\n", EV_UNKNOWN },
+    { "SIDE (button)\r\n", EV_UNKNOWN },
+    { "UP(button)\r\n", EV_UNKNOWN },
+    { "\r\n", EV_NONE },                        // blank lines are ignored
+    { "   \n", EV_NONE },
+  };
+  LineParser p;
+
+  parserInit(&p);
+  for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+    SerialEvent ev = feedLine(&p, cases[i].line);
+    if (ev != cases[i].ev)
+      printf("  \"%s\" gave %d\n", cases[i].line, (int)ev);
+    CHECK(ev == cases[i].ev);
+  }
+}
+
+// A line longer than the buffer is reported once as unknown and the next
+// line parses normally.
+static void testOverflow(void) {
+  LineParser p;
+  char longLine[LINE_BUF_SIZE * 3];
+
+  parserInit(&p);
+  memset(longLine, 'X', sizeof longLine - 2);
+  longLine[sizeof longLine - 2] = '\n';
+  longLine[sizeof longLine - 1] = '\0';
+  CHECK(feedLine(&p, longLine) == EV_UNKNOWN);
+  CHECK(feedLine(&p, "RIGHT\r\n") == EV_JOY_RIGHT);
+
+  // Exactly a full buffer, valid text padded with spaces
+  char full[LINE_BUF_SIZE + 2];
+  memset(full, ' ', LINE_BUF_SIZE);
+  memcpy(full, "CENTER", 6);
+  full[LINE_BUF_SIZE] = '\n';
+  full[LINE_BUF_SIZE + 1] = '\0';
+  CHECK(feedLine(&p, full) == EV_JOY_CENTER);
+}
+
+// A line split across loop() passes gives the same result.
+static void testPartial(void) {
+  LineParser p;
+
+  parserInit(&p);
+  CHECK(parserFeed(&p, 'U') == EV_NONE);
+  CHECK(parserFeed(&p, 'P') == EV_NONE);
+  CHECK(parserFeed(&p, '\r') == EV_NONE);
+  CHECK(parserFeed(&p, '\n') == EV_JOY_UP);
+}
+
+static void testLabels(void) {
+  CHECK(strcmp(eventLabel(EV_NONE), "WAIT") == 0);
+  CHECK(strcmp(eventLabel(EV_BTN_CENTER), "CENTER (button)") == 0);
+  CHECK(strcmp(eventLabel((SerialEvent)200), "?") == 0);
+  for (int e = EV_JOY_LEFT; e <= EV_BTN_CENTER; e++) {
+    // The label is the message itself, so it parses back to the event
+    LineParser p;
+    char line[32];
+    parserInit(&p);
+    snprintf(line, sizeof line, "%s\r\n", eventLabel((SerialEvent)e));
+    CHECK(feedLine(&p, line) == e);
+    CHECK(eventIsButton((SerialEvent)e) == (e >= EV_BTN_LEFT));
+  }
+}
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(void) {
+  seed = seed * 1103515245u + 12345u;
+  return seed >> 8;
+}
+
+// Megabytes of valid lines mixed with random bytes: every valid line that
+// follows a newline must still be found, and nothing may crash or stall.
+static void benchThroughput(void) {
+  static const char *const valid[] = {
+    "LEFT\r\n", "RIGHT\r\n", "UP\r\n", "DOWN\r\n", "CENTER\r\n",
+    "LEFT (button)\r\n", "RIGHT (button)\r\n", "UP (button)\r\n",
+    "DOWN (button)\r\n", "CENTER (button)\r\n",
+  };
+  static char stream[8 << 20];
+  size_t n = 0;
+  long expected = 0, found = 0, unknown = 0;
+
+  while (n < sizeof stream - 64) {
+    if (rnd() % 4) {
+      const char *s = valid[rnd() % 10];
+      size_t len = strlen(s);
+      memcpy(stream + n, s, len);
+      n += len;
+      expected++;
+    } else {
+      size_t len = 1 + rnd() % 40;          // garbage, then a newline
+      for (size_t i = 0; i < len; i++) {
+        char c = (char)(rnd() & 0xFF);
+        stream[n++] = c == '\n' ? 'x' : c;
+      }
+      stream[n++] = '\n';
+    }
+  }
+
+  LineParser p;
+  parserInit(&p);
+  clock_t start = clock();
+  for (size_t i = 0; i < n; i++) {
+    SerialEvent ev = parserFeed(&p, stream[i]);
+    if (ev == EV_UNKNOWN) unknown++;
+    else if (ev != EV_NONE) found++;
+  }
+  double s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf("throughput: %.1f MB in %.3f s, %.0f MB/s; %ld events, %ld rejected lines\n",
+         n / 1e6, s, s > 0 ? n / 1e6 / s : 0.0, found, unknown);
+  // Random garbage can spell a valid message, but only very rarely
+  CHECK(found >= expected && found < expected + expected / 1000 + 1);
+  CHECK(p.len == 0);
+}
+
+int main(void) {
+  testMessages();
+  testOverflow();
+  testPartial();
+  testLabels();
+  benchThroughput();
+  return check_done("test_serial_parser");
+}
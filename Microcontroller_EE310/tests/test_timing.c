@@ -0,0 +1,193 @@
+// Timer periods against the one clock in clock.h, on a virtual clock.
+//
+// The real systick.c sets up TMR0 and the test plays the hardware: TMR0
+// counts FCY_HZ cycles through the prescale, period and postscale it
+// reads back from T0CON0/T0CON1/TMR0H, sets TMR0IF, and the tick ISR
+// (timing_tick()) runs a random few cycles later, as it would behind a
+// longer instruction or another ISR. The yield hook of timing.c moves
+// virtual time on by a random few cycles per pass of a wait loop.
+//
+// Checked: the TMR0 setup is 1 ms of FOSC/4, delay_ms(ms) waits between
+// ms and ms + 1 ms (give or take the ISR latency), delay_until() keeps a steady period without drift
+// through the millis() wrap, systick_us() is never ahead of virtual time
+// nor more than one 4 us count behind, and the display_mux, lcd, keypad
+// and UART periods worked out from FCY_HZ are the ones their comments
+// state.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <xc.h>
+#include "clock.h"
+#include "systick.h"
+#include "timing.h"
+#include "display_mux.h"
+#include "check.h"
+
+#define MAX_LATENCY 40          // cycles from TMR0IF to the tick ISR
+#define MAX_YIELD   30          // cycles per pass of a wait loop
+
+void DISPLAY_ISR(void);
+
+static uint64_t cycles;         // FCY cycles since systick_init()
+static unsigned prescaleCount, postscaleCount;
+static int flagPending;
+static unsigned latency;
+static uint32_t seed = 1;
+
+static unsigned rnd(unsigned n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % n;
+}
+
+static void tickIsr(void)
+{
+    PIR3bits.TMR0IF = 0;
+    timing_tick();
+}
+
+// One FCY cycle of TMR0 in 8-bit mode: TMR0L counts up to TMR0H and
+// starts over, and every (OUTPS + 1)th match sets TMR0IF
+static void step(void)
+{
+    cycles++;
+    if (++prescaleCount >= (1u << (T0CON1 & 0x0F))) {
+        prescaleCount = 0;
+        if (TMR0L == TMR0H) {
+            TMR0L = 0;
+            if (++postscaleCount > (T0CON0 & 0x0F)) {
+                postscaleCount = 0;
+                PIR3bits.TMR0IF = 1;
+                flagPending = 1;
+                latency = rnd(MAX_LATENCY + 1);
+            }
+        } else {
+            TMR0L++;
+        }
+    }
+    if (flagPending && PIE3bits.TMR0IE && INTCON0bits.GIE && latency-- == 0) {
+        flagPending = 0;
+        tickIsr();
+    }
+}
+
+static void advance(uint64_t n)
+{
+    while (n--)
+        step();
+}
+
+static void yield(void)
+{
+    advance(1 + rnd(MAX_YIELD));
+}
+
+static void testSetup(void)
+{
+    systick_init();
+    INTCON0bits.GIE = 1;
+
+    CHECK((T0CON1 >> 5) == 2);                  // FOSC/4
+    CHECK((T0CON0 & 0x90) == 0x80);             // on, 8-bit
+    unsigned long period = (1ul << (T0CON1 & 0x0F)) * (TMR0H + 1ul) *
+                           ((T0CON0 & 0x0F) + 1ul);
+    CHECK(period * 1000 == FCY_HZ);
+    printf("  tick: %lu FOSC/4 cycles = 1 ms at FOSC %lu Hz\n",
+           period, (unsigned long)FOSC_HZ);
+}
+
+// Virtual time as systick_us() counts it
+static uint16_t nowUs(void)
+{
+    return (uint16_t)(cycles * 1000000 / FCY_HZ);
+}
+
+static void testUs(int n)
+{
+    int worst = 0;
+
+    for (int i = 0; i < n; i++) {
+        advance(1 + rnd(3000));
+        int behind = (uint16_t)(nowUs() - systick_us());
+        if (behind > worst) worst = behind;
+        CHECK(behind < 4);
+    }
+    printf("  systick_us(): at most %d us behind\n", worst);
+}
+
+static void testDelayMs(int n)
+{
+    for (int i = 0; i < n; i++) {
+        uint16_t ms = (uint16_t)rnd(40);
+        advance(rnd(1000));
+        uint64_t start = cycles;
+        delay_ms(ms);
+        uint64_t us = (cycles - start) * 1000000 / FCY_HZ;
+        if (ms) {
+            // The tick ISR can be later for the last tick than the first
+            CHECK(us + MAX_LATENCY >= ms * 1000ull);
+            CHECK(us <= (ms + 1) * 1000ull + MAX_LATENCY + MAX_YIELD);
+        } else {
+            CHECK(cycles == start);
+        }
+    }
+}
+
+// next += period; delay_until(next) returns within a few cycles of each
+// tick it waits for, however long ago it started
+static void testDelayUntil(uint16_t period, int n)
+{
+    uint16_t next = millis();
+    uint64_t tick = cycles / (FCY_HZ / 1000);   // tick number of next
+
+    for (int i = 0; i < n; i++) {
+        next += period;
+        tick += period;
+        delay_until(next);
+        uint64_t due = tick * (FCY_HZ / 1000);
+        CHECK(cycles >= due && cycles <= due + MAX_LATENCY + MAX_YIELD + 1);
+        advance(rnd(period * 500u));            // busy for a while
+    }
+}
+
+// Period in us for counts of FCY through a prescale
+static double periodUs(unsigned long counts, unsigned prescale)
+{
+    return counts * prescale * 1e6 / FCY_HZ;
+}
+
+static void testReloads(void)
+{
+    display_init();
+    CHECK(65536u - ((TMR3H << 8) | TMR3L) == FCY_HZ / 1000);
+    TMR3H = TMR3L = 0;
+    DISPLAY_ISR();
+    CHECK(65536u - ((TMR3H << 8) | TMR3L) == FCY_HZ / 1000);
+
+    CHECK(periodUs(FCY_COUNTS(100, 1), 1) == 100);      // lcd.c T4PR
+    CHECK(periodUs(FCY_COUNTS(500, 4), 4) == 500);      // MCC_UART.c T2PR
+    double keypad = periodUs(FCY_COUNTS(5000, 32), 32); // keypad.c T6PR
+    CHECK(keypad > 4950 && keypad < 5050);
+    CHECK(FCY_COUNTS(5000, 32) <= 256);                 // 8-bit period
+}
+
+int main(void)
+{
+    timing_set_yield(yield);
+    testSetup();
+    testUs(5000);
+    testDelayMs(1000);
+    testDelayUntil(7, 1000);
+    testDelayUntil(250, 40);
+
+    // Up to the millis() wrap and through it
+    CHECK(millis() < 65536 - 2000);
+    advance((uint64_t)(65536 - 2000 - millis()) * (FCY_HZ / 1000));
+    testDelayMs(500);
+    testDelayUntil(3, 1000);
+    testUs(5000);
+    CHECK(millis() < 30000);
+
+    testReloads();
+    return check_done("test_timing");
+}
@@ -0,0 +1,140 @@
+// Unit test and fuzz for uart_txq.c behind a small UART1 shim.
+//
+// The shim stands in for the registers MCC_UART.c uses: writing U1TXB
+// appends to a wire log, and the TX interrupt runs only while U1TXIE is
+// set. uartWrite() and txIsr() are MCC_UART.c's UART1_Write_Bytes() and
+// UART1_TX_ISR() with the registers swapped for the shim.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "uart_txq.h"
+#include "check.h"
+
+// === UART1 shim ===
+static uint8_t wire[1 << 20];
+static uint32_t wireLen;
+static uint8_t U1TXIE;
+
+static void U1TXB_write(uint8_t b)
+{
+    if (wireLen < sizeof wire)
+        wire[wireLen++] = b;
+}
+
+static txq_t txQueue;
+
+static uint8_t uartWrite(const uint8_t *data, uint8_t len)
+{
+    uint8_t ok = txq_push(&txQueue, data, len);
+    if (ok)
+        U1TXIE = 1;
+    return ok;
+}
+
+// One TX interrupt: the shift register has room for a byte.
+static void txIsr(void)
+{
+    uint8_t byte;
+
+    if (!U1TXIE)
+        return;
+    if (txq_pop(&txQueue, &byte))
+        U1TXB_write(byte);
+    else
+        U1TXIE = 0;
+}
+
+static uint32_t seed = 99;
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static void testBasics(void)
+{
+    uint8_t big[TXQ_SIZE + 1];
+
+    txq_init(&txQueue);
+    wireLen = 0;
+    U1TXIE = 0;
+
+    CHECK(txq_used(&txQueue) == 0);
+    CHECK(uartWrite((const uint8_t *)"CENTER\r\n", 8));
+    CHECK(U1TXIE == 1);
+    CHECK(txq_used(&txQueue) == 8);
+    for (int i = 0; i < 20; i++)
+        txIsr();
+    CHECK(wireLen == 8 && memcmp(wire, "CENTER\r\n", 8) == 0);
+    CHECK(U1TXIE == 0);                         // turned itself off
+
+    // Exactly full fits, one more byte is rejected whole
+    memset(big, 'x', sizeof big);
+    CHECK(uartWrite(big, TXQ_SIZE));
+    CHECK(!uartWrite(big, 1));
+    CHECK(txQueue.overflows == 1 && txQueue.droppedBytes == 1);
+    txIsr();
+    CHECK(uartWrite(big, 1));
+    CHECK(!uartWrite(big, TXQ_SIZE + 1));
+    CHECK(txQueue.overflows == 2);
+    CHECK(uartWrite(big, 0));                   // empty message is fine
+}
+
+// Random messages against a random drain rate, checked against a model:
+// the wire must carry exactly the accepted messages, whole and in order,
+// and every rejection must be counted.
+static void fuzz(void)
+{
+    static uint8_t expected[sizeof wire];
+    uint32_t expectedLen = 0;
+    uint32_t rejected = 0, rejectedBytes = 0, accepted = 0;
+
+    txq_init(&txQueue);
+    wireLen = 0;
+    U1TXIE = 0;
+
+    for (int step = 0; step < 400000 && expectedLen < sizeof wire - 256; step++) {
+        if (rnd() % 3 == 0) {
+            uint8_t msg[TXQ_SIZE + 8];
+            uint8_t len = (uint8_t)(rnd() % (TXQ_SIZE + 8));
+            for (uint8_t i = 0; i < len; i++)
+                msg[i] = (uint8_t)rnd();
+
+            uint8_t room = (uint8_t)(TXQ_SIZE - txq_used(&txQueue));
+            uint8_t ok = uartWrite(msg, len);
+            CHECK(ok == (len <= room));
+            if (ok) {
+                memcpy(expected + expectedLen, msg, len);
+                expectedLen += len;
+                accepted++;
+            } else {
+                rejected++;
+                rejectedBytes += len;
+            }
+        } else {
+            for (uint32_t n = rnd() % 4; n; n--)
+                txIsr();
+        }
+        CHECK(txq_used(&txQueue) <= TXQ_SIZE);
+    }
+    while (U1TXIE)
+        txIsr();
+
+    printf("fuzz: %lu messages sent, %lu rejected (%lu bytes), %lu bytes on the wire\n",
+           (unsigned long)accepted, (unsigned long)rejected,
+           (unsigned long)rejectedBytes, (unsigned long)wireLen);
+    CHECK(wireLen == expectedLen);
+    CHECK(memcmp(wire, expected, expectedLen) == 0);
+    CHECK(txQueue.overflows == (uint16_t)rejected);
+    CHECK(txQueue.droppedBytes == (uint16_t)rejectedBytes);
+    CHECK(rejected > 0 && accepted > 0);
+}
+
+int main(void)
+{
+    testBasics();
+    fuzz();
+    return check_done("test_uart_txq");
+}